@@ -155,6 +155,7 @@ struct BackendConfig {
   bool use_zmq_interface = false;
   size_t zmq_num_threads = 2;
   size_t zmq_poll_time_ms = 10;
+  double room_label_min_overlap = 0.5;
 };
 
 struct EnableMapConverter {
@@ -218,6 +219,7 @@ void visit_config(const Visitor& v, BackendConfig& config) {
   dsg_handle.visit("use_zmq_interface", config.use_zmq_interface);
   dsg_handle.visit("zmq_num_threads", config.zmq_num_threads);
   dsg_handle.visit("zmq_poll_time_ms", config.zmq_poll_time_ms);
+  dsg_handle.visit("room_label_min_overlap", config.room_label_min_overlap);
 }
 
 template <typename Visitor>
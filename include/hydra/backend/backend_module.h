@@ -43,6 +43,7 @@
 
 #include "hydra/backend/backend_config.h"
 #include "hydra/backend/merge_handler.h"
+#include "hydra/backend/room_label_store.h"
 #include "hydra/backend/update_functions.h"
 #include "hydra/common/common.h"
 #include "hydra/common/robot_prefix_config.h"
@@ -194,7 +195,7 @@ class BackendModule : public kimera_pgmo::KimeraPgmoInterface {
 
   std::list<OutputCallback> output_callbacks_;
 
-  std::map<NodeId, std::string> room_name_map_;
+  std::shared_ptr<RoomLabelStore> room_labels_;
   std::unique_ptr<std::thread> zmq_thread_;
   std::unique_ptr<spark_dsg::ZmqReceiver> zmq_receiver_;
 };
@@ -0,0 +1,108 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "hydra/common/common.h"
+
+namespace hydra {
+
+/**
+ * @brief Persistent room names keyed by the places each room covered
+ *
+ * Labels are submitted asynchronously (e.g. by the ZMQ receiver) and are applied to
+ * the graph only when new labels arrive or when rooms are re-detected. Because rooms
+ * are rewritten from scratch by room detection, labels are matched to rooms by the
+ * fraction of the labeled footprint (the set of child places) covered by each room
+ * instead of by room id.
+ */
+class RoomLabelStore {
+ public:
+  struct Label {
+    std::string name;
+    std::set<NodeId> footprint;
+  };
+
+  explicit RoomLabelStore(double min_overlap = 0.5);
+
+  /**
+   * @brief Queue a label for a room (thread-safe)
+   *
+   * If the footprint is empty, it is resolved from the children of the room in the
+   * graph passed to the next call to apply.
+   */
+  void submit(NodeId room, const std::string& name, const std::set<NodeId>& footprint);
+
+  /**
+   * @brief Queue labels for every named room in a received graph (thread-safe)
+   */
+  size_t submit(const DynamicSceneGraph& update_graph);
+
+  bool hasPending() const;
+
+  /**
+   * @brief Assign stored labels to the current rooms of the graph
+   *
+   * Caller is responsible for holding any lock on the graph.
+   * @returns number of rooms that were labeled
+   */
+  size_t apply(DynamicSceneGraph& graph);
+
+  std::vector<Label> labels() const;
+
+  size_t numLabels() const;
+
+ private:
+  struct PendingLabel {
+    NodeId room;
+    Label label;
+  };
+
+  void insertLabel(Label&& label);
+
+  const double min_overlap_;
+  std::atomic<bool> has_pending_{false};
+  mutable std::mutex pending_mutex_;
+  std::list<PendingLabel> pending_;
+  mutable std::mutex labels_mutex_;
+  std::vector<Label> labels_;
+};
+
+}  // namespace hydra
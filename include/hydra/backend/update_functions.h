@@ -41,6 +41,7 @@
 namespace hydra {
 
 class RoomFinder;
+class RoomLabelStore;
 struct RoomFinderConfig;
 
 struct UpdateInfo {
@@ -122,6 +123,8 @@ struct UpdateRoomsFunctor {
   void rewriteRooms(const SceneGraphLayer* new_rooms, DynamicSceneGraph& graph) const;
 
   std::unique_ptr<RoomFinder> room_finder;
+  //! optional labels to reapply whenever rooms are rewritten
+  std::shared_ptr<RoomLabelStore> room_labels;
 };
 
 struct UpdateBuildingsFunctor {
@@ -0,0 +1,96 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "hydra/common/dsg_types.h"
+
+namespace hydra {
+
+/**
+ * @brief Batch of graph edits staged outside of the graph lock
+ *
+ * Modules fill a change set while only reading the graph (or their own data) and then
+ * apply it in a single short critical section. Changes are applied in a fixed order:
+ * node removals, edge removals, node upserts, edge upserts, edge inserts and then
+ * attribute patches.
+ */
+struct DsgChangeSet {
+  using AttributePatch = std::function<void(NodeAttributes&)>;
+  using RemovalCallback = std::function<void(const SceneGraphNode&)>;
+
+  struct NodeUpsert {
+    LayerId layer;
+    NodeId node;
+    NodeAttributes::Ptr attrs;
+  };
+
+  struct EdgeUpsert {
+    NodeId source;
+    NodeId target;
+    EdgeAttributes::Ptr info;
+  };
+
+  //! Whether or not the change set has no changes
+  bool empty() const;
+
+  //! Total number of staged changes
+  size_t size() const;
+
+  void clear();
+
+  /**
+   * @brief Apply all staged changes to the graph
+   *
+   * Caller is responsible for holding the graph lock. Changes that refer to nodes that
+   * no longer exist are skipped.
+   * @param graph Graph to modify
+   * @param on_removal Optional callback invoked for each node before it is removed
+   * @returns Number of changes that were applied
+   */
+  size_t apply(DynamicSceneGraph& graph, const RemovalCallback& on_removal = {});
+
+  std::vector<NodeId> node_removals;
+  std::vector<std::pair<NodeId, NodeId>> edge_removals;
+  std::vector<NodeUpsert> node_upserts;
+  std::vector<EdgeUpsert> edge_upserts;
+  //! edges with default attributes (ignored if already present)
+  std::vector<std::pair<NodeId, NodeId>> edge_inserts;
+  std::vector<std::pair<NodeId, AttributePatch>> patches;
+};
+
+}  // namespace hydra
@@ -57,6 +57,7 @@ struct LcdInput {
 
   uint64_t timestamp_ns;
   NodeIdSet archived_places;
+  NodeIdSet archived_objects;
   std::vector<NodeId> new_agent_nodes;
 };
 
@@ -80,6 +80,8 @@ struct FrontendConfig {
   bool prune_mesh_indices = false;
   std::string semantic_label_file;
   bool lcd_use_bow_vectors = true;
+  //! Unmatched bow vectors older than this are dropped (0 keeps them forever)
+  double bow_expiry_s = 30.0;
   kimera_pgmo::MeshFrontendConfig pgmo_config;
   MeshSegmenterConfig object_config;
   bool validate_vertices = true;
@@ -137,6 +139,7 @@ void visit_config(const Visitor& v, FrontendConfig& config) {
   v.visit("prune_mesh_indices", config.prune_mesh_indices);
   v.visit("semantic_label_file", config.semantic_label_file);
   v.visit("lcd_use_bow_vectors", config.lcd_use_bow_vectors);
+  v.visit("bow_expiry_s", config.bow_expiry_s);
   v.visit("pgmo", config.pgmo_config);
   v.visit("objects", config.object_config);
   v.visit("angle_step", config.object_config.angle_step);
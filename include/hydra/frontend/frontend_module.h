@@ -37,16 +37,20 @@
 #include <kimera_pgmo/compression/DeltaCompression.h>
 #include <spark_dsg/scene_graph_logger.h>
 
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include "hydra/common/common.h"
+#include "hydra/common/dsg_change_set.h"
 #include "hydra/common/input_queue.h"
 #include "hydra/common/robot_prefix_config.h"
 #include "hydra/common/shared_module_state.h"
 #include "hydra/frontend/frontend_config.h"
 #include "hydra/frontend/mesh_segmenter.h"
+#include "hydra/frontend/place_connectivity.h"
 #include "hydra/reconstruction/reconstruction_output.h"
 #include "hydra/utils/nearest_neighbor_utilities.h"
 
@@ -95,23 +99,28 @@ class FrontendModule {
   void updatePoseGraph(const ReconstructionOutput& input);
 
  protected:
-  void filterPlaces(const SceneGraphLayer& places,
-                    NodeIdSet& objects_to_check,
-                    NodeIdSet& active_places,
-                    const NodeIdSet& active_neighborhood);
+  void updatePlaceConnectivity(const DsgChangeSet& changes);
 
-  void deletePlaceNode(NodeId node_id, NodeIdSet& objects_to_check);
+  void filterPlaces(NodeIdSet& active_places, DsgChangeSet& changes);
 
-  void archivePlaces(const NodeIdSet active_places);
+  void handlePlaceRemoval(const SceneGraphNode& node, NodeIdSet& objects_to_check);
 
-  void invalidateMeshEdges(const kimera_pgmo::MeshDelta& delta);
+  void archivePlaces(const NodeIdSet active_places, uint64_t timestamp_ns);
+
+  void invalidateMeshEdges(const kimera_pgmo::MeshDelta& delta, uint64_t timestamp_ns);
 
   void addPlaceObjectEdges(uint64_t timestamp_ns,
                            NodeIdSet* extra_objects_to_check = nullptr);
 
   void addPlaceAgentEdges(uint64_t timestamp_ns);
 
-  void assignBowVectors(const DynamicLayer& agents);
+  void queueBowVectors(uint64_t timestamp_ns);
+
+  bool assignBowVector(const DynamicLayer& agents, NodeId pgmo_key);
+
+  void assignBowVectors(const DynamicLayer& agents,
+                        const std::vector<NodeId>& new_agent_keys,
+                        uint64_t timestamp_ns);
 
   void updatePlaceMeshMapping(const ReconstructionOutput& input);
 
@@ -138,12 +147,25 @@ class FrontendModule {
   SceneGraphLogger frontend_graph_logger_;
 
   std::unique_ptr<NearestNodeFinder> places_nn_finder_;
+  PlaceConnectivity place_connectivity_;
   NodeIdSet unlabeled_place_nodes_;
   NodeIdSet previous_active_places_;
-  std::map<NodeId, size_t> agent_key_map_;
+  std::unordered_map<NodeId, size_t> agent_key_map_;
   std::set<NodeId> deleted_agent_edge_indices_;
   std::map<LayerPrefix, size_t> last_agent_edge_index_;
-  std::list<pose_graph_tools::BowQuery::ConstPtr> cached_bow_messages_;
+
+  struct PendingBowVector {
+    uint64_t received_ns;
+    AgentNodeAttributes::BowIdVector ids;
+    Eigen::VectorXf values;
+  };
+
+  //! Bow vectors waiting for their agent node, keyed by pgmo key
+  std::unordered_map<NodeId, PendingBowVector> pending_bow_vectors_;
+  //! Pending keys in the order they were received (used for expiry)
+  std::deque<std::pair<NodeId, uint64_t>> bow_expiry_queue_;
+  //! Keys received since the last assignment
+  std::vector<NodeId> received_bow_keys_;
 
   std::vector<InputCallback> input_callbacks_;
   std::vector<OutputCallback> output_callbacks_;
@@ -39,6 +39,8 @@
 #include <pcl/point_types.h>
 
 #include <memory>
+#include <queue>
+#include <unordered_map>
 
 #include "hydra/common/dsg_types.h"
 
@@ -87,7 +89,8 @@ class MeshSegmenter {
     return objects_to_check_for_places_;
   }
 
-  void pruneObjectsToCheckForPlaces(const DynamicSceneGraph& graph);
+  //! stop checking objects that were assigned a place (or no longer exist)
+  void pruneObjectsToCheckForPlaces(const std::vector<NodeId>& resolved);
 
   std::optional<uint8_t> getVertexLabel(const kimera::SemanticLabel2Color& label_map,
                                         size_t index) const;
@@ -125,8 +128,19 @@ class MeshSegmenter {
   MeshSegmenterConfig config_;
   NodeSymbol next_node_id_;
 
+  struct ActiveObject {
+    uint8_t label;
+    uint64_t last_seen_ns;
+  };
+
+  using ExpiryEntry = std::pair<uint64_t, NodeId>;
+  using ExpiryQueue =
+      std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, std::greater<>>;
+
   std::map<uint8_t, std::set<NodeId>> active_objects_;
-  std::map<NodeId, uint64_t> active_object_timestamps_;
+  std::unordered_map<NodeId, ActiveObject> active_object_info_;
+  //! one entry per active object, keyed by the last-seen time when it was queued
+  ExpiryQueue expiry_queue_;
   std::unordered_set<NodeId> objects_to_check_for_places_;
   std::vector<CallbackFunc> callback_funcs_;
 };
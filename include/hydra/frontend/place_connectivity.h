@@ -0,0 +1,92 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "hydra/common/dsg_types.h"
+
+namespace hydra {
+
+/**
+ * @brief Incrementally tracked connectivity of the places layer
+ *
+ * Mirrors the nodes and edges of the places layer and logs every node whose
+ * component may have shrunk (new nodes and endpoints of removed edges or nodes).
+ * Inserting an edge can only grow a component, so small components can only appear
+ * next to logged nodes. Searches start from those nodes and stop as soon as a
+ * component reaches the minimum size, so filtering touches only the parts of the
+ * graph affected by the latest changes.
+ */
+class PlaceConnectivity {
+ public:
+  PlaceConnectivity();
+
+  //! add a node (no-op if the node already exists)
+  bool addNode(NodeId node);
+
+  bool removeNode(NodeId node);
+
+  //! add an edge between two existing nodes
+  bool addEdge(NodeId source, NodeId target);
+
+  bool removeEdge(NodeId source, NodeId target);
+
+  bool hasNode(NodeId node) const;
+
+  bool hasEdge(NodeId source, NodeId target) const;
+
+  inline size_t numNodes() const { return adjacency_.size(); }
+
+  inline size_t numEdges() const { return num_edges_; }
+
+  inline size_t numChanged() const { return changed_.size(); }
+
+  /**
+   * @brief Find components with fewer than min_size nodes that contain a logged node
+   * @param min_size Minimum number of nodes in a component
+   * @returns Small components (each sorted by node id). Clears the change log.
+   */
+  std::vector<std::vector<NodeId>> popSmallComponents(size_t min_size);
+
+ private:
+  std::unordered_map<NodeId, std::unordered_set<NodeId>> adjacency_;
+  std::set<NodeId> changed_;
+  size_t num_edges_;
+};
+
+}  // namespace hydra
@@ -37,6 +37,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "hydra/gnn/tensor.h"
 
@@ -48,12 +49,63 @@ using DynamicIndexMap = std::map<std::string, std::vector<size_t>>;
 
 struct GnnInterfaceImpl;
 
+struct SessionConfig {
+  //! Threads for the per-session intra-op pool (unused with global thread pools)
+  int intra_op_threads = 1;
+  //! Threads for the per-session inter-op pool (unused with global thread pools)
+  int inter_op_threads = 1;
+  //! Graph optimization level (0: disabled, 1: basic, 2: extended, 99: all)
+  int optimization_level = 99;
+  //! Save the optimized model to disk and load it instead of re-optimizing
+  bool cache_optimized_model = false;
+  //! Directory for optimized models (defaults to the directory of the model)
+  std::string optimized_model_dir = "";
+};
+
+struct RuntimeConfig {
+  //! Share one set of thread pools between all sessions in the process
+  bool use_global_thread_pools = false;
+  //! Threads for the global intra-op pool
+  int global_intra_op_threads = 1;
+  //! Threads for the global inter-op pool
+  int global_inter_op_threads = 1;
+};
+
+/**
+ * \brief Configure the process-wide ONNX runtime environment
+ *
+ * Has to be called before the first model is loaded, as the environment (and any
+ * global thread pools) can only be created once per process.
+ *
+ * \param[in] config Runtime configuration
+ * \returns Whether or not the configuration was applied
+ */
+bool configureRuntime(const RuntimeConfig& config);
+
+/**
+ * \brief Get the path of the optimized model that a session would use
+ */
+std::string getOptimizedModelPath(const std::string& model_path,
+                                  const SessionConfig& config);
+
+/**
+ * \brief Get the number of sessions currently held by the session cache
+ */
+size_t numCachedSessions();
+
+/**
+ * \brief Drop all cached sessions that are not in use by a model
+ */
+void clearSessionCache();
+
 class GnnInterface {
  public:
   // TODO(nathan) add actual config
   explicit GnnInterface(const std::string& model_path);
 
-  GnnInterface(const std::string& model_path, const DynamicIndexMap& output_map);
+  GnnInterface(const std::string& model_path,
+               const DynamicIndexMap& output_map,
+               const SessionConfig& config = {});
 
   ~GnnInterface();
 
@@ -87,6 +139,37 @@ class GnnInterface {
   TensorMap operator()(const TensorMap& input,
                        const std::vector<int64_t>& output_sizes) const;
 
+  /**
+   * \brief Run inference, writing a single float output into caller memory
+   *
+   * Inputs and outputs are bound in place through ONNX IO binding, so no tensors
+   * are allocated per call. Other outputs of the model go to scratch buffers that
+   * are reused (and only grown) across calls. Safe to call from multiple threads:
+   * each concurrent call gets its own binding and buffers and only the session is
+   * shared.
+   *
+   * \param[in] input Map between input name and Tensor value
+   * \param[in] output_name Output to write
+   * \param[out] output Destination (row-major), has to match the output size
+   * \param[in] output_size Number of elements available in output
+   * \param[in] output_sizes Output sizes for dynamic output axes
+   */
+  void operator()(const TensorMap& input,
+                  const std::string& output_name,
+                  float* output,
+                  size_t output_size,
+                  const std::vector<int64_t>& output_sizes = {}) const;
+
+  /**
+   * \brief Run inference, writing a single float output into a vector
+   *
+   * Same as above, but resizes the vector to the size of the output first.
+   */
+  void operator()(const TensorMap& input,
+                  const std::string& output_name,
+                  Eigen::VectorXf& output,
+                  const std::vector<int64_t>& output_sizes = {}) const;
+
  protected:
   std::unique_ptr<GnnInterfaceImpl> impl_;
 
@@ -0,0 +1,95 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <onnxruntime_cxx_api.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "hydra/gnn/gnn_interface.h"
+
+namespace hydra {
+namespace gnn {
+
+/**
+ * \brief Process-wide ONNX runtime context
+ *
+ * Owns the single Ort::Env for the process (optionally with global thread pools)
+ * and caches sessions by model path and session options. Ort::Session::Run is
+ * thread-safe, so cached sessions can be shared between interfaces.
+ */
+class OrtRuntime {
+ public:
+  using SessionPtr = std::shared_ptr<Ort::Session>;
+
+  static OrtRuntime& instance();
+
+  ~OrtRuntime();
+
+  bool configure(const RuntimeConfig& config);
+
+  Ort::Env& env();
+
+  OrtAllocator* allocator();
+
+  SessionPtr getSession(const std::string& model_path, const SessionConfig& config);
+
+  size_t numSessions() const;
+
+  void clear();
+
+  static std::string getSessionKey(const std::string& model_path,
+                                   const SessionConfig& config);
+
+ private:
+  OrtRuntime();
+
+  Ort::Env& getEnvLocked();
+
+  Ort::SessionOptions makeOptions(const SessionConfig& config) const;
+
+  SessionPtr makeSession(const std::string& model_path, const SessionConfig& config);
+
+  mutable std::mutex mutex_;
+  RuntimeConfig config_;
+  std::unique_ptr<Ort::Env> env_;
+  Ort::AllocatorWithDefaultOptions allocator_;
+  std::map<std::string, SessionPtr> sessions_;
+};
+
+}  // namespace gnn
+}  // namespace hydra
@@ -59,8 +59,17 @@ struct FieldInfo {
                           const Tensor& input,
                           bool validate = true) const;
 
+  Tensor::Type getTensorType() const;
+
   Tensor getTensor() const;
 
+  /**
+   * \brief Resolve the shape of the field, reusing the storage of shape
+   */
+  void getShape(const std::vector<size_t>& dims_to_read,
+                const std::vector<int64_t>& output_dims,
+                std::vector<int64_t>& shape) const;
+
   Tensor getDynamicTensor(const std::vector<size_t>& dims_to_read,
                           const std::vector<int64_t>& output_dims) const;
 };
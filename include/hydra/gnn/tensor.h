@@ -101,6 +101,17 @@ class Tensor {
 
   int64_t cols() const;
 
+  /**
+   * \brief Change the shape of the tensor, keeping the underlying allocation
+   *
+   * Memory is only reallocated when the new size exceeds the largest size seen so
+   * far (or when the memory is shared with another tensor). Contents are unspecified
+   * after resizing.
+   */
+  void resize(const std::vector<int64_t>& dims);
+
+  void resize(int64_t rows, int64_t cols);
+
   template <typename T>
   const T* data(bool validate = true) const {
     if (validate && !matchesType<T>(type_)) {
@@ -0,0 +1,92 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <vector>
+
+namespace hydra {
+namespace lcd {
+
+/**
+ * @brief Compact bag-of-words vector
+ *
+ * Word ids are sorted and stored as varint-encoded differences, and weights are
+ * quantized to 8 bits relative to the largest weight. Weights are assumed to be
+ * non-negative (negative weights are clamped to zero) and entries that quantize to
+ * zero are dropped. Normalized scores only depend on the quantized weights, so they
+ * can be computed with integer arithmetic.
+ */
+struct CompressedBow {
+  using WordVector = Eigen::Matrix<uint32_t, Eigen::Dynamic, 1>;
+
+  CompressedBow() = default;
+
+  CompressedBow(const WordVector& words, const Eigen::VectorXf& values);
+
+  inline size_t size() const { return weights.size(); }
+
+  inline bool empty() const { return weights.empty(); }
+
+  //! Approximate heap usage in bytes
+  inline size_t memoryUsage() const { return word_deltas.size() + weights.size(); }
+
+  //! Recover the (dequantized) bag-of-words vector
+  void decode(WordVector& words, Eigen::VectorXf& values) const;
+
+  std::vector<uint8_t> word_deltas;
+  std::vector<uint8_t> weights;
+  //! Weight that a quantized value of 1 represents
+  float scale = 0.0f;
+  //! Sum of quantized weights
+  uint32_t weight_sum = 0;
+  //! Sum of squared quantized weights
+  uint64_t weight_squared_sum = 0;
+};
+
+/**
+ * @brief L1 score (in [0, 1]) between the L1-normalized vectors
+ *
+ * Matches computeDescriptorScore with DescriptorScoreType::L1, i.e.,
+ * 1 - 0.5 * |lhs - rhs|_1 = sum_i min(lhs_i, rhs_i).
+ */
+float computeCompressedBowL1Score(const CompressedBow& lhs, const CompressedBow& rhs);
+
+//! Cosine similarity between the two vectors (in [0, 1] for non-negative weights)
+float computeCompressedBowCosine(const CompressedBow& lhs, const CompressedBow& rhs);
+
+}  // namespace lcd
+}  // namespace hydra
@@ -0,0 +1,83 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <map>
+#include <vector>
+
+#include "hydra/loop_closure/descriptor_matching.h"
+
+namespace hydra {
+namespace lcd {
+
+enum class DescriptorEvictionPolicy { AGE, LEAST_MATCHED };
+
+struct DescriptorEvictionConfig {
+  //! Maximum number of descriptors kept per layer (layers not listed are unbounded)
+  std::map<LayerId, size_t> capacity;
+  //! Evict descriptors that are close to and similar to a retained descriptor first
+  bool prune_redundant = true;
+  //! Radius to look for redundant descriptors in
+  double redundancy_radius_m = 2.0;
+  //! Minimum descriptor score for two nearby descriptors to count as redundant
+  float redundancy_min_score = 0.9f;
+  //! Order in which the remaining descriptors are evicted
+  DescriptorEvictionPolicy policy = DescriptorEvictionPolicy::AGE;
+};
+
+/**
+ * \brief Pick the descriptors to remove to bring a cache back down to capacity
+ *
+ * Descriptors without a value are removed first. If enabled, descriptors whose root
+ * is within the redundancy radius of a retained descriptor with a score above the
+ * redundancy threshold are removed next (oldest first), which keeps coverage of the
+ * map. Any remaining evictions follow the configured policy: oldest first, or least
+ * matched first (ties broken by age).
+ *
+ * \param[in] cache Descriptors for a single layer
+ * \param[in] capacity Maximum number of descriptors to keep
+ * \param[in] config Eviction configuration
+ * \param[in] score_type Score to use when comparing descriptors
+ * \param[in] match_counts Number of times each root was returned as a match
+ * \returns Roots of the descriptors to evict (in eviction order)
+ */
+std::vector<NodeId> selectDescriptorsToEvict(
+    const DescriptorCache& cache,
+    size_t capacity,
+    const DescriptorEvictionConfig& config,
+    DescriptorScoreType score_type,
+    const std::map<NodeId, size_t>& match_counts = {});
+
+}  // namespace lcd
+}  // namespace hydra
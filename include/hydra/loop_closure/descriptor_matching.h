@@ -48,8 +48,32 @@ struct DescriptorMatchConfig {
   double min_score_ratio = 0.7;
   double min_match_separation_m = 5.0;
   DescriptorScoreType type = DescriptorScoreType::L1;
+  //! Number of bits in the binary sketch used to prune candidates (0 disables)
+  size_t sketch_bits = 0;
+  //! Maximum fraction of differing sketch bits for a candidate to be scored
+  double max_sketch_distance = 1.0;
+  //! Maximum number of sketched candidates to score after sketch pruning (0 is
+  //! unbounded). Candidates without a sketch are always scored.
+  size_t max_sketch_candidates = 0;
+  //! Minimum coarsest-scale score of multi-scale candidates (0 disables)
+  float min_coarse_score = 0.0f;
 };
 
+struct SearchStageStats {
+  size_t num_candidates = 0;
+  size_t num_filtered = 0;
+  size_t num_sketch_rejected = 0;
+  size_t num_sketch_capped = 0;
+  size_t num_coarse_rejected = 0;
+  size_t num_scored = 0;
+  size_t num_valid = 0;
+  size_t num_registration = 0;
+
+  SearchStageStats& operator+=(const SearchStageStats& other);
+};
+
+std::ostream& operator<<(std::ostream& out, const SearchStageStats& stats);
+
 struct LayerSearchResults {
   std::vector<float> score;
   std::set<NodeId> valid_matches;
@@ -57,6 +81,7 @@ struct LayerSearchResults {
   std::vector<std::set<NodeId>> match_nodes;
   NodeId query_root;
   std::vector<NodeId> match_root;
+  SearchStageStats stats;
 };
 
 using DescriptorCache = std::map<NodeId, Descriptor::Ptr>;
@@ -103,10 +128,38 @@ inline float computeL1Distance(const Descriptor& lhs, const Descriptor& rhs) {
   return 2.0f + l1_diff;
 }
 
+/**
+ * \brief Score two descriptors (in [0, 1])
+ *
+ * Multi-scale descriptors are scored as the mean of the per-scale scores.
+ */
 float computeDescriptorScore(const Descriptor& lhs,
                              const Descriptor& rhs,
                              DescriptorScoreType type);
 
+/**
+ * \brief Score only the coarsest scale of two multi-scale descriptors
+ *
+ * Falls back to computeDescriptorScore for descriptors with a single scale.
+ */
+float computeCoarseDescriptorScore(const Descriptor& lhs,
+                                   const Descriptor& rhs,
+                                   DescriptorScoreType type);
+
+/**
+ * \brief Compute a binary sketch of the descriptor values
+ *
+ * Uses signs of random projections of the centered values, so the fraction of
+ * differing bits between two sketches approximates the angle between descriptors.
+ * Bag-of-words and null descriptors get no sketch.
+ */
+void computeDescriptorSketch(Descriptor& descriptor, size_t num_bits);
+
+/**
+ * \brief Number of differing bits between two sketches of the same size
+ */
+size_t computeSketchDistance(const Descriptor& lhs, const Descriptor& rhs);
+
 LayerSearchResults searchDescriptors(
     const Descriptor& descriptor,
     const DescriptorMatchConfig& match_config,
@@ -0,0 +1,125 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <deque>
+#include <map>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "hydra/common/dsg_types.h"
+
+namespace hydra {
+namespace lcd {
+
+struct DescriptorRefreshConfig {
+  //! Maximum number of roots to refresh per update (0 disables refreshing)
+  size_t max_refreshes_per_update = 0;
+  //! Roots within this distance of a changed node are marked as stale
+  double radius_m = 5.0;
+  //! Minimum time between two refreshes of the same root
+  double min_refresh_period_s = 5.0;
+};
+
+/**
+ * \brief Tracks which descriptor roots have a changed neighborhood
+ *
+ * Roots are bucketed in a grid with cells the size of the refresh radius, so marking a
+ * change only looks at the roots in the surrounding cells. Stale roots are handed
+ * back in the order they were marked, limited to the configured number per update,
+ * and a root is not handed back again until the minimum refresh period has passed.
+ */
+class DescriptorRefreshTracker {
+ public:
+  explicit DescriptorRefreshTracker(const DescriptorRefreshConfig& config);
+
+  //! Whether refreshing is enabled (roots are not tracked otherwise)
+  bool enabled() const;
+
+  /**
+   * \brief Start (or update the position of) a tracked root
+   * \param[in] root Root of the cached descriptors
+   * \param[in] position Position of the root (used for change lookups)
+   */
+  void addRoot(NodeId root, const Eigen::Vector3d& position);
+
+  void removeRoot(NodeId root);
+
+  /**
+   * \brief Mark every tracked root near a changed node as stale
+   * \param[in] position Position of the changed node
+   * \returns Number of roots that became stale
+   */
+  size_t markChanged(const Eigen::Vector3d& position);
+
+  /**
+   * \brief Pop the stale roots that are due for a refresh
+   * \param[in] timestamp_ns Current time (used to enforce the refresh period)
+   * \returns Roots to refresh (at most the configured number per update)
+   */
+  std::vector<NodeId> popStaleRoots(uint64_t timestamp_ns);
+
+  bool isStale(NodeId root) const;
+
+  size_t numStale() const;
+
+  size_t numRoots() const;
+
+  const DescriptorRefreshConfig config;
+
+ private:
+  using CellIndex = std::tuple<int64_t, int64_t, int64_t>;
+
+  struct RootInfo {
+    Eigen::Vector3d position;
+    CellIndex cell;
+    bool stale = false;
+    bool refreshed = false;
+    uint64_t last_refresh_ns = 0;
+  };
+
+  CellIndex getIndex(const Eigen::Vector3d& pos) const;
+
+  void eraseFromCell(NodeId root, const CellIndex& cell);
+
+  std::unordered_map<NodeId, RootInfo> roots_;
+  std::map<CellIndex, std::set<NodeId>> cells_;
+  std::deque<NodeId> stale_queue_;
+  size_t num_stale_;
+};
+
+}  // namespace lcd
+}  // namespace hydra
@@ -33,7 +33,9 @@
  * purposes notwithstanding any copyright notation herein.
  * -------------------------------------------------------------------------- */
 #pragma once
+#include "hydra/loop_closure/descriptor_eviction.h"
 #include "hydra/loop_closure/descriptor_matching.h"
+#include "hydra/loop_closure/descriptor_refresh.h"
 #include "hydra/loop_closure/registration.h"
 #include "hydra/loop_closure/scene_graph_descriptors.h"
 
@@ -49,6 +51,16 @@ struct GnnLcdConfig {
   std::string places_model_path;
   bool places_pos_in_feature = false;
   bool objects_pos_in_feature = false;
+  int num_intra_op_threads = 1;
+  int num_inter_op_threads = 1;
+  bool use_global_thread_pools = false;
+  int optimization_level = 99;
+  bool cache_optimized_models = false;
+  std::string optimized_model_dir = "";
+  bool use_quantized_models = false;
+  std::string quantized_object_model_path = "";
+  std::string quantized_places_model_path = "";
+  std::string input_log_dir = "";
 };
 
 struct LcdDetectorConfig {
@@ -64,8 +76,17 @@ struct LcdDetectorConfig {
 
   size_t num_semantic_classes = 20;
   HistogramConfig<double> place_histogram_config{0.5, 2.5, 30};
+  //! Finer radii for multi-scale object and place descriptors below the extraction
+  //! radius (empty uses one scale)
+  std::vector<double> descriptor_scales_m;
   bool use_gnn_descriptors = false;
   GnnLcdConfig gnn_lcd;
+  DescriptorEvictionConfig descriptor_cache;
+  DescriptorRefreshConfig descriptor_refresh;
+  //! Threads for constructing new descriptors (0 uses all available cores)
+  size_t num_descriptor_threads = 1;
+  //! Store agent bag-of-words descriptors in compressed form
+  bool compress_agent_bow = false;
 };
 
 class LcdDetector {
@@ -94,19 +115,49 @@ class LcdDetector {
 
   const std::map<size_t, LayerSearchResults>& getLatestMatches() const;
 
+  const std::map<size_t, SearchStageStats>& getSearchStats() const;
+
   const std::map<LayerId, size_t>& getLayerRemapping() const;
 
   const DescriptorCache& getDescriptorCache(LayerId layer);
 
   void dumpDescriptors(const std::string& log_path) const;
 
+  //! Drop subgraphs extracted during the previous cycle (call when the graph changes)
+  void resetSubgraphCache();
+
+  const SubgraphCache& getSubgraphCache() const;
+
+  /**
+   * \brief Mark the cached descriptors around changed nodes as stale
+   * \param[in] dsg Scene graph containing the changed nodes
+   * \param[in] nodes Objects and places that were added or changed
+   * \returns Number of roots that became stale
+   */
+  size_t markChangedNodes(const DynamicSceneGraph& dsg,
+                          const std::unordered_set<NodeId>& nodes);
+
+  /**
+   * \brief Recompute a budgeted number of stale descriptors in place
+   * \param[in] dsg Scene graph to construct the descriptors from
+   * \param[in] timestamp Current time (used to rate-limit refreshes)
+   * \returns Number of roots that were refreshed
+   */
+  size_t refreshDescriptors(const DynamicSceneGraph& dsg, uint64_t timestamp = 0);
+
+  const DescriptorRefreshTracker& getRefreshTracker() const;
+
  protected:
   void makeDefaultDescriptorFactories();
 
   void resetLayerAssignments();
 
-  bool addNewDescriptors(const DynamicSceneGraph& graph,
-                         const DynamicSceneGraphNode& agent_node);
+  void addNewDescriptors(const DynamicSceneGraph& graph,
+                         const std::set<NodeId>& agent_nodes);
+
+  size_t evictDescriptors();
+
+  void removeDescriptor(LayerId layer, NodeId root);
 
   std::vector<DsgRegistrationSolution> registerAndVerify(
       const DynamicSceneGraph& dsg,
@@ -115,6 +166,8 @@ class LcdDetector {
       uint64_t timestamp = 0) const;
 
   LcdDetectorConfig config_;
+  SubgraphCache::Ptr subgraph_cache_;
+  DescriptorRefreshTracker refresh_tracker_;
   DescriptorFactory::Ptr agent_factory_;
   FactoryMap layer_factories_;
 
@@ -130,8 +183,10 @@ class LcdDetector {
   std::map<LayerId, DescriptorCache> cache_map_;
   std::map<NodeId, DescriptorCache> leaf_cache_;
   std::map<NodeId, std::set<NodeId>> root_leaf_map_;
+  std::map<LayerId, std::map<NodeId, size_t>> match_counts_;
 
   std::map<size_t, LayerSearchResults> matches_;
+  std::map<size_t, SearchStageStats> search_stats_;
 };
 
 }  // namespace lcd
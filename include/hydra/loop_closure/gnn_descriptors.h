@@ -33,8 +33,11 @@
  * purposes notwithstanding any copyright notation herein.
  * -------------------------------------------------------------------------- */
 #pragma once
+#include <mutex>
+
 #include "hydra/gnn/gnn_interface.h"
 #include "hydra/loop_closure/scene_graph_descriptors.h"
+#include "hydra/utils/resource_pool.h"
 
 namespace hydra {
 namespace lcd {
@@ -46,14 +49,25 @@ struct ObjectGnnDescriptor : DescriptorFactory {
                       const SubgraphConfig& config,
                       double max_edge_distance_m,
                       const LabelEmbeddings& label_embeddings,
-                      bool use_pos_in_feature = true);
+                      bool use_pos_in_feature = true,
+                      const gnn::SessionConfig& session_config = {});
 
   gnn::TensorMap makeInput(const DynamicSceneGraph& graph,
                            const std::set<NodeId>& nodes) const;
 
+  void makeInput(const DynamicSceneGraph& graph,
+                 const std::set<NodeId>& nodes,
+                 gnn::TensorMap& input) const;
+
   Descriptor::Ptr construct(const DynamicSceneGraph& graph,
                             const DynamicSceneGraphNode& agent_node) const override;
 
+  /**
+   * \brief Save the input of every subgraph to the directory (e.g., as a corpus for
+   * validating quantized models with gnn_model_reader)
+   */
+  void logInputs(const std::string& directory);
+
  protected:
   const SubgraphConfig config_;
   std::unique_ptr<gnn::GnnInterface> model_;
@@ -62,23 +76,46 @@ struct ObjectGnnDescriptor : DescriptorFactory {
   size_t label_embedding_size_;
   std::map<uint8_t, Eigen::VectorXf> label_embeddings_;
   const bool use_pos_in_feature_;
+
+  //! input buffers for each concurrent call (only inference shares the session)
+  mutable ResourcePool<gnn::TensorMap> input_buffers_;
+  std::string input_log_dir_;
+  mutable std::mutex log_mutex_;
+  mutable size_t num_logged_inputs_ = 0;
 };
 
 struct PlaceGnnDescriptor : DescriptorFactory {
   PlaceGnnDescriptor(const std::string& model_path,
                      const SubgraphConfig& config,
-                     bool use_pos_in_feature = true);
+                     bool use_pos_in_feature = true,
+                     const gnn::SessionConfig& session_config = {});
 
   gnn::TensorMap makeInput(const DynamicSceneGraph& graph,
                            const std::set<NodeId>& nodes) const;
 
+  void makeInput(const DynamicSceneGraph& graph,
+                 const std::set<NodeId>& nodes,
+                 gnn::TensorMap& input) const;
+
   Descriptor::Ptr construct(const DynamicSceneGraph& graph,
                             const DynamicSceneGraphNode& agent_node) const override;
 
+  /**
+   * \brief Save the input of every subgraph to the directory (e.g., as a corpus for
+   * validating quantized models with gnn_model_reader)
+   */
+  void logInputs(const std::string& directory);
+
  protected:
   const SubgraphConfig config_;
   const bool use_pos_in_feature_;
   std::unique_ptr<gnn::GnnInterface> model_;
+
+  //! input buffers for each concurrent call (only inference shares the session)
+  mutable ResourcePool<gnn::TensorMap> input_buffers_;
+  std::string input_log_dir_;
+  mutable std::mutex log_mutex_;
+  mutable size_t num_logged_inputs_ = 0;
 };
 
 ObjectGnnDescriptor::LabelEmbeddings loadLabelEmbeddings(const std::string& filename);
@@ -48,6 +48,11 @@ DECLARE_CONFIG_ENUM(hydra::lcd,
                     {DescriptorScoreType::COSINE, "COSINE"},
                     {DescriptorScoreType::L1, "L1"})
 
+DECLARE_CONFIG_ENUM(hydra::lcd,
+                    DescriptorEvictionPolicy,
+                    {DescriptorEvictionPolicy::AGE, "AGE"},
+                    {DescriptorEvictionPolicy::LEAST_MATCHED, "LEAST_MATCHED"})
+
 DECLARE_CONFIG_ENUM(teaser,
                     TeaserInlierSelectionMode,
                     {TeaserInlierSelectionMode::PMC_EXACT, "PMC_EXACT"},
@@ -105,6 +110,18 @@ void visit_config(const Visitor& v, SubgraphConfig& config) {
 
 namespace lcd {
 
+template <typename Visitor>
+void visit_config(const Visitor& v, PreVerificationConfig& config) {
+  v.visit("enable", config.enable);
+  v.visit("num_bins", config.num_bins);
+  v.visit("max_distance_m", config.max_distance_m);
+  v.visit("min_histogram_similarity", config.min_histogram_similarity);
+  v.visit("num_triangle_samples", config.num_triangle_samples);
+  v.visit("triangle_tolerance_m", config.triangle_tolerance_m);
+  v.visit("min_triangle_ratio", config.min_triangle_ratio);
+  v.visit("seed", config.seed);
+}
+
 template <typename Visitor>
 void visit_config(const Visitor& v, LayerRegistrationConfig& config) {
   v.visit("min_correspondences", config.min_correspondences);
@@ -116,6 +133,7 @@ void visit_config(const Visitor& v, LayerRegistrationConfig& config) {
   if (config.recreate_subgraph) {
     v.visit("subgraph_extraction", config.subgraph_extraction);
   }
+  v.visit("pre_verification", config.pre_verification);
 }
 
 template <typename Visitor>
@@ -127,6 +145,12 @@ void visit_config(const Visitor& v, DescriptorMatchConfig& config) {
   v.visit("min_score_ratio", config.min_score_ratio);
   v.visit("min_match_separation_m", config.min_match_separation_m);
   v.visit("type", config.type);
+  v.visit("sketch_bits", config.sketch_bits);
+  if (config.sketch_bits > 0) {
+    v.visit("max_sketch_distance", config.max_sketch_distance);
+    v.visit("max_sketch_candidates", config.max_sketch_candidates);
+  }
+  v.visit("min_coarse_score", config.min_coarse_score);
 }
 
 template <typename Visitor, typename T>
@@ -146,8 +170,42 @@ void visit_config(const Visitor& v, GnnLcdConfig& config) {
   v.visit("object_connection_radius_m", config.object_connection_radius_m);
   v.visit("object_model_path", config.object_model_path);
   v.visit("places_model_path", config.places_model_path);
+  v.visit("use_quantized_models", config.use_quantized_models);
+  if (config.use_quantized_models) {
+    v.visit("quantized_object_model_path", config.quantized_object_model_path);
+    v.visit("quantized_places_model_path", config.quantized_places_model_path);
+  }
   v.visit("objects_pos_in_feature", config.objects_pos_in_feature);
   v.visit("places_pos_in_feature", config.places_pos_in_feature);
+  v.visit("num_intra_op_threads", config.num_intra_op_threads);
+  v.visit("num_inter_op_threads", config.num_inter_op_threads);
+  v.visit("use_global_thread_pools", config.use_global_thread_pools);
+  v.visit("optimization_level", config.optimization_level);
+  v.visit("cache_optimized_models", config.cache_optimized_models);
+  if (config.cache_optimized_models) {
+    v.visit("optimized_model_dir", config.optimized_model_dir);
+  }
+  v.visit("input_log_dir", config.input_log_dir);
+}
+
+template <typename Visitor>
+void visit_config(const Visitor& v, DescriptorEvictionConfig& config) {
+  v.visit("capacity", config.capacity);
+  v.visit("prune_redundant", config.prune_redundant);
+  if (config.prune_redundant) {
+    v.visit("redundancy_radius_m", config.redundancy_radius_m);
+    v.visit("redundancy_min_score", config.redundancy_min_score);
+  }
+  v.visit("policy", config.policy);
+}
+
+template <typename Visitor>
+void visit_config(const Visitor& v, DescriptorRefreshConfig& config) {
+  v.visit("max_refreshes_per_update", config.max_refreshes_per_update);
+  if (config.max_refreshes_per_update > 0) {
+    v.visit("radius_m", config.radius_m);
+    v.visit("min_refresh_period_s", config.min_refresh_period_s);
+  }
 }
 
 template <typename Visitor>
@@ -161,6 +219,7 @@ void visit_config(const Visitor& v, LcdDetectorConfig& config) {
   v.visit("object_extraction", config.object_extraction);
   v.visit("places_extraction", config.places_extraction);
   v.visit("place_histogram_config", config.place_histogram_config);
+  v.visit("descriptor_scales_m", config.descriptor_scales_m);
   if (config_parser::is_parser<Visitor>()) {
     config.agent_search_config.min_registration_score =
         config.agent_search_config.min_score;
@@ -172,6 +231,10 @@ void visit_config(const Visitor& v, LcdDetectorConfig& config) {
   if (config.use_gnn_descriptors) {
     v.visit("gnn_lcd", config.gnn_lcd);
   }
+  v.visit("descriptor_cache", config.descriptor_cache);
+  v.visit("descriptor_refresh", config.descriptor_refresh);
+  v.visit("num_descriptor_threads", config.num_descriptor_threads);
+  v.visit("compress_agent_bow", config.compress_agent_bow);
 }
 
 }  // namespace lcd
@@ -205,6 +268,7 @@ void visit_config(const Visitor& v, teaser::RobustRegistrationSolver::Params& co
 DECLARE_CONFIG_OSTREAM_OPERATOR(teaser, RobustRegistrationSolver::Params)
 DECLARE_CONFIG_OSTREAM_OPERATOR(hydra, SubgraphConfig)
 DECLARE_CONFIG_OSTREAM_OPERATOR(hydra::lcd, HistogramConfig<double>)
+DECLARE_CONFIG_OSTREAM_OPERATOR(hydra::lcd, PreVerificationConfig)
 DECLARE_CONFIG_OSTREAM_OPERATOR(hydra::lcd, LayerRegistrationConfig)
 DECLARE_CONFIG_OSTREAM_OPERATOR(hydra::lcd, DescriptorMatchConfig)
 DECLARE_CONFIG_OSTREAM_OPERATOR(hydra::lcd, LcdDetectorConfig)
@@ -85,6 +85,7 @@ class LoopClosureModule {
 
   std::priority_queue<NodeId, std::vector<NodeId>, std::greater<NodeId>> agent_queue_;
   std::list<NodeId> potential_lcd_root_nodes_;
+  NodeIdSet changed_nodes_;
 
   std::unique_ptr<lcd::LcdDetector> lcd_detector_;
   DynamicSceneGraph::Ptr lcd_graph_;
@@ -46,6 +46,39 @@
 namespace hydra {
 namespace lcd {
 
+struct PreVerificationConfig {
+  bool enable = false;
+  //! Number of bins for the pairwise distance histograms
+  size_t num_bins = 20;
+  //! Distances past this go into the last histogram bin
+  double max_distance_m = 10.0;
+  //! Minimum intersection of the normalized distance histograms (in [0, 1])
+  double min_histogram_similarity = 0.5;
+  //! Triangles sampled from the query subgraph (0 disables; semantic only)
+  size_t num_triangle_samples = 20;
+  //! Maximum difference in side lengths for two triangles to be congruent
+  double triangle_tolerance_m = 0.5;
+  //! Minimum fraction of sampled triangles with a congruent match
+  double min_triangle_ratio = 0.3;
+  //! Seed for triangle sampling (fixed so that results are repeatable)
+  size_t seed = 0;
+};
+
+enum class PreVerificationResult { ACCEPTED, HISTOGRAM_REJECTED, TRIANGLE_REJECTED };
+
+struct PreVerificationStats {
+  size_t num_checked = 0;
+  size_t num_histogram_rejected = 0;
+  size_t num_triangle_rejected = 0;
+  size_t num_accepted = 0;
+
+  void record(PreVerificationResult result);
+
+  PreVerificationStats& operator+=(const PreVerificationStats& other);
+};
+
+std::ostream& operator<<(std::ostream& out, const PreVerificationStats& stats);
+
 struct LayerRegistrationConfig {
   size_t min_correspondences = 5;
   size_t min_inliers = 5;
@@ -55,6 +88,7 @@ struct LayerRegistrationConfig {
   std::string registration_output_path = "";
   bool recreate_subgraph = false;
   SubgraphConfig subgraph_extraction;
+  PreVerificationConfig pre_verification;
 };
 
 struct DsgRegistrationInput {
@@ -72,6 +106,9 @@ struct DsgRegistrationSolver {
   virtual DsgRegistrationSolution solve(const DynamicSceneGraph& dsg,
                                         const DsgRegistrationInput& match,
                                         NodeId query_agent_id) const = 0;
+
+  //! Optional cache of subgraphs shared with the descriptor factories
+  SubgraphCache::Ptr subgraph_cache;
 };
 
 using TeaserParams = teaser::RobustRegistrationSolver::Params;
@@ -93,6 +130,7 @@ struct DsgTeaserSolver : DsgRegistrationSolver {
   std::string log_prefix;
   // registration call mutates the solver
   mutable teaser::RobustRegistrationSolver solver;
+  mutable PreVerificationStats pre_verification_stats;
 };
 
 using CorrespondenceFunc =
@@ -116,6 +154,65 @@ struct LayerRegistrationSolution {
   std::vector<std::pair<NodeId, NodeId>> inliers;
 };
 
+/**
+ * @brief Solve for the transform between corresponding points
+ *
+ * Column i of src_points and dest_points are the positions of correspondences[i].
+ */
+LayerRegistrationSolution solveLayerRegistration(
+    const LayerRegistrationConfig& config,
+    teaser::RobustRegistrationSolver& solver,
+    LayerId layer_id,
+    const std::vector<std::pair<NodeId, NodeId>>& correspondences,
+    const Eigen::Matrix<double, 3, Eigen::Dynamic>& src_points,
+    const Eigen::Matrix<double, 3, Eigen::Dynamic>& dest_points,
+    size_t num_src_nodes,
+    size_t num_dest_nodes);
+
+/**
+ * @brief Register two subgraphs of the same layer using their packed geometry
+ *
+ * Correspondences are all pairs of nodes with matching semantic labels (or all pairs
+ * if match_labels is false).
+ */
+LayerRegistrationSolution registerDsgLayer(const LayerRegistrationConfig& config,
+                                           teaser::RobustRegistrationSolver& solver,
+                                           LayerId layer_id,
+                                           const SubgraphGeometry& src,
+                                           const SubgraphGeometry& dest,
+                                           bool match_labels);
+
+/**
+ * @brief Intersection of the normalized pairwise distance histograms of two subgraphs
+ *
+ * Pairwise distances are invariant to rigid transforms, so subgraphs of the same
+ * place should have similar histograms. Returns 1 if either subgraph has fewer than
+ * two nodes.
+ */
+double pairwiseDistanceSimilarity(const PreVerificationConfig& config,
+                                  const SubgraphGeometry& src,
+                                  const SubgraphGeometry& dest);
+
+/**
+ * @brief Fraction of sampled source triangles with a congruent destination triangle
+ *
+ * Destination vertices must share the semantic labels of the source vertices. Returns
+ * 1 if the source subgraph has fewer than three nodes or sampling is disabled.
+ */
+double triangleCongruenceRatio(const PreVerificationConfig& config,
+                               const SubgraphGeometry& src,
+                               const SubgraphGeometry& dest);
+
+/**
+ * @brief Cheaply check that two subgraphs could be rigidly aligned
+ *
+ * The triangle test requires consistent labels and only runs if match_labels is true.
+ */
+PreVerificationResult preVerifyRegistration(const PreVerificationConfig& config,
+                                            const SubgraphGeometry& src,
+                                            const SubgraphGeometry& dest,
+                                            bool match_labels);
+
 template <typename NodeSet>
 std::list<NodeId> pruneSet(const SceneGraphLayer& layer, NodeSet& nodes) {
   std::list<NodeId> pruned;
@@ -195,48 +292,14 @@ LayerRegistrationSolution registerDsgLayer(
     dest_points.col(i) = dest.getPosition(correspondence.second);
   }
 
-  if (correspondences.size() < config.min_correspondences) {
-    VLOG(2) << "not enough correspondences for registration at layer " << src.id << ": "
-            << correspondences.size() << " / " << config.min_correspondences;
-    return {};
-  }
-
-  VLOG(20) << "=======================================================";
-  VLOG(20) << "Source: " << std::endl << src_points;
-  VLOG(20) << "Dest: " << std::endl << dest_points;
-
-  VLOG(1) << "[DSG LCD] Registering layer " << src.id << " with "
-          << correspondences.size() << " correspondences out of "
-          << problem.src_nodes.size() << " source and " << problem.dest_nodes.size()
-          << " destination nodes";
-
-  auto params = solver.getParams();
-  solver.reset(params);
-
-  teaser::RegistrationSolution result = solver.solve(src_points, dest_points);
-  if (!result.valid) {
-    return {};
-  }
-
-  std::vector<std::pair<NodeId, NodeId>> valid_correspondences;
-  valid_correspondences.reserve(
-      std::min(problem.src_nodes.size(), problem.dest_nodes.size()));
-
-  auto inliers = solver.getInlierMaxClique();
-  if (inliers.size() < config.min_inliers) {
-    VLOG(2) << "[DSG LCD] Not enough inliers for registration at layer " << src.id
-            << ": " << inliers.size() << " / " << config.min_inliers;
-    return {};
-  }
-
-  for (const auto& index : inliers) {
-    CHECK_LT(static_cast<size_t>(index), correspondences.size());
-    valid_correspondences.push_back(correspondences.at(index));
-  }
-
-  return {true,
-          gtsam::Pose3(gtsam::Rot3(result.rotation), result.translation),
-          valid_correspondences};
+  return solveLayerRegistration(config,
+                                solver,
+                                src.id,
+                                correspondences,
+                                src_points,
+                                dest_points,
+                                problem.src_nodes.size(),
+                                problem.dest_nodes.size());
 }
 
 template <typename NodeSet>
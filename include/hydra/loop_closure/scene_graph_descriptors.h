@@ -34,6 +34,7 @@
  * -------------------------------------------------------------------------- */
 #pragma once
 #include "hydra/common/dsg_types.h"
+#include "hydra/loop_closure/compressed_bow.h"
 #include "hydra/loop_closure/subgraph_extraction.h"
 
 namespace hydra {
@@ -43,12 +44,17 @@ struct Descriptor {
   using Ptr = std::unique_ptr<Descriptor>;
   Eigen::Matrix<uint32_t, Eigen::Dynamic, 1> words;
   Eigen::VectorXf values;
+  //! Bag-of-words vector stored instead of words and values when compressed
+  CompressedBow bow;
   bool normalized = false;
   bool is_null = false;
+  //! values holds this many equal blocks, ordered from finest to coarsest scale
+  size_t num_scales = 1;
   std::set<NodeId> nodes;
   NodeId root_node;
   Eigen::Vector3d root_position;
   std::chrono::nanoseconds timestamp;
+  std::vector<uint64_t> sketch;
 };
 
 struct DescriptorFactory {
@@ -58,15 +64,20 @@ struct DescriptorFactory {
 
   virtual Descriptor::Ptr construct(const DynamicSceneGraph& dsg,
                                     const DynamicSceneGraphNode& agent_node) const = 0;
+
+  //! Optional cache of subgraphs shared with other factories and registration
+  SubgraphCache::Ptr subgraph_cache;
 };
 
 struct AgentDescriptorFactory : DescriptorFactory {
-  AgentDescriptorFactory() = default;
+  explicit AgentDescriptorFactory(bool compress_bow = false);
 
   virtual ~AgentDescriptorFactory() = default;
 
   Descriptor::Ptr construct(const DynamicSceneGraph& graph,
                             const DynamicSceneGraphNode& agent_node) const override;
+
+  const bool compress_bow;
 };
 
 struct ObjectDescriptorFactory : DescriptorFactory {
@@ -112,5 +123,60 @@ struct PlaceDescriptorFactory : DescriptorFactory {
   const HistogramConfig<double> histogram;
 };
 
+/**
+ * @brief Histograms of a neighborhood around the root place at several radii
+ *
+ * All scales come from the single subgraph extracted with the provided config: the
+ * coarsest scale is that whole subgraph (matching the single-scale descriptors) and
+ * each radius below the maximum extraction radius adds a finer scale. Nodes are
+ * sorted by distance to the root once and the running histogram is copied out every
+ * time a radius is crossed. A node connected to the root only through nodes outside
+ * a smaller radius still counts towards that scale.
+ */
+struct MultiScaleDescriptorFactory : DescriptorFactory {
+  MultiScaleDescriptorFactory(const SubgraphConfig& config,
+                              const std::vector<double>& radii_m,
+                              size_t num_bins,
+                              bool is_places);
+
+  virtual ~MultiScaleDescriptorFactory() = default;
+
+  Descriptor::Ptr construct(const DynamicSceneGraph& graph,
+                            const DynamicSceneGraphNode& agent_node) const override;
+
+  //! Bin for node i of the subgraph (values of num_bins or more are skipped)
+  virtual size_t getBin(const DynamicSceneGraph& graph,
+                        const SubgraphGeometry& subgraph,
+                        size_t index) const = 0;
+
+  const SubgraphConfig config;
+  //! Scale radii sorted from smallest to largest (the last is the extraction radius)
+  const std::vector<double> radii_m;
+  const size_t num_bins;
+  const bool is_places;
+};
+
+struct MultiScaleObjectDescriptorFactory : MultiScaleDescriptorFactory {
+  MultiScaleObjectDescriptorFactory(const SubgraphConfig& config,
+                                    const std::vector<double>& radii_m,
+                                    size_t num_classes);
+
+  size_t getBin(const DynamicSceneGraph& graph,
+                const SubgraphGeometry& subgraph,
+                size_t index) const override;
+};
+
+struct MultiScalePlaceDescriptorFactory : MultiScaleDescriptorFactory {
+  MultiScalePlaceDescriptorFactory(const SubgraphConfig& config,
+                                   const std::vector<double>& radii_m,
+                                   const HistogramConfig<double>& histogram);
+
+  size_t getBin(const DynamicSceneGraph& graph,
+                const SubgraphGeometry& subgraph,
+                size_t index) const override;
+
+  const HistogramConfig<double> histogram;
+};
+
 }  // namespace lcd
 }  // namespace hydra
@@ -33,6 +33,11 @@
  * purposes notwithstanding any copyright notation herein.
  * -------------------------------------------------------------------------- */
 #pragma once
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include "hydra/common/dsg_types.h"
 
 namespace hydra {
@@ -53,4 +58,83 @@ std::set<NodeId> getSubgraphNodes(const SubgraphConfig& config,
                                   NodeId root_node,
                                   bool is_places);
 
+/**
+ * @brief Subgraph nodes with their positions and labels packed for fast access
+ *
+ * Nodes are sorted by id; column i of positions and entry i of labels belong to
+ * nodes[i]. Nodes without semantic attributes have a label of 0.
+ */
+struct SubgraphGeometry {
+  using Ptr = std::shared_ptr<const SubgraphGeometry>;
+  using Label = SemanticNodeAttributes::Label;
+
+  SubgraphGeometry() = default;
+
+  //! Gather geometry for the nodes that exist in the provided layer
+  SubgraphGeometry(const DynamicSceneGraph& graph,
+                   LayerId layer,
+                   NodeId root,
+                   const std::set<NodeId>& nodes);
+
+  inline size_t size() const { return nodes.size(); }
+
+  inline bool empty() const { return nodes.empty(); }
+
+  bool contains(NodeId node) const;
+
+  std::set<NodeId> nodeSet() const;
+
+  NodeId root = 0;
+  std::vector<NodeId> nodes;
+  Eigen::Matrix<double, 3, Eigen::Dynamic> positions;
+  std::vector<Label> labels;
+};
+
+//! Number of nodes present in both subgraphs
+size_t countSharedNodes(const SubgraphGeometry& lhs, const SubgraphGeometry& rhs);
+
+/**
+ * @brief Subgraphs keyed by root, layer and extraction config
+ *
+ * Subgraphs are only valid while the graph they were extracted from is unchanged, so
+ * the cache should be cleared whenever the graph is updated (e.g. once per
+ * loop-closure cycle). Safe to use from multiple threads.
+ */
+class SubgraphCache {
+ public:
+  using Ptr = std::shared_ptr<SubgraphCache>;
+
+  SubgraphGeometry::Ptr get(const SubgraphConfig& config,
+                            const DynamicSceneGraph& graph,
+                            NodeId root_node,
+                            bool is_places);
+
+  void clear();
+
+  size_t size() const;
+
+  inline size_t numHits() const { return num_hits_; }
+
+  inline size_t numMisses() const { return num_misses_; }
+
+ private:
+  using Key = std::tuple<NodeId, bool, bool, double, double, size_t>;
+
+  static Key makeKey(const SubgraphConfig& config, NodeId root_node, bool is_places);
+
+  mutable std::mutex mutex_;
+  std::map<Key, SubgraphGeometry::Ptr> cache_;
+  std::atomic<size_t> num_hits_{0};
+  std::atomic<size_t> num_misses_{0};
+};
+
+/**
+ * @brief Get subgraph geometry, using the cache if provided
+ */
+SubgraphGeometry::Ptr getSubgraphGeometry(const SubgraphConfig& config,
+                                          const DynamicSceneGraph& graph,
+                                          NodeId root_node,
+                                          bool is_places,
+                                          SubgraphCache* cache = nullptr);
+
 }  // namespace hydra
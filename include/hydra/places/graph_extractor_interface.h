@@ -35,6 +35,7 @@
 #pragma once
 #include "hydra/common/dsg_types.h"
 #include "hydra/places/graph_extractor_config.h"
+#include "hydra/places/gvd_dirty_tracker.h"
 #include "hydra/places/gvd_graph.h"
 #include "hydra/places/gvd_voxel.h"
 #include "hydra/places/voxblox_types.h"
@@ -54,6 +55,15 @@ class GraphExtractorInterface {
 
   virtual void pushGvdIndex(const GlobalIndex& index);
 
+  /**
+   * @brief Consume the voxels marked for extraction during a GVD update
+   *
+   * Each voxel that reached the extraction basis count is pushed once, no matter how
+   * many times the update revisited it. Clears are not deferred and are never issued
+   * here.
+   */
+  virtual void pushDirtyBlocks(const GvdDirtyTracker& tracker);
+
   virtual void clearGvdIndex(const GlobalIndex& index) = 0;
 
   virtual void removeDistantIndex(const GlobalIndex& index) = 0;
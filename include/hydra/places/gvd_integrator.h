@@ -36,6 +36,7 @@
 #include <utility>
 
 #include "hydra/places/graph_extractor_interface.h"
+#include "hydra/places/gvd_dirty_tracker.h"
 #include "hydra/places/gvd_integrator_config.h"
 #include "hydra/places/gvd_parent_tracker.h"
 #include "hydra/places/gvd_utilities.h"
@@ -43,8 +44,14 @@
 #include "hydra/places/update_statistics.h"
 #include "hydra/places/voxblox_types.h"
 #include "hydra/places/vertex_voxel.h"
+#include "hydra/utils/voxel_mask.h"
 
 namespace hydra {
+
+// forward declare to avoid include
+class DynamicVoxelDetector;
+class TsdfChangeTracker;
+
 namespace places {
 
 struct OpenQueueEntry {
@@ -75,12 +82,16 @@ class GvdIntegrator {
                       const Layer<VertexVoxel>& vertices,
                       const MeshLayer& mesh,
                       bool clear_updated_flag,
-                      bool use_all_blocks = false);
+                      bool use_all_blocks = false,
+                      const TsdfChangeTracker* tsdf_changes = nullptr);
 
   void updateGvd(uint64_t timestamp_ns);
 
   void archiveBlocks(const BlockIndexList& blocks);
 
+  //! skip TSDF voxels flagged as dynamic by the detector (not owned)
+  void setDynamicVoxels(const DynamicVoxelDetector* detector);
+
   // TODO(nathan) test this
   static bool setFixedParent(const Layer<GvdVoxel>& layer,
                              const GvdNeighborhood::IndexMatrix& neighbor_indices,
@@ -100,9 +111,17 @@ class GvdIntegrator {
   // TSDF propagation
   void propagateSurface(const BlockIndex& block_index,
                         const MeshLayer& mesh,
-                        const Layer<VertexVoxel>& vertices);
+                        const Layer<VertexVoxel>& vertices,
+                        VoxelMask* surface_changes = nullptr);
+
+  void processTsdfBlock(const Block<TsdfVoxel>& block,
+                        const BlockIndex& index,
+                        const VoxelMask* voxels = nullptr);
 
-  void processTsdfBlock(const Block<TsdfVoxel>& block, const BlockIndex& index);
+  void processTsdfVoxel(const TsdfVoxel& tsdf_voxel,
+                        Block<GvdVoxel>& gvd_block,
+                        const BlockIndex& block_index,
+                        size_t linear_index);
 
   void updateUnobservedVoxel(const TsdfVoxel& tsdf_voxel,
                              const GlobalIndex& index,
@@ -135,9 +154,11 @@ class GvdIntegrator {
   const double default_distance_;
   GvdIntegratorConfig config_;
   Layer<GvdVoxel>::Ptr gvd_layer_;
+  const DynamicVoxelDetector* dynamic_voxels_;
 
   GraphExtractorInterface::Ptr graph_extractor_;
   GvdParentTracker parent_tracker_;
+  GvdDirtyTracker dirty_tracker_;
   GvdNeighborhood::IndexMatrix neighbor_indices_;
 
   BucketQueue<OpenQueueEntry> open_;
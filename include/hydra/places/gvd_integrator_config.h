@@ -68,6 +68,8 @@ struct GvdIntegratorConfig {
   uint8_t min_basis_for_extraction = 3;
   VoronoiCheckConfig voronoi_config;
   bool extract_graph = true;
+  // push each voxel that reaches the extraction basis once per update
+  bool use_dirty_masks = false;
   GraphExtractorConfig graph_extractor;
 };
 
@@ -91,6 +93,7 @@ void visit_config(const Visitor& v, GvdIntegratorConfig& config) {
   v.visit("min_basis_for_extraction", config.min_basis_for_extraction);
   v.visit("voronoi_config", config.voronoi_config);
   v.visit("extract_graph", config.extract_graph);
+  v.visit("use_dirty_masks", config.use_dirty_masks);
   v.visit("graph_extractor", config.graph_extractor);
 }
 
@@ -0,0 +1,99 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <kimera_semantics/semantic_integrator_base.h>
+#include <voxblox/core/layer.h>
+#include <voxblox/integrator/tsdf_integrator.h>
+
+#include <mutex>
+
+#include "hydra/reconstruction/compact_semantic_voxel.h"
+#include "hydra/reconstruction/tsdf_change_tracker.h"
+
+namespace hydra {
+
+/**
+ * @brief TSDF integrator that tracks semantics with compact semantic voxels
+ *
+ * Each observation only updates the entry of the observed label (instead of the full
+ * distribution over all labels). Points are labeled from their color via the label map
+ * in the semantic config.
+ */
+class CompactSemanticTsdfIntegrator : public voxblox::TsdfIntegratorBase {
+ public:
+  using SemanticConfig = kimera::SemanticIntegratorBase::SemanticConfig;
+  using SemanticLayer = voxblox::Layer<CompactSemanticVoxel>;
+
+  CompactSemanticTsdfIntegrator(const Config& config,
+                                const SemanticConfig& semantic_config,
+                                voxblox::Layer<voxblox::TsdfVoxel>* tsdf_layer,
+                                SemanticLayer* semantic_layer);
+
+  virtual ~CompactSemanticTsdfIntegrator() = default;
+
+  void integratePointCloud(const voxblox::Transformation& T_G_C,
+                           const voxblox::Pointcloud& points_C,
+                           const voxblox::Colors& colors,
+                           const bool freespace_points = false) override;
+
+  //! record all modified TSDF voxels in the provided tracker (not owned)
+  void setChangeTracker(TsdfChangeTracker* tracker);
+
+ protected:
+  void integrateFunction(const voxblox::Transformation& T_G_C,
+                         const voxblox::Pointcloud& points_C,
+                         const voxblox::Colors& colors,
+                         const bool freespace_points,
+                         voxblox::ThreadSafeIndex* index_getter);
+
+  CompactSemanticVoxel* getSemanticVoxelPtr(
+      const voxblox::GlobalIndex& global_voxel_idx,
+      voxblox::Block<CompactSemanticVoxel>::Ptr* last_block,
+      voxblox::BlockIndex* last_block_idx);
+
+  void updateSemanticVoxel(const voxblox::GlobalIndex& global_voxel_idx,
+                           kimera::SemanticLabel label,
+                           voxblox::TsdfVoxel* tsdf_voxel,
+                           CompactSemanticVoxel* semantic_voxel);
+
+  SemanticConfig semantic_config_;
+  SemanticLayer* semantic_layer_;
+  TsdfChangeTracker* change_tracker_;
+  std::mutex semantic_block_mutex_;
+  size_t num_labels_;
+  float log_likelihood_ratio_;
+};
+
+}  // namespace hydra
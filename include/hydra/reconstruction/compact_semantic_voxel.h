@@ -0,0 +1,83 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace hydra {
+
+/**
+ * @brief Semantic voxel that only keeps the k most likely labels
+ *
+ * Log-probabilities are stored quantized and relative to the most likely label (so
+ * the most likely label always has a value of 0). All labels that are not tracked
+ * explicitly share the residual log-probability.
+ */
+struct CompactSemanticVoxel {
+  static constexpr size_t kMaxLabels = 4;
+  // number of quantization steps per nat
+  static constexpr float kLogScale = 256.0f;
+
+  uint8_t num_labels = 0;
+  uint8_t labels[kMaxLabels];
+  uint16_t log_probs[kMaxLabels];
+  uint16_t residual = 0;
+};
+
+/**
+ * @brief Apply a single label observation to the voxel
+ * @param voxel Voxel to update
+ * @param label Observed label
+ * @param log_likelihood_ratio Log-likelihood of the observed label minus the
+ *        log-likelihood of any other label
+ * @param total_labels Number of labels in the full distribution (used to spread the
+ *        probability of an evicted label over the untracked labels)
+ */
+void updateCompactSemanticVoxel(CompactSemanticVoxel& voxel,
+                                uint8_t label,
+                                float log_likelihood_ratio,
+                                size_t total_labels);
+
+std::optional<uint8_t> getMostLikelyLabel(const CompactSemanticVoxel& voxel);
+
+/**
+ * @brief Recover the (approximate) full label distribution from the voxel
+ */
+Eigen::VectorXf getLabelDistribution(const CompactSemanticVoxel& voxel,
+                                     size_t total_labels);
+
+}  // namespace hydra
@@ -0,0 +1,142 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <voxblox/core/block_hash.h>
+#include <voxblox/core/layer.h>
+#include <voxblox/core/voxel.h>
+
+#include "hydra/reconstruction/tsdf_change_tracker.h"
+#include "hydra/utils/voxel_mask.h"
+
+namespace hydra {
+
+struct DynamicVoxelConfig {
+  bool enable = false;
+  // voxels with a distance below this are considered occupied
+  float occupied_distance_m = 0.05;
+  // voxels with a distance above this are considered free (distances in-between
+  // keep their previous state so that noise at static surfaces doesn't flip them)
+  float free_distance_m = 0.15;
+  // free/occupied flips (within the flip window) before a voxel is marked dynamic
+  size_t min_flips = 3;
+  // flips older than this many frames are forgotten
+  size_t flip_window = 20;
+  // frames without a flip before a dynamic voxel is released to the static map
+  size_t release_frames = 30;
+};
+
+template <typename Visitor>
+void visit_config(const Visitor& v, DynamicVoxelConfig& config) {
+  v.visit("enable", config.enable);
+  v.visit("occupied_distance_m", config.occupied_distance_m);
+  v.visit("free_distance_m", config.free_distance_m);
+  v.visit("min_flips", config.min_flips);
+  v.visit("flip_window", config.flip_window);
+  v.visit("release_frames", config.release_frames);
+}
+
+struct DynamicVoxel {
+  //! latest distance observed during a flip
+  float distance = 0.0f;
+  uint8_t num_flips = 0;
+  bool dynamic = false;
+  //! frame of the latest flip
+  uint64_t last_flip = 0;
+};
+
+/**
+ * @brief Flags TSDF voxels that repeatedly flip between free and occupied
+ *
+ * Voxels that flip are tracked in a side layer that only contains blocks with
+ * recent flips. Voxels marked dynamic are excluded from meshing and GVD updates
+ * until they stop flipping for a configurable number of frames.
+ */
+class DynamicVoxelDetector {
+ public:
+  using DynamicLayer = voxblox::Layer<DynamicVoxel>;
+  using TsdfLayer = voxblox::Layer<voxblox::TsdfVoxel>;
+
+  DynamicVoxelDetector(const DynamicVoxelConfig& config,
+                       float voxel_size,
+                       int voxels_per_side);
+
+  /**
+   * @brief update voxel states from every TSDF block flagged for meshing
+   *
+   * Blocks containing voxels that are released back to the static map are flagged
+   * for meshing and the GVD (and the voxels are recorded in changes if provided).
+   */
+  void update(TsdfLayer& tsdf, float min_weight, TsdfChangeTracker* changes = nullptr);
+
+  //! returns nullptr if no voxels in the block are dynamic
+  const VoxelMask* getDynamicMask(const voxblox::BlockIndex& block_index) const;
+
+  bool isDynamic(const voxblox::BlockIndex& block_index, size_t linear_index) const;
+
+  void removeBlock(const voxblox::BlockIndex& block_index);
+
+  inline size_t numDynamic() const { return num_dynamic_; }
+
+  inline const DynamicLayer& getLayer() const { return *layer_; }
+
+ private:
+  struct BlockState {
+    explicit BlockState(size_t num_voxels);
+
+    VoxelMask observed;
+    VoxelMask occupied;
+    VoxelMask dynamic;
+    size_t num_dynamic;
+  };
+
+  using StateMap = voxblox::AnyIndexHashMapType<BlockState>::type;
+
+  BlockState& getState(const voxblox::BlockIndex& block_index);
+
+  void updateBlock(const voxblox::Block<voxblox::TsdfVoxel>& block,
+                   const voxblox::BlockIndex& block_index,
+                   float min_weight);
+
+  void releaseVoxels(TsdfLayer& tsdf, TsdfChangeTracker* changes);
+
+  const DynamicVoxelConfig config_;
+  const size_t num_voxels_;
+  uint64_t frame_;
+  size_t num_dynamic_;
+  StateMap states_;
+  DynamicLayer::Ptr layer_;
+};
+
+}  // namespace hydra
@@ -0,0 +1,110 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <voxblox/core/block.h>
+#include <voxblox/core/layer.h>
+#include <voxblox/core/voxel.h>
+
+#include <cstdint>
+
+namespace hydra {
+
+/**
+ * @brief TSDF voxel with a 16-bit fixed-point distance and a 16-bit weight
+ *
+ * Distances are stored as a fraction of the truncation distance and weights are
+ * stored as bfloat16 (i.e., the upper half of an IEEE float) so that both very small
+ * and very large weights keep a bounded relative error.
+ */
+struct QuantizedTsdfVoxel {
+  int16_t distance = 0;
+  uint16_t weight = 0;
+  voxblox::Color color;
+};
+
+struct TsdfQuantizer {
+  TsdfQuantizer() : TsdfQuantizer(1.0f) {}
+
+  explicit TsdfQuantizer(float truncation_distance);
+
+  int16_t quantizeDistance(float distance) const;
+
+  float dequantizeDistance(int16_t distance) const;
+
+  static uint16_t quantizeWeight(float weight);
+
+  static float dequantizeWeight(uint16_t weight);
+
+  QuantizedTsdfVoxel quantize(const voxblox::TsdfVoxel& voxel) const;
+
+  voxblox::TsdfVoxel dequantize(const QuantizedTsdfVoxel& voxel) const;
+
+  void quantizeBlock(const voxblox::Block<voxblox::TsdfVoxel>& block,
+                     voxblox::Block<QuantizedTsdfVoxel>& quantized) const;
+
+  void dequantizeBlock(const voxblox::Block<QuantizedTsdfVoxel>& quantized,
+                       voxblox::Block<voxblox::TsdfVoxel>& block) const;
+
+  /**
+   * @brief Fuse a quantized block into a block that holds newer observations
+   *
+   * Voxels are combined with the same weighted average used by TSDF integration, so
+   * merging is equivalent to having integrated the new observations into the
+   * restored block.
+   */
+  void mergeBlock(const voxblox::Block<QuantizedTsdfVoxel>& quantized,
+                  float max_weight,
+                  voxblox::Block<voxblox::TsdfVoxel>& block) const;
+
+  //! Largest absolute error of a dequantized distance (within the truncation distance)
+  float distance_resolution;
+};
+
+/**
+ * @brief Merge quantized blocks into any TSDF blocks reallocated at the same index
+ *
+ * Integration can reach blocks that are stored quantized (e.g. long rays), in which
+ * case the integrator allocates a fresh block that only holds the latest
+ * observations. Merging folds the stored data back in and drops the quantized copy.
+ * Only the given blocks (i.e., the blocks touched by integration) are checked.
+ * @returns Number of merged blocks
+ */
+size_t mergeQuantizedBlocks(const TsdfQuantizer& quantizer,
+                            float max_weight,
+                            const voxblox::BlockIndexList& blocks,
+                            voxblox::Layer<QuantizedTsdfVoxel>& quantized,
+                            voxblox::Layer<voxblox::TsdfVoxel>& tsdf);
+
+}  // namespace hydra
@@ -39,6 +39,7 @@
 #include "hydra/config/config.h"
 #include "hydra/config/eigen_config_types.h"
 #include "hydra/reconstruction/configs.h"
+#include "hydra/reconstruction/dynamic_voxel_detector.h"
 
 DECLARE_CONFIG_ENUM(kimera,
                     ColorMode,
@@ -111,6 +112,20 @@ struct ReconstructionConfig {
   size_t num_poses_per_update = 1;
   size_t max_input_queue_size = 0;
   bool make_pose_graph = false;
+  // kimera semantic integrator type (e.g. "fast" or "merged") that keeps the full
+  // label distribution per voxel, or "compact" to integrate every point (without
+  // kimera's ray bundling) and only track the most likely labels per voxel
+  std::string semantic_integrator = "fast";
+  // only propagate TSDF voxels changed by integration to the GVD (the compact
+  // integrator records its changes, other integrators are diffed after integration)
+  bool use_tsdf_change_masks = false;
+  // store TSDF blocks outside of the active radius with 16-bit distances and weights
+  bool quantize_inactive_blocks = false;
+  // should be larger than the max ray length so that all integrated blocks are active
+  // (neighbors of active blocks are also kept at full precision)
+  double active_block_radius_m = 4.0;
+  // excludes voxels that flip between free and occupied from meshing and the GVD
+  DynamicVoxelConfig dynamic_voxels;
   places::GvdIntegratorConfig gvd;
   voxblox::TsdfIntegratorBase::Config tsdf;
   kimera::SemanticIntegratorBase::SemanticConfig semantics;
@@ -140,6 +155,11 @@ void visit_config(const Visitor& v, ReconstructionConfig& config) {
   v.visit("num_poses_per_update", config.num_poses_per_update);
   v.visit("max_input_queue_size", config.max_input_queue_size);
   v.visit("make_pose_graph", config.make_pose_graph);
+  v.visit("semantic_integrator", config.semantic_integrator);
+  v.visit("use_tsdf_change_masks", config.use_tsdf_change_masks);
+  v.visit("quantize_inactive_blocks", config.quantize_inactive_blocks);
+  v.visit("active_block_radius_m", config.active_block_radius_m);
+  v.visit("dynamic_voxels", config.dynamic_voxels);
   v.visit("gvd", config.gvd);
   v.visit("tsdf", config.tsdf);
   v.visit("semantics", config.semantics);
@@ -152,4 +172,5 @@ void visit_config(const Visitor& v, ReconstructionConfig& config) {
 
 DECLARE_CONFIG_OSTREAM_OPERATOR(voxblox, TsdfIntegratorBase::Config)
 DECLARE_CONFIG_OSTREAM_OPERATOR(kimera, SemanticIntegratorBase::SemanticConfig)
+DECLARE_CONFIG_OSTREAM_OPERATOR(hydra, DynamicVoxelConfig)
 DECLARE_CONFIG_OSTREAM_OPERATOR(hydra, ReconstructionConfig)
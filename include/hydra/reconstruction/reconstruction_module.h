@@ -42,9 +42,13 @@
 #include "hydra/common/robot_prefix_config.h"
 #include "hydra/places/gvd_voxel.h"
 #include "hydra/places/vertex_voxel.h"
+#include "hydra/reconstruction/compact_semantic_voxel.h"
+#include "hydra/reconstruction/quantized_voxels.h"
 #include "hydra/reconstruction/configs.h"
+#include "hydra/reconstruction/dynamic_voxel_detector.h"
 #include "hydra/reconstruction/reconstruction_config.h"
 #include "hydra/reconstruction/reconstruction_output.h"
+#include "hydra/reconstruction/tsdf_change_tracker.h"
 
 namespace hydra {
 
@@ -129,6 +133,12 @@ class ReconstructionModule {
 
   voxblox::BlockIndexList findBlocksToArchive(const voxblox::Point& center) const;
 
+  double getResidentRadius() const;
+
+  void quantizeInactiveBlocks(const voxblox::Point& center);
+
+  void restoreActiveBlocks(const voxblox::Point& center);
+
  protected:
   mutable std::mutex tsdf_mutex_;
   mutable std::mutex gvd_mutex_;
@@ -146,10 +156,16 @@ class ReconstructionModule {
   OutputQueue::Ptr output_queue_;
 
   voxblox::Layer<voxblox::TsdfVoxel>::Ptr tsdf_;
+  voxblox::Layer<QuantizedTsdfVoxel>::Ptr quantized_tsdf_;
+  TsdfQuantizer tsdf_quantizer_;
   voxblox::Layer<kimera::SemanticVoxel>::Ptr semantics_;
+  voxblox::Layer<CompactSemanticVoxel>::Ptr compact_semantics_;
   voxblox::Layer<places::GvdVoxel>::Ptr gvd_;
   voxblox::Layer<places::VertexVoxel>::Ptr vertices_;
   voxblox::MeshLayer::Ptr mesh_;
+  std::unique_ptr<TsdfChangeTracker> tsdf_changes_;
+  std::unique_ptr<TsdfChangeDetector> tsdf_change_detector_;
+  std::unique_ptr<DynamicVoxelDetector> dynamic_voxels_;
 
   std::unique_ptr<voxblox::TsdfIntegratorBase> tsdf_integrator_;
   std::unique_ptr<VoxelAwareMeshIntegrator> mesh_integrator_;
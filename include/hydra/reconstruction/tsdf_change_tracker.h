@@ -0,0 +1,124 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <voxblox/core/block_hash.h>
+#include <voxblox/core/common.h>
+#include <voxblox/core/layer.h>
+#include <voxblox/core/voxel.h>
+
+#include <mutex>
+#include <vector>
+
+#include "hydra/reconstruction/quantized_voxels.h"
+#include "hydra/utils/voxel_mask.h"
+
+namespace hydra {
+
+/**
+ * @brief Per-block masks of TSDF voxels modified by integration
+ *
+ * Filled by the TSDF integrator and consumed by the GVD integrator so that TSDF
+ * propagation only has to look at voxels that might have changed.
+ */
+class TsdfChangeTracker {
+ public:
+  using MaskMap = voxblox::AnyIndexHashMapType<VoxelMask>::type;
+
+  explicit TsdfChangeTracker(int voxels_per_side);
+
+  //! get (and allocate if missing) the mask for a block. Thread-safe.
+  VoxelMask& getMask(const voxblox::BlockIndex& block_index);
+
+  //! mark a voxel as changed. Thread-safe.
+  void markChanged(const voxblox::GlobalIndex& index);
+
+  //! returns nullptr if no changes are recorded for the block
+  const VoxelMask* getChanges(const voxblox::BlockIndex& block_index) const;
+
+  void clearBlock(const voxblox::BlockIndex& block_index);
+
+  void clear();
+
+  size_t getLinearIndex(const voxblox::GlobalIndex& index,
+                        voxblox::BlockIndex& block_index) const;
+
+ private:
+  const int voxels_per_side_;
+  mutable std::mutex mutex_;
+  MaskMap masks_;
+};
+
+/**
+ * @brief Recovers change masks for TSDF integrators that can't record them directly
+ *
+ * Keeps a quantized copy of the distance and weight of every voxel in the blocks it
+ * has seen and compares blocks flagged as updated (voxblox::Update::kMap) against
+ * that copy. Blocks without a copy are compared against unobserved voxels.
+ */
+class TsdfChangeDetector {
+ public:
+  explicit TsdfChangeDetector(float truncation_distance);
+
+  /**
+   * @brief Mark voxels of updated blocks that changed since the last call
+   *
+   * Clears the kMap update flag of every compared block.
+   * @returns Number of voxels marked as changed
+   */
+  size_t update(voxblox::Layer<voxblox::TsdfVoxel>& tsdf, TsdfChangeTracker& changes);
+
+  //! store the current state of a block without marking any changes
+  void resetBlock(const voxblox::BlockIndex& index,
+                  const voxblox::Block<voxblox::TsdfVoxel>& block);
+
+  void removeBlock(const voxblox::BlockIndex& index);
+
+  size_t numBlocks() const;
+
+ private:
+  struct VoxelState {
+    int16_t distance = 0;
+    uint16_t weight = 0;
+  };
+
+  using BlockState = std::vector<VoxelState>;
+
+  VoxelState getState(const voxblox::TsdfVoxel& voxel) const;
+
+  TsdfQuantizer quantizer_;
+  voxblox::AnyIndexHashMapType<BlockState>::type blocks_;
+};
+
+}  // namespace hydra
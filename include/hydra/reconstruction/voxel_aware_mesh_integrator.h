@@ -36,6 +36,7 @@
 #include <voxblox/mesh/mesh_integrator.h>
 
 #include "hydra/places/vertex_voxel.h"
+#include "hydra/reconstruction/dynamic_voxel_detector.h"
 
 namespace hydra {
 
@@ -50,6 +51,9 @@ class VoxelAwareMeshIntegrator : public voxblox::MeshIntegrator<voxblox::TsdfVox
 
   virtual ~VoxelAwareMeshIntegrator() = default;
 
+  //! treat voxels flagged as dynamic by the detector as unobserved (not owned)
+  void setDynamicVoxels(const DynamicVoxelDetector* detector);
+
   virtual void generateMesh(bool only_mesh_updated_blocks,
                             bool clear_updated_flag) override;
 
@@ -82,6 +86,7 @@ class VoxelAwareMeshIntegrator : public voxblox::MeshIntegrator<voxblox::TsdfVox
 
  protected:
   voxblox::Layer<places::VertexVoxel>::Ptr vertex_layer_;
+  const DynamicVoxelDetector* dynamic_voxels_;
 
   Eigen::Matrix<voxblox::FloatingPoint, 3, 8> cube_coord_offsets_;
 };
@@ -34,6 +34,7 @@
  * -------------------------------------------------------------------------- */
 #pragma once
 #include "hydra/common/dsg_types.h"
+#include "hydra/rooms/graph_filtration.h"
 
 namespace hydra {
 
@@ -57,15 +58,18 @@ struct ClusterResults {
 ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
                                         const InitialClusters& initial_clusters,
                                         size_t max_iters = 5,
-                                        double gamma = 1.0);
+                                        double gamma = 1.0,
+                                        const NodeFilter& filter = {});
 
 ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
                                         const InitialClusters& initial_clusters,
                                         const EdgeWeightFunc& edge_weight_func,
                                         size_t max_iters = 5,
-                                        double gamma = 1.0);
+                                        double gamma = 1.0,
+                                        const NodeFilter& filter = {});
 
 ClusterResults clusterGraphByNeighbors(const SceneGraphLayer& layer,
-                                       const InitialClusters& initial_clusters);
+                                       const InitialClusters& initial_clusters,
+                                       const NodeFilter& filter = {});
 
 }  // namespace hydra
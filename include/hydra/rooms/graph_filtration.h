@@ -49,6 +49,48 @@ struct ComponentLifetime {
 };
 
 using LifetimeMap = std::unordered_map<NodeId, ComponentLifetime>;
+//! restricts graph algorithms to a subset of nodes (empty filters pass every node)
+using NodeFilter = std::function<bool(NodeId)>;
+
+inline bool passesFilter(const NodeFilter& filter, NodeId node) {
+  return !filter || filter(node);
+}
+
+/**
+ * @brief Disjoint set that logs every union so that it can be moved to the partition
+ * at any point of the filtration
+ *
+ * DisjointSet doesn't use path compression, so undoing a union only requires
+ * restoring the parent and size of the merged root. Unions have to be applied in
+ * order of decreasing distance.
+ */
+struct RollbackDisjointSet : public DisjointSet {
+  struct UnionEvent {
+    double distance;
+    NodeId parent;
+    NodeId child;
+    size_t child_size;
+  };
+
+  RollbackDisjointSet();
+
+  virtual ~RollbackDisjointSet() = default;
+
+  std::optional<NodeId> doUnion(NodeId lhs,
+                                NodeId rhs,
+                                double distance,
+                                bool rhs_better = false);
+
+  //! undo or redo unions until exactly the unions above the threshold are applied
+  void setThreshold(double threshold);
+
+  //! get components (sorted by smallest node id) that pass the size and node filter
+  std::vector<std::vector<NodeId>> getComponents(size_t min_component_size = 0,
+                                                 const NodeFilter& filter = {}) const;
+
+  std::vector<UnionEvent> events;
+  size_t num_applied;
+};
 
 struct BarcodeTracker : public DisjointSet {
   BarcodeTracker();
@@ -59,7 +101,7 @@ struct BarcodeTracker : public DisjointSet {
 
   void addNode(NodeId node, double distance);
 
-  bool doUnion(DisjointSet& components,
+  bool doUnion(RollbackDisjointSet& components,
                const std::unordered_map<NodeId, double>& node_distances,
                NodeId node,
                NodeId rhs,
@@ -87,7 +129,9 @@ Filtration getGraphFiltration(const SceneGraphLayer& layer,
                               BarcodeTracker& tracker,
                               double diff_threshold_m,
                               const ComponentCallback& count_components,
-                              bool include_nodes = true);
+                              bool include_nodes = true,
+                              RollbackDisjointSet* components_out = nullptr,
+                              const NodeFilter& filter = {});
 
 std::pair<size_t, size_t> getTrimmedFiltration(const Filtration& old_filtration,
                                                double min_dilation_m,
@@ -33,22 +33,16 @@
  * purposes notwithstanding any copyright notation herein.
  * -------------------------------------------------------------------------- */
 #pragma once
-#include <fstream>
 #include <unordered_set>
 
 #include "hydra/common/dsg_types.h"
 #include "hydra/rooms/graph_clustering.h"
 #include "hydra/rooms/room_finder_config.h"
+#include "hydra/rooms/room_finder_logger.h"
+#include "hydra/utils/worker_pool.h"
 
 namespace hydra {
 
-struct GraphInfo {
-  size_t offset;
-  size_t size;
-  size_t num_nodes;
-  size_t num_edges;
-};
-
 class RoomFinder {
  public:
   explicit RoomFinder(const RoomFinderConfig& config);
@@ -62,18 +56,22 @@ class RoomFinder {
   void enableLogging(const std::string& log_path);
 
  protected:
-  InitialClusters getBestComponents(const SceneGraphLayer& places) const;
+  InitialClusters getBestComponents(const SceneGraphLayer& places,
+                                    const NodeFilter& filter = {}) const;
+
+  ClusterResults findClusters(const SceneGraphLayer& places,
+                              const NodeFilter& filter = {}) const;
+
+  ClusterResults findClustersByFloor(const SceneGraphLayer& places) const;
 
   SceneGraphLayer::Ptr makeRoomLayer(const SceneGraphLayer& places);
 
   RoomFinderConfig config_;
   ClusterResults last_results_;
   std::map<size_t, NodeId> cluster_room_map_;
-  mutable bool logged_once_ = false;
-  std::unique_ptr<std::ofstream> log_file_;
-  std::unique_ptr<std::ofstream> graph_log_file_;
-  mutable std::vector<GraphInfo> graph_entries_;
-  mutable size_t graph_offset_ = 0;
+  size_t num_updates_ = 0;
+  std::unique_ptr<RoomFinderLogger> logger_;
+  std::unique_ptr<WorkerPool> floor_workers_;
 };
 
 }  // namespace hydra
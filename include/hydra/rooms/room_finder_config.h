@@ -81,6 +81,20 @@ struct RoomFinderConfig {
   double dilation_diff_threshold_m = 1.0e-4;
   bool log_filtrations = false;
   bool log_place_graphs = false;
+  // copy the places for the log every this many room updates
+  size_t place_graph_log_period = 1;
+  // log a full copy of the places instead of a delta every this many updates
+  size_t graph_keyframe_period = 20;
+  // detect rooms separately (and in parallel) for each floor
+  bool partition_by_floor = false;
+  // resolution of the place height histogram used to find floors
+  double floor_bin_size_m = 0.2;
+  // minimum height difference between floors
+  double min_floor_separation_m = 2.0;
+  // floors are split where the histogram drops to this fraction of the floor peaks
+  double max_floor_valley_ratio = 0.2;
+  // number of threads for per-floor room detection (0 uses all cores)
+  size_t num_partition_threads = 0;
 };
 
 template <typename Visitor>
@@ -100,6 +114,13 @@ void visit_config(const Visitor& v, RoomFinderConfig& config) {
   v.visit("dilation_diff_threshold_m", config.dilation_diff_threshold_m);
   v.visit("log_filtrations", config.log_filtrations);
   v.visit("log_place_graphs", config.log_place_graphs);
+  v.visit("place_graph_log_period", config.place_graph_log_period);
+  v.visit("graph_keyframe_period", config.graph_keyframe_period);
+  v.visit("partition_by_floor", config.partition_by_floor);
+  v.visit("floor_bin_size_m", config.floor_bin_size_m);
+  v.visit("min_floor_separation_m", config.min_floor_separation_m);
+  v.visit("max_floor_valley_ratio", config.max_floor_valley_ratio);
+  v.visit("num_partition_threads", config.num_partition_threads);
 
   std::string prefix_string;
   if (!config_parser::is_parser<Visitor>()) {
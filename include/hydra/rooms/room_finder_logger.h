@@ -0,0 +1,150 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#include "hydra/common/dsg_types.h"
+#include "hydra/common/input_queue.h"
+#include "hydra/rooms/graph_filtration.h"
+
+namespace hydra {
+
+/**
+ * @brief Minimal copy of the places layer needed to replay room detection
+ */
+struct PlacesSnapshot {
+  struct Node {
+    NodeId id;
+    float x;
+    float y;
+    float z;
+    float distance;
+
+    bool operator==(const Node& other) const;
+  };
+
+  struct Edge {
+    NodeId source;
+    NodeId target;
+    float weight;
+
+    bool operator==(const Edge& other) const;
+  };
+
+  //! nodes sorted by id
+  std::vector<Node> nodes;
+  //! edges sorted by source and then target (with source < target)
+  std::vector<Edge> edges;
+
+  static PlacesSnapshot fromLayer(const SceneGraphLayer& places);
+
+  //! copy the layer without sorting (call sort before using the snapshot)
+  static PlacesSnapshot copyLayer(const SceneGraphLayer& places);
+
+  void sort();
+};
+
+struct PlacesDelta {
+  std::vector<NodeId> removed_nodes;
+  std::vector<PlacesSnapshot::Node> nodes;
+  std::vector<std::pair<NodeId, NodeId>> removed_edges;
+  std::vector<PlacesSnapshot::Edge> edges;
+
+  static PlacesDelta between(const PlacesSnapshot& prev, const PlacesSnapshot& curr);
+
+  void apply(PlacesSnapshot& snapshot) const;
+};
+
+/**
+ * @brief Writes room finder diagnostics to a binary log on a background thread
+ *
+ * The log starts with the magic "HRFL" and a uint32 version, followed by records of
+ * [uint8 type, uint32 update, uint32 payload size, payload]. Records are written in
+ * native (little-endian) byte order, and scripts/read_room_finder_log.py can read
+ * them back. Places are logged as a keyframe every keyframe_period updates and as
+ * deltas to the previous update otherwise.
+ */
+class RoomFinderLogger {
+ public:
+  enum class RecordType : uint8_t { FILTRATION = 0, KEYFRAME = 1, DELTA = 2 };
+
+  static constexpr uint32_t VERSION = 1;
+
+  RoomFinderLogger(const std::string& log_path, size_t keyframe_period);
+
+  ~RoomFinderLogger();
+
+  //! copies the relevant parts of the layer and returns immediately (sorting and
+  //! delta computation happen on the writer thread)
+  void logPlaces(size_t update, const SceneGraphLayer& places);
+
+  //! safe to call from multiple threads
+  void logFiltration(size_t update,
+                     const Filtration& filtration,
+                     const std::pair<size_t, size_t>& window,
+                     double threshold);
+
+ private:
+  struct Record {
+    using Ptr = std::shared_ptr<Record>;
+    RecordType type;
+    size_t update;
+    std::unique_ptr<PlacesSnapshot> places;
+    Filtration filtration;
+    std::pair<size_t, size_t> window;
+    double threshold;
+  };
+
+  void spin();
+
+  void writeRecord(Record& record);
+
+  void flush();
+
+  const size_t keyframe_period_;
+  std::ofstream fout_;
+  std::string buffer_;
+  size_t num_since_keyframe_;
+  std::unique_ptr<PlacesSnapshot> prev_places_;
+
+  std::atomic<bool> should_shutdown_{false};
+  InputQueue<Record::Ptr> queue_;
+  std::unique_ptr<std::thread> thread_;
+};
+
+}  // namespace hydra
@@ -47,4 +47,31 @@ void addEdgesToRoomLayer(const SceneGraphLayer& places,
                          const std::map<size_t, NodeId> label_to_room_map,
                          SceneGraphLayer& rooms);
 
+/**
+ * @brief Find the heights that separate floors by clustering place heights
+ *
+ * Heights are binned into a histogram. Peaks that are at least min_separation_m
+ * apart are candidate floors, and two neighboring floors are split at the emptiest
+ * bin between them if that bin holds no more than max_valley_ratio of the smaller
+ * peak (otherwise the floors are merged).
+ * @returns Sorted heights of the boundaries between floors
+ */
+std::vector<double> findFloorBoundaries(const std::vector<double>& heights,
+                                        double bin_size_m,
+                                        double min_separation_m,
+                                        double max_valley_ratio);
+
+/**
+ * @brief Split places into floors by height (see findFloorBoundaries)
+ *
+ * Places are never split by connectivity, so tall rooms, stairwells and ramps stay
+ * with the floor they are closest to. Partitions are ordered from the lowest floor
+ * up and partitions with fewer than min_partition_size places are dropped.
+ */
+std::vector<std::vector<NodeId>> partitionPlacesByFloor(const SceneGraphLayer& places,
+                                                        double bin_size_m,
+                                                        double min_separation_m,
+                                                        double max_valley_ratio,
+                                                        size_t min_partition_size = 0);
+
 }  // namespace hydra
@@ -0,0 +1,101 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <optional>
+#include <type_traits>
+
+#include "hydra/common/dsg_types.h"
+
+namespace hydra {
+
+struct CompactEdge {
+  size_t source;
+  size_t target;
+  double weight;
+};
+
+/**
+ * @brief Snapshot of a layer (or a subset of a layer) over dense node indices
+ *
+ * Nodes are assigned indices 0..N-1 in ascending order of node id. Adjacency is stored
+ * in CSR form: the neighbors of node i are neighbors[offsets[i]] to
+ * neighbors[offsets[i + 1] - 1]. Positions and edge weights are stored contiguously
+ * so that layer-wide algorithms avoid hashing and pointer chasing.
+ */
+struct CompactGraph {
+  CompactGraph() = default;
+
+  explicit CompactGraph(const SceneGraphLayer& layer);
+
+  //! build from the subgraph induced by the provided nodes (missing nodes are skipped)
+  //! by walking the siblings of each node instead of every edge in the layer
+  CompactGraph(const SceneGraphLayer& layer, const std::unordered_set<NodeId>& nodes);
+
+  inline size_t numNodes() const { return node_ids.size(); }
+
+  inline size_t numEdges() const { return edges.size(); }
+
+  std::optional<size_t> getIndex(NodeId node) const;
+
+  std::vector<NodeId> getNodeIds(const std::vector<size_t>& indices) const;
+
+  //! collect a value per node (in index order) from the original layer
+  template <typename Func>
+  auto getNodeValues(const SceneGraphLayer& layer, const Func& func) const {
+    using Value = std::decay_t<decltype(func(std::declval<const SceneGraphNode&>()))>;
+    std::vector<Value> values;
+    values.reserve(node_ids.size());
+    for (const auto node_id : node_ids) {
+      values.push_back(func(layer.getNode(node_id)->get()));
+    }
+    return values;
+  }
+
+  std::vector<NodeId> node_ids;
+  std::unordered_map<NodeId, size_t> indices;
+  Eigen::Matrix<double, 3, Eigen::Dynamic> positions;
+  std::vector<size_t> offsets;
+  std::vector<size_t> neighbors;
+  std::vector<double> neighbor_weights;
+  std::vector<CompactEdge> edges;
+};
+
+/**
+ * @brief Get the connected components of a compact graph
+ * @returns Node indices of each component (components and members in ascending order)
+ */
+std::vector<std::vector<size_t>> getConnectedComponents(const CompactGraph& graph);
+
+}  // namespace hydra
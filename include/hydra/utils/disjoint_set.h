@@ -34,6 +34,7 @@
  * -------------------------------------------------------------------------- */
 #pragma once
 #include <optional>
+#include <vector>
 
 #include "hydra/common/dsg_types.h"
 
@@ -59,4 +60,27 @@ struct DisjointSet {
   std::unordered_map<NodeId, size_t> sizes;
 };
 
+/**
+ * @brief Disjoint set over dense indices 0..N-1 (e.g. from a CompactGraph)
+ *
+ * Uses path halving and union by size. Unlike DisjointSet, lookups modify the set, so
+ * unions cannot be rolled back.
+ */
+struct DenseDisjointSet {
+  explicit DenseDisjointSet(size_t num_elements = 0);
+
+  size_t findSet(size_t index);
+
+  //! merge the sets containing lhs and rhs, returning the root that was merged away
+  std::optional<size_t> doUnion(size_t lhs, size_t rhs);
+
+  size_t setSize(size_t index);
+
+  size_t numSets() const;
+
+  std::vector<size_t> parents;
+  std::vector<size_t> sizes;
+  size_t num_sets;
+};
+
 }  // namespace hydra
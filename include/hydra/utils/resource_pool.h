@@ -0,0 +1,120 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hydra {
+
+/**
+ * @brief Reusable scratch objects handed out to one caller at a time
+ *
+ * Concurrent callers each get their own object (creating one if none are free) and
+ * the lock is only held while checking objects in and out, so only the work itself
+ * runs in parallel. Objects are kept when returned so their allocations are reused.
+ */
+template <typename T>
+class ResourcePool {
+ public:
+  using Factory = std::function<std::unique_ptr<T>()>;
+
+  class Handle {
+   public:
+    Handle(ResourcePool* pool, std::unique_ptr<T>&& resource)
+        : pool_(pool), resource_(std::move(resource)) {}
+
+    Handle(Handle&& other) = default;
+
+    Handle& operator=(Handle&& other) = delete;
+
+    ~Handle() {
+      if (pool_ && resource_) {
+        pool_->release(std::move(resource_));
+      }
+    }
+
+    inline T& operator*() const { return *resource_; }
+
+    inline T* operator->() const { return resource_.get(); }
+
+   private:
+    ResourcePool* pool_;
+    std::unique_ptr<T> resource_;
+  };
+
+  explicit ResourcePool(const Factory& factory = [] { return std::make_unique<T>(); })
+      : factory_(factory), num_created_(0) {}
+
+  ResourcePool(const ResourcePool& other) = delete;
+
+  ResourcePool& operator=(const ResourcePool& other) = delete;
+
+  //! take a free object (or make a new one) until the handle goes out of scope
+  Handle acquire() {
+    {  // start critical section
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        auto resource = std::move(free_.back());
+        free_.pop_back();
+        return Handle(this, std::move(resource));
+      }
+
+      ++num_created_;
+    }  // end critical section
+
+    return Handle(this, factory_());
+  }
+
+  //! number of objects created so far (i.e., the most callers seen at once)
+  inline size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_created_;
+  }
+
+ private:
+  void release(std::unique_ptr<T>&& resource) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(std::move(resource));
+  }
+
+  const Factory factory_;
+  mutable std::mutex mutex_;
+  size_t num_created_;
+  std::vector<std::unique_ptr<T>> free_;
+};
+
+}  // namespace hydra
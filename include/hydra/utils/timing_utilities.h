@@ -68,6 +68,10 @@ class ElapsedTimeRecorder {
 
   void stop(const std::string& timer_name);
 
+  void add(const std::string& timer_name,
+           const uint64_t& timestamp,
+           const std::chrono::nanoseconds& elapsed);
+
   void reset();
 
   std::optional<double> getLastElapsed(const std::string& timer_name) const;
@@ -129,5 +133,30 @@ class ScopedTimer {
   bool verbosity_disables_;
 };
 
+/**
+ * @brief Lock that records how long it waited for and then held a mutex
+ *
+ * Measurements are recorded as "<name>_wait" and "<name>_hold" so that contention on
+ * shared mutexes can be compared across modules. Unlike ScopedTimer, multiple
+ * threads may use the same name at once.
+ */
+class TimedLock {
+ public:
+  TimedLock(std::mutex& mutex, const std::string& name, uint64_t timestamp);
+
+  ~TimedLock();
+
+  void unlock();
+
+ private:
+  using Clock = std::chrono::high_resolution_clock;
+
+  std::unique_lock<std::mutex> lock_;
+  std::string name_;
+  uint64_t timestamp_;
+  bool enabled_;
+  Clock::time_point acquired_;
+};
+
 }  // namespace timing
 }  // namespace hydra
@@ -0,0 +1,85 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hydra {
+
+/**
+ * @brief Dense bitmask over the voxels of a block (indexed by linear voxel index)
+ */
+struct VoxelMask {
+  VoxelMask() = default;
+
+  explicit VoxelMask(size_t num_voxels) : words((num_voxels + 63) / 64, 0) {}
+
+  inline bool test(size_t index) const {
+    return words[index / 64] & (1ull << (index % 64));
+  }
+
+  inline void set(size_t index) { words[index / 64] |= (1ull << (index % 64)); }
+
+  inline void reset(size_t index) { words[index / 64] &= ~(1ull << (index % 64)); }
+
+  //! safe to call concurrently with other calls to setAtomic
+  inline void setAtomic(size_t index) {
+    __atomic_fetch_or(&words[index / 64], 1ull << (index % 64), __ATOMIC_RELAXED);
+  }
+
+  inline size_t count() const {
+    size_t total = 0;
+    for (const auto word : words) {
+      total += __builtin_popcountll(word);
+    }
+    return total;
+  }
+
+  template <typename Func>
+  void forEach(Func&& func) const {
+    for (size_t w = 0; w < words.size(); ++w) {
+      uint64_t word = words[w];
+      while (word) {
+        func(64 * w + __builtin_ctzll(word));
+        word &= word - 1;
+      }
+    }
+  }
+
+  std::vector<uint64_t> words;
+};
+
+}  // namespace hydra
@@ -0,0 +1,142 @@
+# Copyright 2022, Massachusetts Institute of Technology.
+# All Rights Reserved
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#  1. Redistributions of source code must retain the above copyright notice,
+#     this list of conditions and the following disclaimer.
+#
+#  2. Redistributions in binary form must reproduce the above copyright notice,
+#     this list of conditions and the following disclaimer in the documentation
+#     and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Research was sponsored by the United States Air Force Research Laboratory and
+# the United States Air Force Artificial Intelligence Accelerator and was
+# accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+# and conclusions contained in this document are those of the authors and should
+# not be interpreted as representing the official policies, either expressed or
+# implied, of the United States Air Force or the U.S. Government. The U.S.
+# Government is authorized to reproduce and distribute reprints for Government
+# purposes notwithstanding any copyright notation herein.
+#
+"""Quantize a GNN descriptor model to INT8 for use with the loop closure detector."""
+import pathlib
+import struct
+
+import click
+import numpy as np
+from onnxruntime import quantization as ortq
+
+TENSOR_TYPES = [
+    np.float32,
+    np.float64,
+    np.int8,
+    np.int16,
+    np.int32,
+    np.int64,
+    np.uint8,
+    np.uint16,
+    np.uint32,
+    np.uint64,
+]
+
+
+def read_tensors(filename):
+    """Read tensors saved by hydra::gnn::saveTensorMap."""
+    with open(filename, "rb") as fin:
+        data = fin.read()
+
+    if data[:4] != b"HGTM":
+        raise ValueError(f"invalid tensor file {filename}")
+
+    version, num_tensors = struct.unpack_from("<II", data, 4)
+    if version != 1:
+        raise ValueError(f"unsupported version {version} for {filename}")
+
+    offset = 12
+    tensors = {}
+    for _ in range(num_tensors):
+        (name_len,) = struct.unpack_from("<I", data, offset)
+        offset += 4
+        name = data[offset : offset + name_len].decode()
+        offset += name_len
+        tensor_type, num_dims = struct.unpack_from("<BI", data, offset)
+        offset += 5
+        dims = struct.unpack_from(f"<{num_dims}q", data, offset)
+        offset += 8 * num_dims
+        dtype = np.dtype(TENSOR_TYPES[tensor_type])
+        size = int(np.prod(dims)) if num_dims > 0 else 0
+        values = np.frombuffer(data, dtype=dtype, count=size, offset=offset)
+        offset += size * dtype.itemsize
+        tensors[name] = values.reshape(dims)
+
+    return tensors
+
+
+class CorpusReader(ortq.CalibrationDataReader):
+    """Feed stored subgraph inputs to the static quantization calibration."""
+
+    def __init__(self, corpus_dir, max_samples):
+        """Find the stored subgraphs to use for calibration."""
+        files = sorted(pathlib.Path(corpus_dir).glob("*.tensors"))
+        if max_samples > 0:
+            files = files[:max_samples]
+
+        self._files = iter(files)
+
+    def get_next(self):
+        """Get the next set of inputs."""
+        filename = next(self._files, None)
+        return None if filename is None else read_tensors(filename)
+
+
+@click.command()
+@click.argument("model_path", type=click.Path(exists=True))
+@click.argument("output_path", type=click.Path())
+@click.option("-c", "--corpus-dir", default=None, help="subgraphs for calibration")
+@click.option("-n", "--max-samples", default=0, help="max calibration subgraphs")
+@click.option("--per-channel", is_flag=True, help="quantize weights per channel")
+def main(model_path, output_path, corpus_dir, max_samples, per_channel):
+    """
+    Quantize MODEL_PATH and save it to OUTPUT_PATH.
+
+    Uses dynamic quantization unless a corpus of stored subgraph inputs is provided
+    (see input_log_dir in the GNN LCD config), in which case activations are
+    statically quantized using the corpus for calibration. Run gnn_model_reader
+    with --corpus_dir and --compare_model afterwards to check the accuracy.
+    """
+    if corpus_dir is None:
+        ortq.quantize_dynamic(
+            model_path,
+            output_path,
+            per_channel=per_channel,
+            weight_type=ortq.QuantType.QInt8,
+        )
+    else:
+        ortq.quantize_static(
+            model_path,
+            output_path,
+            CorpusReader(corpus_dir, max_samples),
+            quant_format=ortq.QuantFormat.QDQ,
+            per_channel=per_channel,
+            activation_type=ortq.QuantType.QInt8,
+            weight_type=ortq.QuantType.QInt8,
+        )
+
+    click.secho(f"saved quantized model to {output_path}", fg="green")
+
+
+if __name__ == "__main__":
+    main()
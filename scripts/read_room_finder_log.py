@@ -0,0 +1,175 @@
+# Copyright 2022, Massachusetts Institute of Technology.
+# All Rights Reserved
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#  1. Redistributions of source code must retain the above copyright notice,
+#     this list of conditions and the following disclaimer.
+#
+#  2. Redistributions in binary form must reproduce the above copyright notice,
+#     this list of conditions and the following disclaimer in the documentation
+#     and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Research was sponsored by the United States Air Force Research Laboratory and
+# the United States Air Force Artificial Intelligence Accelerator and was
+# accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+# and conclusions contained in this document are those of the authors and should
+# not be interpreted as representing the official policies, either expressed or
+# implied, of the United States Air Force or the U.S. Government. The U.S.
+# Government is authorized to reproduce and distribute reprints for Government
+# purposes notwithstanding any copyright notation herein.
+#
+#
+#!/usr/bin/env python3
+"""Read binary room finder logs (written when log_filtrations is enabled)."""
+import argparse
+import json
+import pathlib
+import struct
+import sys
+
+
+FILTRATION = 0
+KEYFRAME = 1
+DELTA = 2
+NODE = struct.Struct("<Qffff")
+EDGE = struct.Struct("<QQf")
+
+
+class Reader:
+    """Sequential reader over a byte buffer."""
+
+    def __init__(self, data, offset=0):
+        """Start reading at the offset."""
+        self.data = data
+        self.offset = offset
+
+    def read(self, fmt):
+        """Unpack a struct format string."""
+        values = struct.unpack_from(fmt, self.data, self.offset)
+        self.offset += struct.calcsize(fmt)
+        return values
+
+    def read_structs(self, fmt):
+        """Read a uint32 count followed by that many structs."""
+        (count,) = self.read("<I")
+        end = self.offset + count * fmt.size
+        values = list(fmt.iter_unpack(self.data[self.offset : end]))
+        self.offset = end
+        return values
+
+    def read_ids(self, fmt):
+        """Read a uint32 count followed by that many id tuples."""
+        (count,) = self.read("<I")
+        return [self.read(fmt) for _ in range(count)]
+
+
+def _parse_filtration(reader):
+    start, end, threshold = reader.read("<IId")
+    (count,) = reader.read("<I")
+    values = [reader.read("<dI") for _ in range(count)]
+    return {
+        "start": start,
+        "end": end,
+        "threshold": threshold,
+        "filtration": [{"d": d, "c": c} for d, c in values],
+    }
+
+
+def _apply_keyframe(reader, graph):
+    graph["nodes"] = {x[0]: x[1:] for x in reader.read_structs(NODE)}
+    graph["edges"] = {(x[0], x[1]): x[2] for x in reader.read_structs(EDGE)}
+
+
+def _apply_delta(reader, graph):
+    for (node,) in reader.read_ids("<Q"):
+        graph["nodes"].pop(node, None)
+    graph["nodes"].update({x[0]: x[1:] for x in reader.read_structs(NODE)})
+    for edge in reader.read_ids("<QQ"):
+        graph["edges"].pop(edge, None)
+    graph["edges"].update({(x[0], x[1]): x[2] for x in reader.read_structs(EDGE)})
+
+
+def read_log(log_path):
+    """Yield (update, filtrations, graph) for every update in the log."""
+    data = pathlib.Path(log_path).read_bytes()
+    if data[:4] != b"HRFL":
+        raise ValueError(f"{log_path} is not a room finder log")
+
+    reader = Reader(data, 4)
+    (version,) = reader.read("<I")
+    if version != 1:
+        raise ValueError(f"unsupported log version: {version}")
+
+    graph = None
+    current = None
+    filtrations = []
+    while reader.offset + 9 <= len(data):
+        record_type, update, size = reader.read("<BII")
+        if reader.offset + size > len(data):
+            break  # truncated record at the end of the log
+
+        payload = Reader(data[reader.offset : reader.offset + size])
+        reader.offset += size
+
+        if current is not None and update != current:
+            yield current, filtrations, graph
+            filtrations = []
+
+        current = update
+        if record_type == FILTRATION:
+            filtrations.append(_parse_filtration(payload))
+        elif record_type == KEYFRAME:
+            graph = {}
+            _apply_keyframe(payload, graph)
+        elif record_type == DELTA:
+            if graph is None:
+                raise ValueError(f"delta for update {update} without keyframe")
+            graph = {"nodes": dict(graph["nodes"]), "edges": dict(graph["edges"])}
+            _apply_delta(payload, graph)
+        else:
+            raise ValueError(f"unknown record type: {record_type}")
+
+    if current is not None:
+        yield current, filtrations, graph
+
+
+def main():
+    """Summarize a log or dump it as json."""
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("log_path", type=str, help="binary log to read")
+    parser.add_argument("--json", action="store_true", help="dump filtrations as json")
+    args = parser.parse_args()
+
+    updates = []
+    for update, filtrations, graph in read_log(args.log_path):
+        if args.json:
+            updates.append({"update": update, "filtrations": filtrations})
+            continue
+
+        num_nodes = len(graph["nodes"]) if graph else 0
+        num_edges = len(graph["edges"]) if graph else 0
+        thresholds = ", ".join(f"{x['threshold']:.3f}" for x in filtrations)
+        print(
+            f"update {update}: {num_nodes} places, {num_edges} edges,"
+            f" thresholds: [{thresholds}]"
+        )
+
+    if args.json:
+        json.dump(updates, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -46,6 +46,7 @@
 namespace hydra {
 
 using hydra::timing::ScopedTimer;
+using hydra::timing::TimedLock;
 using kimera_pgmo::DeformationGraph;
 using kimera_pgmo::DeformationGraphPtr;
 using kimera_pgmo::KimeraPgmoInterface;
@@ -76,7 +77,8 @@ BackendModule::BackendModule(const RobotPrefixConfig& prefix,
       shared_dsg_(dsg),
       private_dsg_(backend_dsg),
       shared_places_copy_(DsgLayers::PLACES),
-      state_(state) {
+      state_(state),
+      room_labels_(std::make_shared<RoomLabelStore>(config.room_label_min_overlap)) {
   KimeraPgmoInterface::config_ = pgmo_config;
 
   if (!KimeraPgmoInterface::initializeFromConfig()) {
@@ -332,6 +334,7 @@ void BackendModule::setDefaultUpdateFunctions() {
         new dsg_updates::UpdateRoomsFunctor(config_.room_finder));
     update_rooms_functor_->room_finder->enableLogging(config_.log_path +
                                                       "/room_filtrations");
+    update_rooms_functor_->room_labels = room_labels_;
     dsg_update_funcs_.push_back(std::bind(&dsg_updates::UpdateRoomsFunctor::call,
                                           update_rooms_functor_.get(),
                                           std::placeholders::_1,
@@ -454,7 +457,8 @@ bool BackendModule::updatePrivateDsg(size_t timestamp_ns, bool force_update) {
     cachePlacePos();  // save place positions before grabbing new attributes from
                       // frontend
 
-    std::unique_lock<std::mutex> shared_graph_lock(shared_dsg_->mutex);
+    TimedLock shared_graph_lock(
+        shared_dsg_->mutex, "backend/shared_dsg_lock", timestamp_ns);
     if (!force_update && shared_dsg_->last_update_time > timestamp_ns) {
       return false;
     }
@@ -629,31 +633,15 @@ void BackendModule::runZmqUpdates() {
       continue;
     }
 
-    std::unique_lock<std::mutex> lock(private_dsg_->mutex);
     auto update_graph = zmq_receiver_->graph();
     if (!update_graph) {
       LOG(ERROR) << "zmq receiver graph is invalid";
       continue;
     }
 
-    const auto& rooms = update_graph->getLayer(DsgLayers::ROOMS);
-    for (const auto& id_node_pair : rooms.nodes()) {
-      const auto new_name =
-          id_node_pair.second->attributes<SemanticNodeAttributes>().name;
-      room_name_map_[id_node_pair.first] = new_name;
-
-      auto node_opt = private_dsg_->graph->getNode(id_node_pair.first);
-      if (!node_opt) {
-        VLOG(1) << "received update for node "
-                << NodeSymbol(id_node_pair.first).getLabel()
-                << " but node no longer exists";
-        continue;
-      }
-
-      VLOG(2) << "assiging name " << new_name << " to "
-              << NodeSymbol(id_node_pair.first).getLabel();
-      node_opt->get().attributes<SemanticNodeAttributes>().name = new_name;
-    }
+    // labels are applied by the backend thread (not here) to avoid locking the graph
+    const auto num_labels = room_labels_->submit(*update_graph);
+    VLOG(2) << "received " << num_labels << " room label(s)";
   }
 }
 
@@ -772,15 +760,11 @@ void BackendModule::callUpdateFunctions(size_t timestamp_ns,
     merge_handler_->updateMerges(layer_merges.second, *private_dsg_->graph);
   }
 
-  std::unique_lock<std::mutex> lock(private_dsg_->mutex);
-  const auto& rooms = private_dsg_->graph->getLayer(DsgLayers::ROOMS);
-  for (auto& id_node_pair : rooms.nodes()) {
-    const auto iter = room_name_map_.find(id_node_pair.first);
-    if (iter == room_name_map_.end()) {
-      continue;
-    }
-
-    id_node_pair.second->attributes<SemanticNodeAttributes>().name = iter->second;
+  // rooms are relabeled by the room update whenever they change, so only newly
+  // received labels need to be applied here
+  if (room_labels_->hasPending()) {
+    std::unique_lock<std::mutex> lock(private_dsg_->mutex);
+    room_labels_->apply(*private_dsg_->graph);
   }
 }
 
@@ -0,0 +1,193 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/backend/room_label_store.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <tuple>
+
+namespace hydra {
+
+namespace {
+
+inline size_t countOverlap(const std::set<NodeId>& lhs, const std::set<NodeId>& rhs) {
+  const auto& smaller = lhs.size() < rhs.size() ? lhs : rhs;
+  const auto& larger = lhs.size() < rhs.size() ? rhs : lhs;
+  size_t count = 0;
+  for (const auto id : smaller) {
+    count += larger.count(id);
+  }
+  return count;
+}
+
+}  // namespace
+
+RoomLabelStore::RoomLabelStore(double min_overlap) : min_overlap_(min_overlap) {}
+
+void RoomLabelStore::submit(NodeId room,
+                            const std::string& name,
+                            const std::set<NodeId>& footprint) {
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  pending_.push_back({room, {name, footprint}});
+  has_pending_ = true;
+}
+
+size_t RoomLabelStore::submit(const DynamicSceneGraph& update_graph) {
+  if (!update_graph.hasLayer(DsgLayers::ROOMS)) {
+    return 0;
+  }
+
+  size_t num_submitted = 0;
+  const auto& rooms = update_graph.getLayer(DsgLayers::ROOMS);
+  for (const auto& id_node_pair : rooms.nodes()) {
+    const auto& name = id_node_pair.second->attributes<SemanticNodeAttributes>().name;
+    if (name.empty()) {
+      continue;
+    }
+
+    submit(id_node_pair.first, name, id_node_pair.second->children());
+    ++num_submitted;
+  }
+
+  return num_submitted;
+}
+
+bool RoomLabelStore::hasPending() const { return has_pending_; }
+
+void RoomLabelStore::insertLabel(Label&& label) {
+  // a new label for the same area replaces any previous labels for it
+  auto iter = labels_.begin();
+  while (iter != labels_.end()) {
+    const auto overlap = countOverlap(iter->footprint, label.footprint);
+    const auto min_size = std::min(iter->footprint.size(), label.footprint.size());
+    if (min_size && overlap >= min_overlap_ * min_size) {
+      iter = labels_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  labels_.push_back(std::move(label));
+}
+
+size_t RoomLabelStore::apply(DynamicSceneGraph& graph) {
+  std::list<PendingLabel> pending;
+  {  // start pending critical section
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    pending.swap(pending_);
+    has_pending_ = false;
+  }  // end pending critical section
+
+  std::unique_lock<std::mutex> lock(labels_mutex_);
+  for (auto& info : pending) {
+    if (info.label.footprint.empty()) {
+      const auto node = graph.getNode(info.room);
+      if (node) {
+        info.label.footprint = node->get().children();
+      }
+    }
+
+    if (info.label.footprint.empty()) {
+      VLOG(1) << "dropping label '" << info.label.name << "' for "
+              << NodeSymbol(info.room).getLabel() << ": no footprint";
+      continue;
+    }
+
+    VLOG(2) << "storing label '" << info.label.name << "' for "
+            << NodeSymbol(info.room).getLabel();
+    insertLabel(std::move(info.label));
+  }
+
+  if (labels_.empty() || !graph.hasLayer(DsgLayers::ROOMS)) {
+    return 0;
+  }
+
+  // candidate (overlap, label, room) pairs, assigned greedily by largest overlap
+  std::vector<std::tuple<size_t, size_t, NodeId>> candidates;
+  const auto& rooms = graph.getLayer(DsgLayers::ROOMS);
+  for (const auto& id_node_pair : rooms.nodes()) {
+    const auto& children = id_node_pair.second->children();
+    for (size_t i = 0; i < labels_.size(); ++i) {
+      const auto& footprint = labels_[i].footprint;
+      const auto overlap = countOverlap(footprint, children);
+      if (overlap && overlap >= min_overlap_ * footprint.size()) {
+        candidates.emplace_back(overlap, i, id_node_pair.first);
+      }
+    }
+  }
+
+  // ties go to the oldest label and then the lowest room id so that assignments are
+  // deterministic
+  std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+    if (std::get<0>(lhs) != std::get<0>(rhs)) {
+      return std::get<0>(lhs) > std::get<0>(rhs);
+    }
+
+    return std::tie(std::get<1>(lhs), std::get<2>(lhs)) <
+           std::tie(std::get<1>(rhs), std::get<2>(rhs));
+  });
+
+  std::vector<bool> label_used(labels_.size(), false);
+  std::set<NodeId> rooms_used;
+  for (const auto& [overlap, label_idx, room_id] : candidates) {
+    if (label_used[label_idx] || rooms_used.count(room_id)) {
+      continue;
+    }
+
+    label_used[label_idx] = true;
+    rooms_used.insert(room_id);
+
+    auto& node = graph.getNode(room_id)->get();
+    auto& label = labels_[label_idx];
+    node.attributes<SemanticNodeAttributes>().name = label.name;
+    // track the room as it grows or shrinks between detections
+    label.footprint = node.children();
+  }
+
+  return rooms_used.size();
+}
+
+std::vector<RoomLabelStore::Label> RoomLabelStore::labels() const {
+  std::unique_lock<std::mutex> lock(labels_mutex_);
+  return labels_;
+}
+
+size_t RoomLabelStore::numLabels() const {
+  std::unique_lock<std::mutex> lock(labels_mutex_);
+  return labels_.size();
+}
+
+}  // namespace hydra
@@ -40,6 +40,7 @@
 #include <pcl/point_types.h>
 #include <spark_dsg/bounding_box_extraction.h>
 
+#include "hydra/backend/room_label_store.h"
 #include "hydra/rooms/room_finder.h"
 #include "hydra/utils/timing_utilities.h"
 
@@ -413,6 +414,9 @@ std::map<NodeId, NodeId> UpdateRoomsFunctor::call(SharedDsgInfo& dsg,
     std::unique_lock<std::mutex> lock(dsg.mutex);
     rewriteRooms(rooms.get(), *dsg.graph);
     room_finder->addRoomPlaceEdges(*dsg.graph);
+    if (room_labels) {
+      room_labels->apply(*dsg.graph);
+    }
   }  // end dsg critical section
 
   return {};
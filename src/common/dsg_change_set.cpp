@@ -0,0 +1,109 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/common/dsg_change_set.h"
+
+#include <glog/logging.h>
+
+namespace hydra {
+
+bool DsgChangeSet::empty() const { return size() == 0; }
+
+size_t DsgChangeSet::size() const {
+  return node_removals.size() + edge_removals.size() + node_upserts.size() +
+         edge_upserts.size() + edge_inserts.size() + patches.size();
+}
+
+void DsgChangeSet::clear() {
+  node_removals.clear();
+  edge_removals.clear();
+  node_upserts.clear();
+  edge_upserts.clear();
+  edge_inserts.clear();
+  patches.clear();
+}
+
+size_t DsgChangeSet::apply(DynamicSceneGraph& graph,
+                           const RemovalCallback& on_removal) {
+  size_t num_applied = 0;
+  for (const auto node_id : node_removals) {
+    const auto node = graph.getNode(node_id);
+    if (!node) {
+      continue;
+    }
+
+    if (on_removal) {
+      on_removal(*node);
+    }
+
+    num_applied += graph.removeNode(node_id);
+  }
+
+  for (const auto& [source, target] : edge_removals) {
+    num_applied += graph.removeEdge(source, target);
+  }
+
+  for (auto& upsert : node_upserts) {
+    num_applied +=
+        graph.addOrUpdateNode(upsert.layer, upsert.node, std::move(upsert.attrs));
+  }
+
+  for (auto& upsert : edge_upserts) {
+    num_applied +=
+        graph.addOrUpdateEdge(upsert.source, upsert.target, std::move(upsert.info));
+  }
+
+  for (const auto& [source, target] : edge_inserts) {
+    if (graph.hasEdge(source, target)) {
+      continue;
+    }
+
+    num_applied += graph.insertEdge(source, target);
+  }
+
+  for (const auto& [node_id, patch] : patches) {
+    const auto node = graph.getNode(node_id);
+    if (!node) {
+      continue;
+    }
+
+    patch(node->get().attributes());
+    ++num_applied;
+  }
+
+  VLOG(5) << "applied " << num_applied << " of " << size() << " staged changes";
+  return num_applied;
+}
+
+}  // namespace hydra
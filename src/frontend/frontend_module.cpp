@@ -41,12 +41,14 @@
 
 #include <fstream>
 
+#include "hydra/common/dsg_change_set.h"
 #include "hydra/common/hydra_config.h"
 #include "hydra/utils/timing_utilities.h"
 
 namespace hydra {
 
 using hydra::timing::ScopedTimer;
+using hydra::timing::TimedLock;
 using pose_graph_tools::PoseGraph;
 
 using LabelClusters = MeshSegmenter::LabelClusters;
@@ -237,7 +239,7 @@ void FrontendModule::updateMeshAndObjects(const ReconstructionOutput& input) {
     mesh_update->updateMesh(*dsg_->graph->getMeshVertices(),
                             mesh_timestamps_,
                             *dsg_->graph->getMeshFaces());
-    invalidateMeshEdges(*mesh_update);
+    invalidateMeshEdges(*mesh_update, input.timestamp_ns);
   }  // end timing scope
 
   LabelClusters object_clusters;
@@ -250,8 +252,10 @@ void FrontendModule::updateMeshAndObjects(const ReconstructionOutput& input) {
 
   {  // start dsg critical section
     ScopedTimer timer("frontend/object_graph_update", input.timestamp_ns);
-    std::unique_lock<std::mutex> lock(dsg_->mutex);
-    segmenter_->updateGraph(*dsg_->graph, object_clusters, input.timestamp_ns);
+    TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", input.timestamp_ns);
+    const auto archived =
+        segmenter_->updateGraph(*dsg_->graph, object_clusters, input.timestamp_ns);
+    lcd_input_->archived_objects.insert(archived.begin(), archived.end());
     addPlaceObjectEdges(input.timestamp_ns);
   }  // end dsg critical section
 
@@ -273,47 +277,53 @@ void FrontendModule::updateDeformationGraph(const ReconstructionOutput& input) {
   }
 }
 
-void FrontendModule::filterPlaces(const SceneGraphLayer& places,
-                                  NodeIdSet& objects_to_check,
-                                  NodeIdSet& active_places,
-                                  const NodeIdSet& active_neighborhood) {
-  // we grab connected components using the subgraph of all active places and all
-  // archived places that used to be a neighbor with an active place so that we don't
-  // miss disconnected components that comprised of archived nodes and formed when an
-  // active node or edge is removed. Limiting the connected component search to be
-  // within N hops of the subgraph, where N is the min allowable component size ensures
-  // that we don't search the entire places subgraph, but still preserve archived places
-  // that connect to a component of at least size N
-  const auto components = graph_utilities::getConnectedComponents(
-      places, config_.min_places_component_size, active_neighborhood);
-
+void FrontendModule::filterPlaces(NodeIdSet& active_places, DsgChangeSet& changes) {
+  // components can only shrink around nodes touched by the latest changes, so the
+  // search starts from those and stops once a component is large enough
+  const auto components =
+      place_connectivity_.popSmallComponents(config_.min_places_component_size);
   for (const auto& component : components) {
-    if (component.size() >= config_.min_places_component_size) {
-      continue;
-    }
-
     for (const auto to_delete : component) {
-      deletePlaceNode(to_delete, objects_to_check);
+      changes.node_removals.push_back(to_delete);
       active_places.erase(to_delete);
+      place_connectivity_.removeNode(to_delete);
     }
   }
 }
 
-void FrontendModule::deletePlaceNode(NodeId node_id, NodeIdSet& objects_to_check) {
-  const auto to_check = dsg_->graph->getNode(node_id);
-  if (!to_check) {
-    return;
+void FrontendModule::updatePlaceConnectivity(const DsgChangeSet& changes) {
+  for (const auto node : changes.node_removals) {
+    place_connectivity_.removeNode(node);
+  }
+
+  for (const auto& edge : changes.edge_removals) {
+    place_connectivity_.removeEdge(edge.first, edge.second);
+  }
+
+  // only mirror what actually made it into the layer
+  const auto& places = dsg_->graph->getLayer(DsgLayers::PLACES);
+  for (const auto& upsert : changes.node_upserts) {
+    if (places.hasNode(upsert.node)) {
+      place_connectivity_.addNode(upsert.node);
+    }
+  }
+
+  for (const auto& upsert : changes.edge_upserts) {
+    if (places.hasEdge(upsert.source, upsert.target)) {
+      place_connectivity_.addEdge(upsert.source, upsert.target);
+    }
   }
+}
 
-  for (const auto& child : to_check->get().children()) {
+void FrontendModule::handlePlaceRemoval(const SceneGraphNode& node,
+                                        NodeIdSet& objects_to_check) {
+  for (const auto& child : node.children()) {
     if (!dsg_->graph->isDynamic(child)) {
       objects_to_check.insert(child);
     } else {
       deleted_agent_edge_indices_.insert(child);
     }
   }
-
-  dsg_->graph->removeNode(node_id);
 }
 
 void FrontendModule::updatePlaces(const ReconstructionOutput& input) {
@@ -323,59 +333,65 @@ void FrontendModule::updatePlaces(const ReconstructionOutput& input) {
           << " edges from hydra_places";
 
   NodeIdSet active_nodes;
-  NodeIdSet active_neighborhood;
   for (const auto& id_attr_pair : input.places->active_attributes) {
     active_nodes.insert(id_attr_pair.first);
-    active_neighborhood.insert(id_attr_pair.first);
     id_attr_pair.second->is_active = true;
     id_attr_pair.second->last_update_time_ns = input.timestamp_ns;
   }
 
+  // This thread is the only writer of the places layer, so the layer can be read
+  // without the graph lock. Changes are staged and committed in short critical
+  // sections so that the backend and LCD are not blocked by the computation here.
   const auto& places = dsg_->graph->getLayer(DsgLayers::PLACES);
 
-  {  // start graph update critical section
-    std::unique_lock<std::mutex> graph_lock(dsg_->mutex);
-
-    NodeIdSet objects_to_check;
-    for (const auto& node_id : input.places->deleted_nodes) {
-      const auto node = dsg_->graph->getNode(node_id);
-      if (node) {
-        const auto& siblings = node->get().siblings();
-        active_neighborhood.insert(siblings.begin(), siblings.end());
-      }
-      deletePlaceNode(node_id, objects_to_check);
-    }
+  DsgChangeSet changes;
+  for (const auto& node_id : input.places->deleted_nodes) {
+    changes.node_removals.push_back(node_id);
+  }
 
-    const auto& deleted_edges = input.places->deleted_edges;
-    for (size_t i = 0; i < deleted_edges.size(); i += 2) {
-      const auto n1 = deleted_edges.at(i);
-      const auto n2 = deleted_edges.at(i + 1);
-      active_neighborhood.insert(n1);
-      active_neighborhood.insert(n2);
-      dsg_->graph->removeEdge(n1, n2);
-    }
+  const auto& deleted_edges = input.places->deleted_edges;
+  for (size_t i = 0; i < deleted_edges.size(); i += 2) {
+    const auto n1 = deleted_edges.at(i);
+    const auto n2 = deleted_edges.at(i + 1);
+    changes.edge_removals.emplace_back(n1, n2);
+  }
 
-    for (auto&& [node, attrs] : input.places->active_attributes) {
-      dsg_->graph->addOrUpdateNode(DsgLayers::PLACES, node, attrs->clone());
-    }
+  for (auto&& [node, attrs] : input.places->active_attributes) {
+    changes.node_upserts.push_back({DsgLayers::PLACES, node, attrs->clone()});
+  }
 
-    for (auto& edge : input.places->edges) {
-      dsg_->graph->addOrUpdateEdge(edge.source, edge.target, edge.info->clone());
-    }
+  for (auto& edge : input.places->edges) {
+    changes.edge_upserts.push_back({edge.source, edge.target, edge.info->clone()});
+  }
 
-    if (config_.filter_places) {
-      auto iter = active_neighborhood.begin();
-      while (iter != active_neighborhood.end()) {
-        if (places.hasNode(*iter)) {
-          ++iter;
-        } else {
-          iter = active_neighborhood.erase(iter);
-        }
-      }
-      filterPlaces(places, objects_to_check, active_nodes, active_neighborhood);
-    }
+  NodeIdSet objects_to_check;
+  const auto on_removal = [&](const SceneGraphNode& node) {
+    handlePlaceRemoval(node, objects_to_check);
+  };
 
-    places_nn_finder_.reset(new NearestNodeFinder(places, active_nodes));
+  {  // start graph update critical section
+    TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", input.timestamp_ns);
+    changes.apply(*dsg_->graph, on_removal);
+    // the finder refers to places that may have just been removed
+    places_nn_finder_.reset();
+  }  // end graph update critical section
+
+  if (config_.filter_places) {
+    updatePlaceConnectivity(changes);
+  }
+
+  changes.clear();
+  if (config_.filter_places) {
+    filterPlaces(active_nodes, changes);
+  }
+
+  // filtered places are no longer in the active set and are skipped by the finder
+  auto nn_finder = std::make_unique<NearestNodeFinder>(places, active_nodes);
+
+  {  // start graph update critical section
+    TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", input.timestamp_ns);
+    changes.apply(*dsg_->graph, on_removal);
+    places_nn_finder_ = std::move(nn_finder);
 
     addPlaceAgentEdges(input.timestamp_ns);
     addPlaceObjectEdges(input.timestamp_ns, &objects_to_check);
@@ -383,21 +399,28 @@ void FrontendModule::updatePlaces(const ReconstructionOutput& input) {
     state_->latest_places = active_nodes;
   }  // end graph update critical section
 
-  archivePlaces(active_nodes);
+  archivePlaces(active_nodes, input.timestamp_ns);
   previous_active_places_ = active_nodes;
 }
 
 void FrontendModule::updatePoseGraph(const ReconstructionOutput& input) {
-  std::unique_lock<std::mutex> lock(dsg_->mutex);
+  struct NewAgentNode {
+    NodeSymbol pgmo_key;
+    std::chrono::nanoseconds stamp;
+    std::unique_ptr<AgentNodeAttributes> attrs;
+  };
+
+  // this thread is the only writer of the agent layer, so new nodes are converted
+  // before taking the graph lock
   const auto& agents = dsg_->graph->getLayer(DsgLayers::AGENTS, prefix_.key);
-
-  lcd_input_->new_agent_nodes.clear();
+  std::vector<NewAgentNode> new_nodes;
   for (const auto& pose_graph : input.pose_graphs) {
     if (pose_graph->nodes.empty()) {
       continue;
     }
 
     for (const auto& node : pose_graph->nodes) {
+      // keys are checked against the emplaced nodes again once the graph is locked
       if (node.key < agents.numNodes()) {
         continue;
       }
@@ -412,130 +435,209 @@ void FrontendModule::updatePoseGraph(const ReconstructionOutput& input) {
       NodeSymbol pgmo_key(prefix_.key, node.key);
 
       const std::chrono::nanoseconds stamp(node.header.stamp.toNSec());
-      VLOG(5) << "[Hydra Frontend] Adding agent " << agents.nodes().size() << " @ "
-              << stamp.count() << " [ns] for layer " << agents.prefix.str()
-              << " (key: " << node.key << ")";
       auto attrs = std::make_unique<AgentNodeAttributes>(rotation, position, pgmo_key);
-      if (!dsg_->graph->emplaceNode(
-              agents.id, agents.prefix, stamp, std::move(attrs))) {
-        VLOG(1) << "[Hydra Frontend] repeated timestamp " << stamp.count()
-                << "[ns] found";
-        continue;
-      }
-
-      // TODO(nathan) save key association for lcd
-      const size_t last_index = agents.nodes().size() - 1;
-      agent_key_map_[pgmo_key] = last_index;
-      lcd_input_->new_agent_nodes.push_back(agents.prefix.makeId(last_index));
+      new_nodes.push_back({pgmo_key, stamp, std::move(attrs)});
     }
   }
 
-  addPlaceAgentEdges(input.timestamp_ns);
   if (config_.lcd_use_bow_vectors) {
-    assignBowVectors(agents);
+    queueBowVectors(input.timestamp_ns);
   }
-}
 
-void FrontendModule::assignBowVectors(const DynamicLayer& agents) {
-  // TODO(nathan) take care of synchronization better
-  // lcd_input_->new_agent_nodes.clear();
+  std::vector<NodeId> new_agent_keys;
+  TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", input.timestamp_ns);
+  lcd_input_->new_agent_nodes.clear();
+  for (auto& new_node : new_nodes) {
+    // nodes rejected for a repeated timestamp don't advance the expected key
+    if (new_node.pgmo_key.categoryId() < agents.numNodes()) {
+      continue;
+    }
 
-  // add bow messages received since last spin
-  while (!state_->visual_lcd_queue.empty()) {
-    cached_bow_messages_.push_back(state_->visual_lcd_queue.pop());
+    VLOG(5) << "[Hydra Frontend] Adding agent " << agents.nodes().size() << " @ "
+            << new_node.stamp.count() << " [ns] for layer " << agents.prefix.str()
+            << " (key: " << new_node.pgmo_key.categoryId() << ")";
+    if (!dsg_->graph->emplaceNode(
+            agents.id, agents.prefix, new_node.stamp, std::move(new_node.attrs))) {
+      VLOG(1) << "[Hydra Frontend] repeated timestamp " << new_node.stamp.count()
+              << "[ns] found";
+      continue;
+    }
+
+    // TODO(nathan) save key association for lcd
+    const size_t last_index = agents.nodes().size() - 1;
+    agent_key_map_[new_node.pgmo_key] = last_index;
+    new_agent_keys.push_back(new_node.pgmo_key);
+    lcd_input_->new_agent_nodes.push_back(agents.prefix.makeId(last_index));
   }
 
-  const auto prior_size = cached_bow_messages_.size();
+  addPlaceAgentEdges(input.timestamp_ns);
+  if (config_.lcd_use_bow_vectors) {
+    assignBowVectors(agents, new_agent_keys, input.timestamp_ns);
+  }
+}
 
-  auto iter = cached_bow_messages_.begin();
-  while (iter != cached_bow_messages_.end()) {
-    const auto& msg = *iter;
+void FrontendModule::queueBowVectors(uint64_t timestamp_ns) {
+  // messages are converted here (outside the graph lock) so that assignment only
+  // has to move the vectors into the agent attributes
+  while (!state_->visual_lcd_queue.empty()) {
+    const auto msg = state_->visual_lcd_queue.pop();
     if (static_cast<int>(msg->robot_id) != prefix_.id) {
       VLOG(1) << "[Hydra Frontend] rejected bow message from robot " << msg->robot_id;
-      iter = cached_bow_messages_.erase(iter);
+      continue;
     }
 
     const NodeSymbol pgmo_key(prefix_.key, msg->pose_id);
+    const auto& word_ids = msg->bow_vector.word_ids;
+    const auto& word_values = msg->bow_vector.word_values;
 
-    auto agent_index = agent_key_map_.find(pgmo_key);
-    if (agent_index == agent_key_map_.end()) {
-      ++iter;
-      continue;
+    auto& pending = pending_bow_vectors_[pgmo_key];
+    pending.received_ns = timestamp_ns;
+    pending.ids = Eigen::Map<const AgentNodeAttributes::BowIdVector>(word_ids.data(),
+                                                                     word_ids.size());
+    pending.values =
+        Eigen::Map<const Eigen::VectorXf>(word_values.data(), word_values.size());
+    if (config_.bow_expiry_s > 0.0) {
+      bow_expiry_queue_.emplace_back(pgmo_key, timestamp_ns);
     }
 
-    const auto& node = agents.getNodeByIndex(agent_index->second)->get();
-    VLOG(5) << "[Hydra Frontend] assigned bow vector of " << pgmo_key.getLabel()
-            << " to dsg node " << NodeSymbol(node.id).getLabel();
-    // lcd_input_->new_agent_nodes.push_back(node.id);
+    received_bow_keys_.push_back(pgmo_key);
+  }
+}
 
-    auto& attrs = node.attributes<AgentNodeAttributes>();
-    attrs.dbow_ids = Eigen::Map<const AgentNodeAttributes::BowIdVector>(
-        msg->bow_vector.word_ids.data(), msg->bow_vector.word_ids.size());
-    attrs.dbow_values = Eigen::Map<const Eigen::VectorXf>(
-        msg->bow_vector.word_values.data(), msg->bow_vector.word_values.size());
+bool FrontendModule::assignBowVector(const DynamicLayer& agents, NodeId pgmo_key) {
+  auto pending = pending_bow_vectors_.find(pgmo_key);
+  if (pending == pending_bow_vectors_.end()) {
+    return false;
+  }
 
-    iter = cached_bow_messages_.erase(iter);
+  auto agent_index = agent_key_map_.find(pgmo_key);
+  if (agent_index == agent_key_map_.end()) {
+    return false;
   }
 
-  size_t num_assigned = prior_size - cached_bow_messages_.size();
-  VLOG(3) << "[Hydra Frontend] assigned " << num_assigned << " bow vectors of "
-          << prior_size << " original";
+  const auto& node = agents.getNodeByIndex(agent_index->second)->get();
+  VLOG(5) << "[Hydra Frontend] assigned bow vector of "
+          << NodeSymbol(pgmo_key).getLabel() << " to dsg node "
+          << NodeSymbol(node.id).getLabel();
+
+  auto& attrs = node.attributes<AgentNodeAttributes>();
+  attrs.dbow_ids = std::move(pending->second.ids);
+  attrs.dbow_values = std::move(pending->second.values);
+  pending_bow_vectors_.erase(pending);
+  return true;
 }
 
-void FrontendModule::invalidateMeshEdges(const kimera_pgmo::MeshDelta& delta) {
-  std::unique_lock<std::mutex> lock(dsg_->mutex);
+void FrontendModule::assignBowVectors(const DynamicLayer& agents,
+                                      const std::vector<NodeId>& new_agent_keys,
+                                      uint64_t timestamp_ns) {
+  // only vectors or agents that are new since the last call can produce a match
+  size_t num_assigned = 0;
+  for (const auto pgmo_key : received_bow_keys_) {
+    num_assigned += assignBowVector(agents, pgmo_key) ? 1 : 0;
+  }
+  received_bow_keys_.clear();
+
+  for (const auto pgmo_key : new_agent_keys) {
+    num_assigned += assignBowVector(agents, pgmo_key) ? 1 : 0;
+  }
+
+  size_t num_expired = 0;
+  const auto expiry_ns = static_cast<uint64_t>(config_.bow_expiry_s * 1.0e9);
+  while (!bow_expiry_queue_.empty()) {
+    const auto& [pgmo_key, received_ns] = bow_expiry_queue_.front();
+    if (received_ns + expiry_ns > timestamp_ns) {
+      break;
+    }
+
+    // entries may have already been assigned or replaced by a newer message
+    auto pending = pending_bow_vectors_.find(pgmo_key);
+    if (pending != pending_bow_vectors_.end() &&
+        pending->second.received_ns == received_ns) {
+      pending_bow_vectors_.erase(pending);
+      ++num_expired;
+    }
 
-  std::vector<NodeId> objects_to_delete;
+    bow_expiry_queue_.pop_front();
+  }
+
+  VLOG(3) << "[Hydra Frontend] assigned " << num_assigned << " bow vectors ("
+          << num_expired << " expired, " << pending_bow_vectors_.size() << " pending)";
+}
+
+void FrontendModule::invalidateMeshEdges(const kimera_pgmo::MeshDelta& delta,
+                                         uint64_t timestamp_ns) {
+  // this thread is the only writer of the object layer, so connections are remapped
+  // before taking the graph lock
+  DsgChangeSet changes;
   const auto& objects = dsg_->graph->getLayer(DsgLayers::OBJECTS);
   for (const auto& id_node_pair : objects.nodes()) {
-    auto& attrs = id_node_pair.second->attributes<ObjectNodeAttributes>();
-
-    auto iter = attrs.mesh_connections.begin();
-    while (iter != attrs.mesh_connections.end()) {
-      if (delta.deleted_indices.count(*iter)) {
-        iter = attrs.mesh_connections.erase(iter);
+    const auto& attrs = id_node_pair.second->attributes<ObjectNodeAttributes>();
+
+    bool changed = false;
+    std::decay_t<decltype(attrs.mesh_connections)> connections;
+    connections.reserve(attrs.mesh_connections.size());
+    for (const auto idx : attrs.mesh_connections) {
+      if (delta.deleted_indices.count(idx)) {
+        changed = true;
         continue;
       }
 
-      auto map_iter = delta.prev_to_curr.find(*iter);
-      if (map_iter != delta.prev_to_curr.end()) {
-        *iter = map_iter->second;
+      auto map_iter = delta.prev_to_curr.find(idx);
+      if (map_iter == delta.prev_to_curr.end()) {
+        connections.push_back(idx);
+      } else {
+        changed |= map_iter->second != idx;
+        connections.push_back(map_iter->second);
       }
+    }
 
-      ++iter;
+    if (connections.size() < config_.min_object_vertices) {
+      changes.node_removals.push_back(id_node_pair.first);
+      continue;
     }
 
-    if (attrs.mesh_connections.size() < config_.min_object_vertices) {
-      objects_to_delete.push_back(id_node_pair.first);
+    if (!changed) {
+      continue;
     }
+
+    changes.patches.emplace_back(
+        id_node_pair.first,
+        [connections = std::move(connections)](NodeAttributes& attrs) mutable {
+          auto& object_attrs = dynamic_cast<ObjectNodeAttributes&>(attrs);
+          object_attrs.mesh_connections = std::move(connections);
+        });
   }
 
-  for (const auto& node : objects_to_delete) {
-    dsg_->graph->removeNode(node);
+  if (changes.empty()) {
+    return;
   }
+
+  TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", timestamp_ns);
+  changes.apply(*dsg_->graph);
 }
 
-void FrontendModule::archivePlaces(const NodeIdSet active_places) {
-  {  // start graph update critical section
-    std::unique_lock<std::mutex> graph_lock(dsg_->mutex);
+void FrontendModule::archivePlaces(const NodeIdSet active_places,
+                                   uint64_t timestamp_ns) {
+  const auto& places = dsg_->graph->getLayer(DsgLayers::PLACES);
 
-    // find node ids that are valid, but outside active place window
-    for (const auto& prev : previous_active_places_) {
-      if (active_places.count(prev)) {
-        continue;
-      }
+  // find node ids that are valid, but outside active place window
+  DsgChangeSet changes;
+  for (const auto& prev : previous_active_places_) {
+    if (active_places.count(prev) || !places.hasNode(prev)) {
+      continue;
+    }
 
-      const auto has_prev_node = dsg_->graph->getNode(prev);
-      if (!has_prev_node) {
-        continue;
-      }
+    changes.patches.emplace_back(
+        prev, [](NodeAttributes& attrs) { attrs.is_active = false; });
+    lcd_input_->archived_places.insert(prev);
+  }
 
-      const SceneGraphNode& prev_node = has_prev_node.value();
-      prev_node.attributes().is_active = false;
-      lcd_input_->archived_places.insert(prev);
-    }
+  if (changes.empty()) {
+    return;
+  }
 
-  }  // end graph update critical section
+  TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", timestamp_ns);
+  changes.apply(*dsg_->graph);
 }
 
 void FrontendModule::addPlaceObjectEdges(uint64_t timestamp_ns,
@@ -551,9 +653,12 @@ void FrontendModule::addPlaceObjectEdges(uint64_t timestamp_ns,
                             extra_objects_to_check->end());
   }
 
+  std::vector<NodeId> resolved;
   for (const auto& object_id : objects_to_check) {
     const auto object_opt = dsg_->graph->getNode(object_id);
     if (!object_opt) {
+      // objects of deleted places can be gone already
+      resolved.push_back(object_id);
       continue;
     }
 
@@ -566,11 +671,13 @@ void FrontendModule::addPlaceObjectEdges(uint64_t timestamp_ns,
     const Eigen::Vector3d object_position = dsg_->graph->getPosition(object_id);
     places_nn_finder_->find(
         object_position, 1, false, [&](NodeId place_id, size_t, double) {
-          dsg_->graph->insertEdge(place_id, object_id);
+          if (dsg_->graph->insertEdge(place_id, object_id)) {
+            resolved.push_back(object_id);
+          }
         });
   }
 
-  segmenter_->pruneObjectsToCheckForPlaces(*dsg_->graph);
+  segmenter_->pruneObjectsToCheckForPlaces(resolved);
 }
 
 void FrontendModule::addPlaceAgentEdges(uint64_t timestamp_ns) {
@@ -651,12 +758,20 @@ size_t remapConnections(const kimera_pgmo::VoxbloxIndexMapping& remapping,
 }
 
 using MeshIndexMap = voxblox::AnyIndexHashMapType<size_t>::type;
+using PlaceLabels = decltype(PlaceNodeAttributes::mesh_vertex_labels);
+
+struct PlaceMeshMapping {
+  std::vector<size_t> deformation_connections;
+  std::vector<size_t> pcl_mesh_connections;
+  PlaceLabels mesh_vertex_labels;
+};
 
 size_t getPlaceSemanticLabels(const voxblox::MeshLayer& mesh,
                               const voxblox::IndexSet& archived_blocks,
                               const voxblox::IndexSet& allocated_blocks,
                               const kimera::SemanticLabel2Color& label_map,
-                              PlaceNodeAttributes& attrs) {
+                              const PlaceNodeAttributes& attrs,
+                              PlaceLabels& labels) {
   size_t num_invalid = 0;
   for (const auto& connection : attrs.voxblox_mesh_connections) {
     voxblox::BlockIndex idx = Eigen::Map<const voxblox::BlockIndex>(connection.block);
@@ -676,14 +791,15 @@ size_t getPlaceSemanticLabels(const voxblox::MeshLayer& mesh,
     }
 
     const kimera::HashableColor color(block->colors.at(connection.vertex));
-    attrs.mesh_vertex_labels.push_back(label_map.getSemanticLabelFromColor(color));
+    labels.push_back(label_map.getSemanticLabelFromColor(color));
   }
 
   return num_invalid;
 }
 
 void FrontendModule::updatePlaceMeshMapping(const ReconstructionOutput& input) {
-  std::unique_lock<std::mutex> lock(dsg_->mutex);
+  // runs after all other frontend updates, so nothing else modifies the graph while
+  // the new mappings are computed
   const auto& places = dsg_->graph->getLayer(DsgLayers::PLACES);
   const auto& graph_mapping = mesh_frontend_.getVoxbloxMsgToGraphMapping();
 
@@ -696,8 +812,9 @@ void FrontendModule::updatePlaceMeshMapping(const ReconstructionOutput& input) {
   size_t num_deform_invalid = 0;
   size_t num_mesh_invalid = 0;
   size_t num_semantic_invalid = 0;
+  DsgChangeSet changes;
   for (const auto& id_node_pair : places.nodes()) {
-    auto& attrs = id_node_pair.second->attributes<PlaceNodeAttributes>();
+    const auto& attrs = id_node_pair.second->attributes<PlaceNodeAttributes>();
     if (!attrs.is_active) {
       continue;
     }
@@ -707,25 +824,40 @@ void FrontendModule::updatePlaceMeshMapping(const ReconstructionOutput& input) {
       continue;
     }
 
-    // reset connections
-    attrs.deformation_connections.clear();
-    attrs.pcl_mesh_connections.clear();
-    attrs.mesh_vertex_labels.clear();
+    PlaceMeshMapping mapping;
     num_deform_invalid += remapConnections(graph_mapping,
                                            input.archived_blocks,
                                            attrs.voxblox_mesh_connections,
-                                           attrs.deformation_connections);
+                                           mapping.deformation_connections);
     if (mesh_remapping_) {
       num_mesh_invalid += remapConnections(*mesh_remapping_,
                                            input.archived_blocks,
                                            attrs.voxblox_mesh_connections,
-                                           attrs.pcl_mesh_connections);
-    }
-
-    num_semantic_invalid += getPlaceSemanticLabels(
-        *input.mesh, input.archived_blocks, allocated, *label_map_, attrs);
+                                           mapping.pcl_mesh_connections);
+    }
+
+    num_semantic_invalid += getPlaceSemanticLabels(*input.mesh,
+                                                   input.archived_blocks,
+                                                   allocated,
+                                                   *label_map_,
+                                                   attrs,
+                                                   mapping.mesh_vertex_labels);
+
+    changes.patches.emplace_back(
+        id_node_pair.first,
+        [mapping = std::move(mapping)](NodeAttributes& node_attrs) mutable {
+          auto& place_attrs = dynamic_cast<PlaceNodeAttributes&>(node_attrs);
+          place_attrs.deformation_connections.swap(mapping.deformation_connections);
+          place_attrs.pcl_mesh_connections.swap(mapping.pcl_mesh_connections);
+          place_attrs.mesh_vertex_labels.swap(mapping.mesh_vertex_labels);
+        });
   }
 
+  {  // start graph update critical section
+    TimedLock lock(dsg_->mutex, "frontend/shared_dsg_lock", input.timestamp_ns);
+    changes.apply(*dsg_->graph);
+  }  // end graph update critical section
+
   if (config_.validate_vertices) {
     CHECK_EQ(num_deform_invalid, 0u);
     CHECK_EQ(num_mesh_invalid, 0u);
@@ -209,49 +209,43 @@ LabelClusters MeshSegmenter::detect(const SemanticLabel2Color& label_map,
   return label_clusters;
 }
 
-void MeshSegmenter::pruneObjectsToCheckForPlaces(const DynamicSceneGraph& graph) {
-  std::list<NodeId> to_remove;
-  for (const auto& object_id : objects_to_check_for_places_) {
-    if (!graph.hasNode(object_id)) {
-      LOG(ERROR) << "Missing node " << NodeSymbol(object_id).getLabel();
-      to_remove.push_back(object_id);
-      continue;
-    }
-
-    if (graph.getNode(object_id).value().get().hasParent()) {
-      to_remove.push_back(object_id);
-    }
-  }
-
-  for (const auto& node_id : to_remove) {
+void MeshSegmenter::pruneObjectsToCheckForPlaces(const std::vector<NodeId>& resolved) {
+  for (const auto node_id : resolved) {
     objects_to_check_for_places_.erase(node_id);
   }
 }
 
 std::set<NodeId> MeshSegmenter::archiveOldObjects(const DynamicSceneGraph& graph,
                                                   uint64_t latest_timestamp) {
+  const auto horizon_ns = static_cast<uint64_t>(config_.active_horizon_s * 1e9);
+
   std::set<NodeId> archived = {};
-  for (const auto& label : config_.labels) {
-    std::list<NodeId> removed_nodes;
-    for (const auto& object_node : active_objects_.at(label)) {
-      if (!graph.hasNode(object_node)) {
-        removed_nodes.push_back(object_node);
-        continue;
-      }
+  while (!expiry_queue_.empty()) {
+    const auto [queued_ns, node_id] = expiry_queue_.top();
+    if (latest_timestamp < queued_ns || latest_timestamp - queued_ns <= horizon_ns) {
+      break;  // nothing older is queued
+    }
 
-      const uint64_t diff_ns =
-          latest_timestamp - active_object_timestamps_.at(object_node);
-      if (diff_ns > static_cast<uint64_t>(config_.active_horizon_s * 1e9)) {
-        removed_nodes.push_back(object_node);
-        archived.insert(object_node);
-        graph.getNode(object_node)->get().attributes().is_active = false;
-      }
+    expiry_queue_.pop();
+    auto iter = active_object_info_.find(node_id);
+    if (iter == active_object_info_.end()) {
+      continue;
     }
 
-    for (const auto& node_id : removed_nodes) {
-      active_objects_[label].erase(node_id);
-      active_object_timestamps_.erase(node_id);
+    // objects seen since they were queued are requeued with their latest time
+    if (iter->second.last_seen_ns != queued_ns) {
+      expiry_queue_.emplace(iter->second.last_seen_ns, node_id);
+      continue;
     }
+
+    active_objects_[iter->second.label].erase(node_id);
+    active_object_info_.erase(iter);
+    if (!graph.hasNode(node_id)) {
+      continue;
+    }
+
+    archived.insert(node_id);
+    graph.getNode(node_id)->get().attributes().is_active = false;
   }
 
   return archived;
@@ -309,7 +303,12 @@ std::set<NodeId> MeshSegmenter::updateGraph(DynamicSceneGraph& graph,
       bool matches_prev_object = false;
       std::vector<NodeId> nodes_not_in_graph;
       for (const auto& prev_node_id : active_objects_.at(label_clusters.first)) {
-        const SceneGraphNode& prev_node = graph.getNode(prev_node_id).value();
+        const auto prev_opt = graph.getNode(prev_node_id);
+        if (!prev_opt) {
+          continue;  // removed objects are dropped once they expire
+        }
+
+        const SceneGraphNode& prev_node = *prev_opt;
         if (objectsMatch(cluster, prev_node)) {
           updateObjectInGraph(cluster, prev_node, timestamp);
           matches_prev_object = true;
@@ -331,7 +330,7 @@ std::set<NodeId> MeshSegmenter::updateGraph(DynamicSceneGraph& graph,
 void MeshSegmenter::updateObjectInGraph(const Cluster& cluster,
                                         const SceneGraphNode& node,
                                         uint64_t timestamp) {
-  active_object_timestamps_.at(node.id) = timestamp;
+  active_object_info_.at(node.id).last_seen_ns = timestamp;
 
   ObjectNodeAttributes& attrs = node.attributes<ObjectNodeAttributes>();
   mergeList(attrs.mesh_connections, cluster.indices.indices);
@@ -387,7 +386,8 @@ void MeshSegmenter::addObjectToGraph(DynamicSceneGraph& graph,
   graph.emplaceNode(DsgLayers::OBJECTS, next_node_id_, std::move(attrs));
 
   active_objects_.at(label).insert(next_node_id_);
-  active_object_timestamps_[next_node_id_] = timestamp;
+  active_object_info_[next_node_id_] = {label, timestamp};
+  expiry_queue_.emplace(timestamp, next_node_id_);
   objects_to_check_for_places_.insert(next_node_id_);
 
   ++next_node_id_;
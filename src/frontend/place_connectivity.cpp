@@ -0,0 +1,151 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/frontend/place_connectivity.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace hydra {
+
+PlaceConnectivity::PlaceConnectivity() : num_edges_(0) {}
+
+bool PlaceConnectivity::addNode(NodeId node) {
+  if (!adjacency_.emplace(node, std::unordered_set<NodeId>()).second) {
+    return false;
+  }
+
+  changed_.insert(node);
+  return true;
+}
+
+bool PlaceConnectivity::removeNode(NodeId node) {
+  auto iter = adjacency_.find(node);
+  if (iter == adjacency_.end()) {
+    return false;
+  }
+
+  for (const auto neighbor : iter->second) {
+    adjacency_.at(neighbor).erase(node);
+    changed_.insert(neighbor);
+  }
+
+  num_edges_ -= iter->second.size();
+  adjacency_.erase(iter);
+  changed_.erase(node);
+  return true;
+}
+
+bool PlaceConnectivity::addEdge(NodeId source, NodeId target) {
+  if (source == target) {
+    return false;
+  }
+
+  auto source_iter = adjacency_.find(source);
+  auto target_iter = adjacency_.find(target);
+  if (source_iter == adjacency_.end() || target_iter == adjacency_.end()) {
+    return false;
+  }
+
+  if (!source_iter->second.insert(target).second) {
+    return false;
+  }
+
+  target_iter->second.insert(source);
+  ++num_edges_;
+  return true;
+}
+
+bool PlaceConnectivity::removeEdge(NodeId source, NodeId target) {
+  auto source_iter = adjacency_.find(source);
+  if (source_iter == adjacency_.end() || !source_iter->second.erase(target)) {
+    return false;
+  }
+
+  adjacency_.at(target).erase(source);
+  --num_edges_;
+  changed_.insert(source);
+  changed_.insert(target);
+  return true;
+}
+
+bool PlaceConnectivity::hasNode(NodeId node) const { return adjacency_.count(node); }
+
+bool PlaceConnectivity::hasEdge(NodeId source, NodeId target) const {
+  auto iter = adjacency_.find(source);
+  return iter != adjacency_.end() && iter->second.count(target);
+}
+
+std::vector<std::vector<NodeId>> PlaceConnectivity::popSmallComponents(
+    size_t min_size) {
+  std::vector<std::vector<NodeId>> small_components;
+  std::unordered_set<NodeId> checked;
+  for (const auto seed : changed_) {
+    if (checked.count(seed)) {
+      continue;
+    }
+
+    // the component doubles as the search queue
+    std::vector<NodeId> component{seed};
+    std::unordered_set<NodeId> visited{seed};
+    for (size_t head = 0; head < component.size() && component.size() < min_size;
+         ++head) {
+      for (const auto neighbor : adjacency_.at(component[head])) {
+        if (!visited.insert(neighbor).second) {
+          continue;
+        }
+
+        component.push_back(neighbor);
+        if (component.size() >= min_size) {
+          break;
+        }
+      }
+    }
+
+    // every visited node shares the seed's component (and its verdict)
+    checked.insert(component.begin(), component.end());
+    if (component.size() < min_size) {
+      std::sort(component.begin(), component.end());
+      small_components.push_back(std::move(component));
+    }
+  }
+
+  VLOG(5) << "[Place Connectivity] Checked " << checked.size() << " nodes from "
+          << changed_.size() << " changed nodes";
+  changed_.clear();
+  return small_components;
+}
+
+}  // namespace hydra
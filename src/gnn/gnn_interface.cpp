@@ -36,39 +36,60 @@
 
 #include <glog/logging.h>
 
+#include "hydra/gnn/ort_runtime.h"
 #include "hydra/gnn/ort_utilities.h"
+#include "hydra/utils/resource_pool.h"
 
 namespace hydra {
 namespace gnn {
 
+struct BindingWorkspace {
+  explicit BindingWorkspace(Ort::Session& session) : binding(session) {}
+
+  Ort::IoBinding binding;
+  std::vector<std::vector<int64_t>> shapes;
+  std::vector<Tensor> buffers;
+};
+
 struct GnnInterfaceImpl {
   explicit GnnInterfaceImpl(const std::string& model_path)
-      : GnnInterfaceImpl(model_path, {}) {}
+      : GnnInterfaceImpl(model_path, {}, {}) {}
 
-  GnnInterfaceImpl(const std::string& model_path, const DynamicIndexMap& output_map)
+  GnnInterfaceImpl(const std::string& model_path,
+                   const DynamicIndexMap& output_map,
+                   const SessionConfig& config)
       : model_path(model_path),
         output_map(output_map),
         mem_info(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator,
-                                            OrtMemType::OrtMemTypeDefault)) {
-    env.reset(new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "hydra_gnn_interface"));
-    Ort::SessionOptions options;
-    options.SetIntraOpNumThreads(1).SetInterOpNumThreads(1);
-    session.reset(new Ort::Session(*env, model_path.c_str(), options));
-    allocator.reset(new Ort::AllocatorWithDefaultOptions());
-    mem_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator,
-                                          OrtMemType::OrtMemTypeDefault);
-
-    inputs = getSessionInputs(session.get(), *allocator);
+                                            OrtMemType::OrtMemTypeDefault)),
+        workspaces([this] { return makeWorkspace(); }) {
+    auto& runtime = OrtRuntime::instance();
+    session = runtime.getSession(model_path, config);
+    if (config.cache_optimized_model) {
+      optimized_model_path = getOptimizedModelPath(model_path, config);
+    }
+
+    inputs = getSessionInputs(session.get(), runtime.allocator());
     for (const auto& input : inputs) {
       input_names.push_back(input.name.c_str());
     }
 
-    outputs = getSessionOutputs(session.get(), *allocator);
+    outputs = getSessionOutputs(session.get(), runtime.allocator());
     for (const auto& output : outputs) {
       output_names.push_back(output.name.c_str());
     }
   }
 
+  std::unique_ptr<BindingWorkspace> makeWorkspace() const {
+    auto workspace = std::make_unique<BindingWorkspace>(*session);
+    workspace->shapes.resize(outputs.size());
+    for (const auto& output : outputs) {
+      workspace->buffers.emplace_back(output.getTensorType());
+    }
+
+    return workspace;
+  }
+
   TensorMap operator()(const TensorMap& tensors,
                        const std::vector<int64_t>& output_dimensions) const {
     std::vector<Ort::Value> input_values;
@@ -110,6 +131,86 @@ struct GnnInterfaceImpl {
     return tensor_outputs;
   }
 
+  void run(const TensorMap& tensors,
+           const std::string& output_name,
+           float* output,
+           size_t output_size,
+           const std::vector<int64_t>& output_dimensions,
+           Eigen::VectorXf* output_vec = nullptr) const {
+    // each concurrent caller binds through its own workspace and shares the session
+    auto workspace = workspaces.acquire();
+    auto& binding = workspace->binding;
+    binding.ClearBoundInputs();
+    binding.ClearBoundOutputs();
+
+    for (const auto& input : inputs) {
+      const auto iter = tensors.find(input.name);
+      if (iter == tensors.end()) {
+        std::stringstream ss;
+        ss << "missing input " << input.name << " from provided input tensors!";
+        throw std::invalid_argument(ss.str());
+      }
+
+      binding.BindInput(input.name.c_str(), input.makeOrtValue(mem_info, iter->second));
+    }
+
+    static const std::vector<size_t> no_dynamic_dims;
+    bool found_output = false;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      const auto& info = outputs[i];
+      const auto iter = output_map.find(info.name);
+      auto& shape = workspace->shapes[i];
+      info.getShape(iter == output_map.end() ? no_dynamic_dims : iter->second,
+                    output_dimensions,
+                    shape);
+
+      if (info.name != output_name) {
+        auto& buffer = workspace->buffers[i];
+        buffer.resize(shape);
+        binding.BindOutput(info.name.c_str(), info.makeOrtValue(mem_info, buffer));
+        continue;
+      }
+
+      if (info.type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        std::stringstream ss;
+        ss << "output " << info.name << " has type " << info.type_name
+           << " instead of float";
+        throw std::invalid_argument(ss.str());
+      }
+
+      size_t size = 1;
+      for (const auto dim : shape) {
+        size *= dim;
+      }
+
+      if (output_vec) {
+        output_vec->resize(size);
+        output = output_vec->data();
+        output_size = size;
+      }
+
+      if (!output || output_size != size) {
+        std::stringstream ss;
+        ss << "output " << info.name << " requires " << size << " elements (provided "
+           << output_size << ")";
+        throw std::invalid_argument(ss.str());
+      }
+
+      auto value = Ort::Value::CreateTensor<float>(
+          mem_info, output, output_size, shape.data(), shape.size());
+      binding.BindOutput(info.name.c_str(), value);
+      found_output = true;
+    }
+
+    if (!found_output) {
+      std::stringstream ss;
+      ss << "model does not have output " << output_name;
+      throw std::invalid_argument(ss.str());
+    }
+
+    session->Run(Ort::RunOptions(nullptr), binding);
+  }
+
   std::string model_path;
 
   std::vector<FieldInfo> inputs;
@@ -119,14 +220,17 @@ struct GnnInterfaceImpl {
 
   DynamicIndexMap output_map;
 
-  std::unique_ptr<Ort::Env> env;
-  std::unique_ptr<Ort::AllocatorWithDefaultOptions> allocator;
-  std::unique_ptr<Ort::Session> session;
+  std::string optimized_model_path;
+  OrtRuntime::SessionPtr session;
   Ort::MemoryInfo mem_info;
+  mutable ResourcePool<BindingWorkspace> workspaces;
 };
 
 std::ostream& operator<<(std::ostream& out, const GnnInterfaceImpl& impl) {
   out << "model_path: " << impl.model_path << std::endl;
+  if (!impl.optimized_model_path.empty()) {
+    out << "optimized_model_path: " << impl.optimized_model_path << std::endl;
+  }
 
   out << "inputs: " << std::endl;
   for (const auto& input : impl.inputs) {
@@ -159,9 +263,10 @@ GnnInterface::GnnInterface(const std::string& model_path)
     : GnnInterface(model_path, {}) {}
 
 GnnInterface::GnnInterface(const std::string& model_path,
-                           const DynamicIndexMap& output_map)
+                           const DynamicIndexMap& output_map,
+                           const SessionConfig& config)
     : model_path_(model_path) {
-  impl_.reset(new GnnInterfaceImpl(model_path, output_map));
+  impl_.reset(new GnnInterfaceImpl(model_path, output_map, config));
 }
 
 GnnInterface::~GnnInterface() {}
@@ -180,6 +285,21 @@ TensorMap GnnInterface::operator()(const TensorMap& input,
   return (*impl_)(input, output_sizes);
 }
 
+void GnnInterface::operator()(const TensorMap& input,
+                              const std::string& output_name,
+                              float* output,
+                              size_t output_size,
+                              const std::vector<int64_t>& output_sizes) const {
+  impl_->run(input, output_name, output, output_size, output_sizes);
+}
+
+void GnnInterface::operator()(const TensorMap& input,
+                              const std::string& output_name,
+                              Eigen::VectorXf& output,
+                              const std::vector<int64_t>& output_sizes) const {
+  impl_->run(input, output_name, nullptr, 0, output_sizes, &output);
+}
+
 std::ostream& operator<<(std::ostream& out, const GnnInterface& gnn) {
   out << "providers: ";
   const auto providers = Ort::GetAvailableProviders();
@@ -32,14 +32,165 @@
  * Government is authorized to reproduce and distribute reprints for Government
  * purposes notwithstanding any copyright notation herein.
  * -------------------------------------------------------------------------- */
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
 
 #include "hydra/gnn/gnn_interface.h"
+#include "hydra/gnn/tensor_io.h"
+
+DEFINE_int32(optimization_level, 99, "graph optimization level (0, 1, 2 or 99)");
+DEFINE_bool(cache_optimized_model, false, "save and reuse the optimized model");
+DEFINE_string(optimized_model_dir, "", "directory for the optimized model");
+DEFINE_string(corpus_dir, "", "directory of stored subgraph inputs (*.tensors)");
+DEFINE_string(compare_model, "", "model (e.g., int8-quantized) to validate against");
+DEFINE_string(output_name, "output", "model output to compare");
+DEFINE_int32(top_k, 5, "number of retrieved subgraphs for recall");
+DEFINE_bool(use_l1_score, false, "use L1 instead of cosine score for retrieval");
 
 using EdgeIndex = Eigen::Matrix<int64_t, Eigen::Dynamic, Eigen::Dynamic>;
 
+using hydra::gnn::GnnInterface;
+using hydra::gnn::TensorMap;
+using Embeddings = std::vector<Eigen::VectorXf>;
+
+std::vector<TensorMap> loadCorpus(const std::string& corpus_dir) {
+  std::vector<std::string> files;
+  for (const auto& entry : std::filesystem::directory_iterator(corpus_dir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".tensors") {
+      files.push_back(entry.path().string());
+    }
+  }
+
+  std::sort(files.begin(), files.end());
+  std::vector<TensorMap> corpus;
+  for (const auto& filename : files) {
+    corpus.push_back(hydra::gnn::loadTensorMap(filename));
+  }
+
+  return corpus;
+}
+
+double computeEmbeddings(const GnnInterface& model,
+                         const std::vector<TensorMap>& corpus,
+                         Embeddings& embeddings) {
+  embeddings.resize(corpus.size());
+  if (corpus.empty()) {
+    return 0.0;
+  }
+
+  // first inference includes lazy initialization inside onnxruntime
+  model(corpus.front(), FLAGS_output_name, embeddings.front());
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < corpus.size(); ++i) {
+    model(corpus[i], FLAGS_output_name, embeddings[i]);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count() / corpus.size();
+}
+
+float computeScore(const Eigen::VectorXf& lhs, const Eigen::VectorXf& rhs) {
+  if (FLAGS_use_l1_score) {
+    const float lhs_norm = lhs.lpNorm<1>();
+    const float rhs_norm = rhs.lpNorm<1>();
+    if (lhs_norm == 0.0f || rhs_norm == 0.0f) {
+      return -2.0f;
+    }
+
+    return -(lhs / lhs_norm - rhs / rhs_norm).lpNorm<1>();
+  }
+
+  const float norm = lhs.norm() * rhs.norm();
+  return norm == 0.0f ? -1.0f : lhs.dot(rhs) / norm;
+}
+
+std::vector<size_t> getTopK(const Eigen::VectorXf& query,
+                            size_t query_index,
+                            const Embeddings& database,
+                            size_t k) {
+  std::vector<std::pair<float, size_t>> scores;
+  for (size_t i = 0; i < database.size(); ++i) {
+    if (i != query_index) {
+      scores.emplace_back(computeScore(query, database[i]), i);
+    }
+  }
+
+  k = std::min(k, scores.size());
+  const auto better = [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+  };
+  std::partial_sort(scores.begin(), scores.begin() + k, scores.end(), better);
+
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < k; ++i) {
+    indices.push_back(scores[i].second);
+  }
+
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+void validateModel(const GnnInterface& reference,
+                   const GnnInterface& model,
+                   const std::vector<TensorMap>& corpus) {
+  Embeddings ref_embeddings;
+  Embeddings embeddings;
+  const double ref_time_s = computeEmbeddings(reference, corpus, ref_embeddings);
+  const double time_s = computeEmbeddings(model, corpus, embeddings);
+
+  const size_t k = FLAGS_top_k;
+  double total_similarity = 0.0;
+  float max_error = 0.0f;
+  double total_recall = 0.0;
+  size_t num_self_matches = 0;
+  for (size_t i = 0; i < corpus.size(); ++i) {
+    const auto& ref = ref_embeddings[i];
+    const auto& embedding = embeddings[i];
+    CHECK_EQ(ref.size(), embedding.size()) << "embedding sizes differ for " << i;
+    const float norm = ref.norm() * embedding.norm();
+    total_similarity += norm == 0.0f ? 0.0 : ref.dot(embedding) / norm;
+    max_error = std::max(max_error, (ref - embedding).cwiseAbs().maxCoeff());
+
+    // recall of the reference neighbors when retrieving with the new embeddings
+    const auto ref_neighbors = getTopK(ref, i, ref_embeddings, k);
+    const auto neighbors = getTopK(embedding, i, embeddings, k);
+    std::vector<size_t> common;
+    std::set_intersection(ref_neighbors.begin(),
+                          ref_neighbors.end(),
+                          neighbors.begin(),
+                          neighbors.end(),
+                          std::back_inserter(common));
+    total_recall += ref_neighbors.empty()
+                        ? 1.0
+                        : static_cast<double>(common.size()) / ref_neighbors.size();
+
+    // the closest reference embedding to a new embedding should be its own
+    const auto closest = getTopK(embedding, corpus.size(), ref_embeddings, 1);
+    num_self_matches += (!closest.empty() && closest.front() == i) ? 1 : 0;
+  }
+
+  const double num_subgraphs = corpus.size();
+  std::cout << "subgraphs: " << corpus.size() << std::endl;
+  std::cout << "reference latency: " << 1.0e3 * ref_time_s << " ms" << std::endl;
+  std::cout << "model latency: " << 1.0e3 * time_s << " ms" << std::endl;
+  std::cout << "speedup: " << (time_s > 0.0 ? ref_time_s / time_s : 0.0) << "x"
+            << std::endl;
+  std::cout << "mean cosine similarity: " << total_similarity / num_subgraphs
+            << std::endl;
+  std::cout << "max absolute error: " << max_error << std::endl;
+  std::cout << "recall@" << k << " vs reference: " << total_recall / num_subgraphs
+            << " (reference: 1.0, change: " << total_recall / num_subgraphs - 1.0 << ")"
+            << std::endl;
+  std::cout << "self-retrieval accuracy: " << num_self_matches / num_subgraphs
+            << std::endl;
+}
+
 template <typename T>
 void showTensorContents(hydra::gnn::Tensor& tensor) {
   const auto map = tensor.map<T>();
@@ -56,15 +207,41 @@ int main(int argc, char* argv[]) {
   google::InstallFailureSignalHandler();
 
   if (argc < 2) {
-    LOG(FATAL) << "usage: model_reader path_to_model";
+    LOG(FATAL) << "usage: model_reader path_to_model [--corpus_dir DIR "
+                  "[--compare_model QUANTIZED_MODEL]]";
     return 1;
   }
 
   std::string model_path(argv[1]);
-  hydra::gnn::GnnInterface gnn(model_path);
+  hydra::gnn::SessionConfig config;
+  config.optimization_level = FLAGS_optimization_level;
+  config.cache_optimized_model = FLAGS_cache_optimized_model;
+  config.optimized_model_dir = FLAGS_optimized_model_dir;
+  hydra::gnn::GnnInterface gnn(model_path, {}, config);
 
   LOG(INFO) << gnn;
 
+  if (!FLAGS_corpus_dir.empty()) {
+    const auto corpus = loadCorpus(FLAGS_corpus_dir);
+    if (corpus.empty()) {
+      LOG(ERROR) << "No subgraphs found in " << FLAGS_corpus_dir;
+      return 1;
+    }
+
+    if (FLAGS_compare_model.empty()) {
+      Embeddings embeddings;
+      const double time_s = computeEmbeddings(gnn, corpus, embeddings);
+      std::cout << "subgraphs: " << corpus.size() << std::endl;
+      std::cout << "latency: " << 1.0e3 * time_s << " ms" << std::endl;
+      return 0;
+    }
+
+    hydra::gnn::GnnInterface compare_gnn(FLAGS_compare_model, {}, config);
+    LOG(INFO) << compare_gnn;
+    validateModel(gnn, compare_gnn, corpus);
+    return 0;
+  }
+
   hydra::gnn::Tensor x(10, 5);
   auto x_map = x.map<float>();
   x_map = Eigen::MatrixXf::Zero(10, 5);
@@ -0,0 +1,259 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/gnn/ort_runtime.h"
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <sstream>
+
+namespace hydra {
+namespace gnn {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+inline GraphOptimizationLevel getOptimizationLevel(int level) {
+  switch (level) {
+    case 0:
+      return GraphOptimizationLevel::ORT_DISABLE_ALL;
+    case 1:
+      return GraphOptimizationLevel::ORT_ENABLE_BASIC;
+    case 2:
+      return GraphOptimizationLevel::ORT_ENABLE_EXTENDED;
+    case 99:
+      return GraphOptimizationLevel::ORT_ENABLE_ALL;
+    default:
+      LOG(WARNING) << "Unknown graph optimization level " << level
+                   << ". Defaulting to all optimizations";
+      return GraphOptimizationLevel::ORT_ENABLE_ALL;
+  }
+}
+
+inline bool optimizedModelIsCurrent(const std::string& model_path,
+                                    const std::string& optimized_path) {
+  std::error_code ec;
+  if (!fs::exists(optimized_path, ec) || !fs::exists(model_path, ec)) {
+    return false;
+  }
+
+  const auto optimized_time = fs::last_write_time(optimized_path, ec);
+  if (ec) {
+    return false;
+  }
+
+  const auto model_time = fs::last_write_time(model_path, ec);
+  return !ec && optimized_time >= model_time;
+}
+
+}  // namespace
+
+OrtRuntime& OrtRuntime::instance() {
+  static OrtRuntime runtime;
+  return runtime;
+}
+
+OrtRuntime::OrtRuntime() {}
+
+OrtRuntime::~OrtRuntime() {
+  // sessions have to be released before the environment
+  sessions_.clear();
+  env_.reset();
+}
+
+bool OrtRuntime::configure(const RuntimeConfig& config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (env_) {
+    LOG(ERROR) << "ONNX runtime environment already created; ignoring configuration";
+    return false;
+  }
+
+  config_ = config;
+  return true;
+}
+
+Ort::Env& OrtRuntime::env() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return getEnvLocked();
+}
+
+OrtAllocator* OrtRuntime::allocator() { return allocator_; }
+
+OrtRuntime::SessionPtr OrtRuntime::getSession(const std::string& model_path,
+                                              const SessionConfig& config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto key = getSessionKey(model_path, config);
+  auto iter = sessions_.find(key);
+  if (iter != sessions_.end()) {
+    VLOG(1) << "Reusing cached session for " << model_path;
+    return iter->second;
+  }
+
+  auto session = makeSession(model_path, config);
+  sessions_.emplace(key, session);
+  return session;
+}
+
+size_t OrtRuntime::numSessions() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sessions_.size();
+}
+
+void OrtRuntime::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = sessions_.begin();
+  while (iter != sessions_.end()) {
+    if (iter->second.use_count() > 1) {
+      ++iter;
+      continue;
+    }
+
+    iter = sessions_.erase(iter);
+  }
+}
+
+std::string OrtRuntime::getSessionKey(const std::string& model_path,
+                                      const SessionConfig& config) {
+  std::error_code ec;
+  const auto canonical_path = fs::weakly_canonical(model_path, ec);
+
+  std::stringstream ss;
+  ss << (ec ? model_path : canonical_path.string()) << "|" << config.intra_op_threads
+     << "|" << config.inter_op_threads << "|" << config.optimization_level << "|"
+     << config.cache_optimized_model << "|" << config.optimized_model_dir;
+  return ss.str();
+}
+
+Ort::Env& OrtRuntime::getEnvLocked() {
+  if (env_) {
+    return *env_;
+  }
+
+  if (!config_.use_global_thread_pools) {
+    env_.reset(new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "hydra_gnn_interface"));
+    return *env_;
+  }
+
+  const auto& api = Ort::GetApi();
+  OrtThreadingOptions* tp_options = nullptr;
+  Ort::ThrowOnError(api.CreateThreadingOptions(&tp_options));
+  Ort::ThrowOnError(
+      api.SetGlobalIntraOpNumThreads(tp_options, config_.global_intra_op_threads));
+  Ort::ThrowOnError(
+      api.SetGlobalInterOpNumThreads(tp_options, config_.global_inter_op_threads));
+  env_.reset(
+      new Ort::Env(tp_options, ORT_LOGGING_LEVEL_WARNING, "hydra_gnn_interface"));
+  api.ReleaseThreadingOptions(tp_options);
+  return *env_;
+}
+
+Ort::SessionOptions OrtRuntime::makeOptions(const SessionConfig& config) const {
+  Ort::SessionOptions options;
+  if (config_.use_global_thread_pools) {
+    options.DisablePerSessionThreads();
+  } else {
+    options.SetIntraOpNumThreads(config.intra_op_threads)
+        .SetInterOpNumThreads(config.inter_op_threads);
+  }
+
+  options.SetGraphOptimizationLevel(getOptimizationLevel(config.optimization_level));
+  return options;
+}
+
+OrtRuntime::SessionPtr OrtRuntime::makeSession(const std::string& model_path,
+                                               const SessionConfig& config) {
+  auto& env = getEnvLocked();
+  if (!config.cache_optimized_model) {
+    return std::make_shared<Ort::Session>(env, model_path.c_str(), makeOptions(config));
+  }
+
+  const auto optimized_path = getOptimizedModelPath(model_path, config);
+  if (optimizedModelIsCurrent(model_path, optimized_path)) {
+    // the saved model is already optimized, so skip optimizing it again
+    auto options = makeOptions(config);
+    options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+    try {
+      VLOG(1) << "Loading optimized model " << optimized_path;
+      return std::make_shared<Ort::Session>(env, optimized_path.c_str(), options);
+    } catch (const Ort::Exception& e) {
+      LOG(WARNING) << "Unable to load optimized model " << optimized_path << ": "
+                   << e.what() << ". Re-optimizing " << model_path;
+    }
+  }
+
+  std::error_code ec;
+  fs::create_directories(fs::path(optimized_path).parent_path(), ec);
+
+  // write to a temporary file first so other processes never see a partial model
+  const auto tmp_path = optimized_path + ".tmp" + std::to_string(::getpid());
+  auto options = makeOptions(config);
+  options.SetOptimizedModelFilePath(tmp_path.c_str());
+  auto session = std::make_shared<Ort::Session>(env, model_path.c_str(), options);
+
+  fs::rename(tmp_path, optimized_path, ec);
+  if (ec) {
+    LOG(WARNING) << "Unable to save optimized model to " << optimized_path << ": "
+                 << ec.message();
+    fs::remove(tmp_path, ec);
+  } else {
+    VLOG(1) << "Saved optimized model to " << optimized_path;
+  }
+
+  return session;
+}
+
+bool configureRuntime(const RuntimeConfig& config) {
+  return OrtRuntime::instance().configure(config);
+}
+
+std::string getOptimizedModelPath(const std::string& model_path,
+                                  const SessionConfig& config) {
+  const fs::path path(model_path);
+  const fs::path dir = config.optimized_model_dir.empty()
+                           ? path.parent_path()
+                           : fs::path(config.optimized_model_dir);
+  const auto name = path.stem().string() + ".opt" +
+                    std::to_string(config.optimization_level) + ".onnx";
+  return (dir / name).string();
+}
+
+size_t numCachedSessions() { return OrtRuntime::instance().numSessions(); }
+
+void clearSessionCache() { OrtRuntime::instance().clear(); }
+
+}  // namespace gnn
+}  // namespace hydra
@@ -182,6 +182,18 @@ std::optional<Tensor::Type> OrtToTensorType(ONNXTensorElementDataType type) {
   }
 }
 
+Tensor::Type FieldInfo::getTensorType() const {
+  auto tensor_type = OrtToTensorType(type);
+  if (!tensor_type) {
+    std::stringstream ss;
+    ss << "cannot make tensor of corresponding type to " << type_name << " for field "
+       << name;
+    throw std::invalid_argument(ss.str());
+  }
+
+  return *tensor_type;
+}
+
 Tensor FieldInfo::getTensor() const {
   for (const auto dim_size : dims) {
     if (dim_size == -1) {
@@ -192,24 +204,17 @@ Tensor FieldInfo::getTensor() const {
     }
   }
 
-  auto tensor_type = OrtToTensorType(type);
-  if (!tensor_type) {
-    std::stringstream ss;
-    ss << "cannot make tensor of corresponding type to " << type_name << " for field "
-       << name;
-    throw std::invalid_argument(ss.str());
-  }
-
-  return Tensor(dims, *tensor_type);
+  return Tensor(dims, getTensorType());
 }
 
-Tensor FieldInfo::getDynamicTensor(const std::vector<size_t>& dims_to_read,
-                                   const std::vector<int64_t>& output_dims) const {
+void FieldInfo::getShape(const std::vector<size_t>& dims_to_read,
+                         const std::vector<int64_t>& output_dims,
+                         std::vector<int64_t>& shape) const {
+  shape.clear();
   size_t dynamic_index = 0;
-  std::vector<int64_t> new_dims;
   for (size_t i = 0; i < dims.size(); ++i) {
     if (dims[i] != -1) {
-      new_dims.push_back(dims[i]);
+      shape.push_back(dims[i]);
       continue;
     }
 
@@ -234,18 +239,15 @@ Tensor FieldInfo::getDynamicTensor(const std::vector<size_t>& dims_to_read,
       throw std::invalid_argument(ss.str());
     }
 
-    new_dims.push_back(new_dim);
-  }
-
-  auto tensor_type = OrtToTensorType(type);
-  if (!tensor_type) {
-    std::stringstream ss;
-    ss << "cannot make tensor of corresponding type to " << type_name << " for field "
-       << name;
-    throw std::invalid_argument(ss.str());
+    shape.push_back(new_dim);
   }
+}
 
-  return Tensor(new_dims, *tensor_type);
+Tensor FieldInfo::getDynamicTensor(const std::vector<size_t>& dims_to_read,
+                                   const std::vector<int64_t>& output_dims) const {
+  std::vector<int64_t> new_dims;
+  getShape(dims_to_read, output_dims, new_dims);
+  return Tensor(new_dims, getTensorType());
 }
 
 using SizeGetter = std::function<size_t(const Ort::Session*)>;
@@ -87,6 +87,35 @@ Tensor::Tensor(const std::vector<int64_t>& dims, Type type) : type_(type), dims_
   memory_.reset(new std::vector<char>(size_ * getTypeSize(type)));
 }
 
+void Tensor::resize(const std::vector<int64_t>& dims) {
+  dims_ = dims;
+  if (dims_.size() == 0) {
+    size_ = 0;
+  } else {
+    size_ = std::accumulate(dims_.begin(), dims_.end(), 1, std::multiplies<size_t>());
+  }
+
+  const size_t num_bytes = size_ * getTypeSize(type_);
+  if (memory_.use_count() > 1) {
+    // don't clobber the contents of tensors sharing this memory
+    memory_.reset(new std::vector<char>(num_bytes));
+    return;
+  }
+
+  memory_->resize(num_bytes);
+}
+
+void Tensor::resize(int64_t rows, int64_t cols) {
+  if (dims_.size() == 2) {
+    dims_[0] = rows;
+    dims_[1] = cols;
+    resize(dims_);
+    return;
+  }
+
+  resize(std::vector<int64_t>{rows, cols});
+}
+
 Tensor::operator bool() const { return size_ != 0; }
 
 Tensor::Type Tensor::type() const { return type_; }
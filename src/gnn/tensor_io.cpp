@@ -0,0 +1,141 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/gnn/tensor_io.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace hydra {
+namespace gnn {
+
+namespace {
+
+inline constexpr char kMagic[] = "HGTM";
+inline constexpr uint32_t kVersion = 1;
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(std::istream& in) {
+  T value;
+  in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  if (!in) {
+    throw std::runtime_error("unexpected end of tensor file");
+  }
+
+  return value;
+}
+
+}  // namespace
+
+bool saveTensorMap(const std::string& filename, const TensorMap& tensors) {
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    return false;
+  }
+
+  out.write(kMagic, 4);
+  writeValue<uint32_t>(out, kVersion);
+  writeValue<uint32_t>(out, tensors.size());
+  for (const auto& name_tensor_pair : tensors) {
+    const auto& name = name_tensor_pair.first;
+    const auto& tensor = name_tensor_pair.second;
+    writeValue<uint32_t>(out, name.size());
+    out.write(name.data(), name.size());
+    writeValue<uint8_t>(out, static_cast<uint8_t>(tensor.type()));
+    writeValue<uint32_t>(out, tensor.num_dims());
+    for (const auto dim : tensor.dims()) {
+      writeValue<int64_t>(out, dim);
+    }
+
+    out.write(tensor.data<char>(false), tensor.num_bytes());
+  }
+
+  return static_cast<bool>(out);
+}
+
+TensorMap loadTensorMap(const std::string& filename) {
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("unable to open tensor file " + filename);
+  }
+
+  char magic[4];
+  in.read(magic, 4);
+  if (!in || std::strncmp(magic, kMagic, 4) != 0) {
+    throw std::runtime_error("invalid tensor file " + filename);
+  }
+
+  const auto version = readValue<uint32_t>(in);
+  if (version != kVersion) {
+    std::stringstream ss;
+    ss << "unsupported tensor file version " << version << " for " << filename;
+    throw std::runtime_error(ss.str());
+  }
+
+  TensorMap tensors;
+  const auto num_tensors = readValue<uint32_t>(in);
+  for (uint32_t i = 0; i < num_tensors; ++i) {
+    std::string name(readValue<uint32_t>(in), '\0');
+    in.read(name.data(), name.size());
+
+    const auto type = static_cast<Tensor::Type>(readValue<uint8_t>(in));
+    if (type > Tensor::Type::UINT64) {
+      throw std::runtime_error("invalid tensor type in " + filename);
+    }
+
+    std::vector<int64_t> dims(readValue<uint32_t>(in));
+    for (auto& dim : dims) {
+      dim = readValue<int64_t>(in);
+    }
+
+    Tensor tensor(dims, type);
+    in.read(tensor.data<char>(false), tensor.num_bytes());
+    if (!in) {
+      throw std::runtime_error("unexpected end of tensor file " + filename);
+    }
+
+    tensors.emplace(name, tensor);
+  }
+
+  return tensors;
+}
+
+}  // namespace gnn
+}  // namespace hydra
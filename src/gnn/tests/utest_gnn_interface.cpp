@@ -36,6 +36,8 @@
 #include <gtest/gtest.h>
 #include <ros/package.h>
 
+#include <cstdio>
+
 #include "hydra/gnn/gnn_interface.h"
 
 namespace hydra {
@@ -84,5 +86,110 @@ TEST(GnnInterfaceTests, TestSimpleNetwork) {
   EXPECT_NEAR(diff, 0.0, 1.0e-9);
 }
 
+TEST(GnnInterfaceTests, TestBoundOutput) {
+  std::string package_path = ros::package::getPath("hydra");
+  std::string model_path = package_path + "/src/gnn/tests/resources/simple_model.onnx";
+
+  GnnInterface model(model_path, {{"output", {0}}});
+
+  Tensor x(5, 2);
+  auto x_map = x.map<float>();
+  for (int i = 0; i < x.rows(); ++i) {
+    x_map(i, 0) = i + 1;
+    x_map(i, 1) = i + 1;
+  }
+
+  Tensor edge_index(2, 4, Tensor::Type::INT64);
+  auto index_map = edge_index.map<int64_t>();
+  for (int i = 0; i < edge_index.cols(); ++i) {
+    index_map(0, i) = i;
+    index_map(1, i) = i + 1;
+  }
+
+  TensorMap inputs{{"x", x}, {"edge_index", edge_index}};
+  Eigen::MatrixXf expected = model(inputs, {5}).at("output").map<float>();
+
+  {  // test case 1: caller memory
+    Eigen::Matrix<float, 5, 2, Eigen::RowMajor> result;
+    model(inputs, "output", result.data(), result.size(), {5});
+    EXPECT_NEAR((expected - result).norm(), 0.0, 1.0e-9);
+  }
+
+  {  // test case 2: resized vector (repeated to exercise the reused binding)
+    Eigen::VectorXf result;
+    for (size_t i = 0; i < 3; ++i) {
+      model(inputs, "output", result, {5});
+      ASSERT_EQ(result.size(), 10);
+      Eigen::Map<Eigen::Matrix<float, 5, 2, Eigen::RowMajor>> result_map(result.data());
+      EXPECT_NEAR((expected - result_map).norm(), 0.0, 1.0e-9);
+    }
+  }
+
+  {  // test case 3: invalid output size
+    Eigen::VectorXf result(3);
+    EXPECT_THROW(model(inputs, "output", result.data(), result.size(), {5}),
+                 std::invalid_argument);
+  }
+}
+
+TEST(GnnInterfaceTests, TestSharedSessions) {
+  std::string package_path = ros::package::getPath("hydra");
+  std::string model_path = package_path + "/src/gnn/tests/resources/simple_model.onnx";
+
+  clearSessionCache();
+  EXPECT_EQ(numCachedSessions(), 0u);
+
+  GnnInterface model1(model_path, {{"output", {0}}});
+  GnnInterface model2(model_path, {{"output", {0}}});
+  EXPECT_EQ(numCachedSessions(), 1u);
+
+  SessionConfig config;
+  config.intra_op_threads = 2;
+  GnnInterface model3(model_path, {{"output", {0}}}, config);
+  EXPECT_EQ(numCachedSessions(), 2u);
+
+  // sessions in use by a model are kept
+  clearSessionCache();
+  EXPECT_EQ(numCachedSessions(), 2u);
+}
+
+TEST(GnnInterfaceTests, TestOptimizedModelCache) {
+  std::string package_path = ros::package::getPath("hydra");
+  std::string model_path = package_path + "/src/gnn/tests/resources/simple_model.onnx";
+
+  SessionConfig config;
+  config.cache_optimized_model = true;
+  config.optimized_model_dir = ::testing::TempDir();
+  const auto optimized_path = getOptimizedModelPath(model_path, config);
+  std::remove(optimized_path.c_str());
+
+  Tensor x(5, 2);
+  x.map<float>().setOnes();
+  Tensor edge_index(2, 4, Tensor::Type::INT64);
+  auto index_map = edge_index.map<int64_t>();
+  for (int i = 0; i < edge_index.cols(); ++i) {
+    index_map(0, i) = i;
+    index_map(1, i) = i + 1;
+  }
+
+  TensorMap inputs{{"x", x}, {"edge_index", edge_index}};
+  Eigen::MatrixXf expected;
+  {  // first session writes the optimized model
+    GnnInterface model(model_path, {{"output", {0}}}, config);
+    expected = model(inputs, {5}).at("output").map<float>();
+  }
+
+  FILE* fp = std::fopen(optimized_path.c_str(), "rb");
+  ASSERT_TRUE(fp != nullptr);
+  std::fclose(fp);
+
+  // second session loads the optimized model
+  clearSessionCache();
+  GnnInterface model(model_path, {{"output", {0}}}, config);
+  Eigen::MatrixXf result = model(inputs, {5}).at("output").map<float>();
+  EXPECT_NEAR((expected - result).norm(), 0.0, 1.0e-9);
+  std::remove(optimized_path.c_str());
+}
+
 }  // namespace gnn
 }  // namespace hydra
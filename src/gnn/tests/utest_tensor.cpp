@@ -134,5 +134,35 @@ TEST(GnnTensorTests, AbitraryConstructorInvariants) {
   }
 }
 
+TEST(GnnTensorTests, TestResize) {
+  Tensor tensor(5, 2, Tensor::Type::INT64);
+  const auto* data = tensor.data<int64_t>();
+
+  {  // test case 1: shrinking keeps the memory
+    tensor.resize(2, 3);
+    EXPECT_EQ(tensor.size(), 6u);
+    EXPECT_EQ(tensor.num_bytes(), 6 * sizeof(int64_t));
+    EXPECT_EQ(tensor.dims(), std::vector<int64_t>({2, 3}));
+    EXPECT_EQ(tensor.type(), Tensor::Type::INT64);
+    EXPECT_EQ(tensor.data<int64_t>(), data);
+  }
+
+  {  // test case 2: growing back to the previous size keeps the memory
+    tensor.resize({10});
+    EXPECT_EQ(tensor.size(), 10u);
+    EXPECT_EQ(tensor.rows(), 10);
+    EXPECT_EQ(tensor.cols(), 1);
+    EXPECT_EQ(tensor.data<int64_t>(), data);
+  }
+
+  {  // test case 3: shared memory is not modified
+    Tensor other = tensor;
+    tensor.resize(2, 2);
+    EXPECT_EQ(other.size(), 10u);
+    EXPECT_EQ(other.data<int64_t>(), data);
+    EXPECT_NE(tensor.data<int64_t>(), data);
+  }
+}
+
 }  // namespace gnn
 }  // namespace hydra
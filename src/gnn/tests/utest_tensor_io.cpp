@@ -0,0 +1,77 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+
+#include "hydra/gnn/tensor_io.h"
+
+namespace hydra {
+namespace gnn {
+
+TEST(GnnTensorIoTests, TestRoundTrip) {
+  Tensor x(3, 2);
+  auto x_map = x.map<float>();
+  x_map << 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f;
+
+  Tensor edge_index(2, 2, Tensor::Type::INT64);
+  auto edge_map = edge_index.map<int64_t>();
+  edge_map << 0, 1, 1, 2;
+
+  const std::string filename = ::testing::TempDir() + "/test_tensors.bin";
+  ASSERT_TRUE(saveTensorMap(filename, {{"x", x}, {"edge_index", edge_index}}));
+
+  auto result = loadTensorMap(filename);
+  ASSERT_EQ(result.size(), 2u);
+
+  const auto& x_result = result.at("x");
+  EXPECT_EQ(x_result.type(), Tensor::Type::FLOAT32);
+  EXPECT_EQ(x_result.dims(), x.dims());
+  Eigen::MatrixXf x_expected = x_map;
+  Eigen::MatrixXf x_actual = result.at("x").map<float>();
+  EXPECT_EQ(x_actual, x_expected);
+
+  const auto& edge_result = result.at("edge_index");
+  EXPECT_EQ(edge_result.type(), Tensor::Type::INT64);
+  EXPECT_EQ(edge_result.dims(), edge_index.dims());
+  EXPECT_EQ(edge_result.data<int64_t>()[1], 1);
+  EXPECT_EQ(edge_result.data<int64_t>()[3], 2);
+}
+
+TEST(GnnTensorIoTests, TestInvalidFile) {
+  EXPECT_THROW(loadTensorMap(::testing::TempDir() + "/missing_tensors.bin"),
+               std::runtime_error);
+}
+
+}  // namespace gnn
+}  // namespace hydra
@@ -0,0 +1,200 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/loop_closure/compressed_bow.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace hydra {
+namespace lcd {
+
+namespace {
+
+inline void encodeVarint(uint32_t value, std::vector<uint8_t>& bytes) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint32_t decodeVarint(const uint8_t*& ptr) {
+  uint32_t value = 0;
+  int shift = 0;
+  while (*ptr & 0x80) {
+    value |= static_cast<uint32_t>(*ptr & 0x7f) << shift;
+    shift += 7;
+    ++ptr;
+  }
+  value |= static_cast<uint32_t>(*ptr) << shift;
+  ++ptr;
+  return value;
+}
+
+// Walks the shared words of two compressed vectors in order
+template <typename Func>
+inline void forEachSharedWord(const CompressedBow& lhs,
+                              const CompressedBow& rhs,
+                              const Func& func) {
+  const uint8_t* lhs_ptr = lhs.word_deltas.data();
+  const uint8_t* rhs_ptr = rhs.word_deltas.data();
+  const size_t lhs_size = lhs.size();
+  const size_t rhs_size = rhs.size();
+  if (!lhs_size || !rhs_size) {
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  uint32_t lhs_word = decodeVarint(lhs_ptr);
+  uint32_t rhs_word = decodeVarint(rhs_ptr);
+  while (true) {
+    if (lhs_word < rhs_word) {
+      if (++i == lhs_size) {
+        return;
+      }
+      lhs_word += decodeVarint(lhs_ptr);
+    } else if (rhs_word < lhs_word) {
+      if (++j == rhs_size) {
+        return;
+      }
+      rhs_word += decodeVarint(rhs_ptr);
+    } else {
+      func(lhs.weights[i], rhs.weights[j]);
+      if (++i == lhs_size || ++j == rhs_size) {
+        return;
+      }
+      lhs_word += decodeVarint(lhs_ptr);
+      rhs_word += decodeVarint(rhs_ptr);
+    }
+  }
+}
+
+}  // namespace
+
+CompressedBow::CompressedBow(const WordVector& words, const Eigen::VectorXf& values) {
+  CHECK_EQ(words.rows(), values.rows());
+  std::vector<std::pair<uint32_t, float>> entries;
+  entries.reserve(words.rows());
+  float max_value = 0.0f;
+  for (int i = 0; i < words.rows(); ++i) {
+    // bag-of-words weights are non-negative
+    const float value = std::max(values(i), 0.0f);
+    entries.emplace_back(words(i), value);
+    max_value = std::max(max_value, value);
+  }
+
+  if (max_value == 0.0f) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end());
+  scale = max_value / 255.0f;
+  word_deltas.reserve(2 * entries.size());
+  weights.reserve(entries.size());
+
+  uint32_t prev_word = 0;
+  for (const auto& [word, value] : entries) {
+    const auto quantized = static_cast<uint8_t>(std::lround(value / scale));
+    if (quantized == 0) {
+      continue;
+    }
+
+    encodeVarint(word - prev_word, word_deltas);
+    weights.push_back(quantized);
+    weight_sum += quantized;
+    weight_squared_sum += static_cast<uint64_t>(quantized) * quantized;
+    prev_word = word;
+  }
+
+  word_deltas.shrink_to_fit();
+  weights.shrink_to_fit();
+}
+
+void CompressedBow::decode(WordVector& words, Eigen::VectorXf& values) const {
+  words.resize(size());
+  values.resize(size());
+  const uint8_t* ptr = word_deltas.data();
+  uint32_t word = 0;
+  for (size_t i = 0; i < size(); ++i) {
+    word += decodeVarint(ptr);
+    words(i) = word;
+    values(i) = scale * weights[i];
+  }
+}
+
+float computeCompressedBowL1Score(const CompressedBow& lhs, const CompressedBow& rhs) {
+  if (lhs.empty() && rhs.empty()) {
+    return 1.0f;
+  }
+
+  if (lhs.empty() || rhs.empty()) {
+    return 0.0f;
+  }
+
+  // min(a / A, b / B) = min(a * B, b * A) / (A * B)
+  const uint64_t lhs_sum = lhs.weight_sum;
+  const uint64_t rhs_sum = rhs.weight_sum;
+  uint64_t shared = 0;
+  forEachSharedWord(lhs, rhs, [&](uint8_t a, uint8_t b) {
+    shared += std::min(a * rhs_sum, b * lhs_sum);
+  });
+
+  return static_cast<float>(static_cast<double>(shared) / (lhs_sum * rhs_sum));
+}
+
+float computeCompressedBowCosine(const CompressedBow& lhs, const CompressedBow& rhs) {
+  if (lhs.empty() && rhs.empty()) {
+    return 1.0f;
+  }
+
+  if (lhs.empty() || rhs.empty()) {
+    return 0.0f;
+  }
+
+  uint64_t dot = 0;
+  forEachSharedWord(lhs, rhs, [&](uint8_t a, uint8_t b) {
+    dot += static_cast<uint32_t>(a) * b;
+  });
+
+  const double norm = std::sqrt(static_cast<double>(lhs.weight_squared_sum)) *
+                      std::sqrt(static_cast<double>(rhs.weight_squared_sum));
+  return static_cast<float>(dot / norm);
+}
+
+}  // namespace lcd
+}  // namespace hydra
@@ -0,0 +1,233 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/loop_closure/descriptor_eviction.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <unordered_set>
+
+namespace hydra {
+namespace lcd {
+
+using CellIndex = std::tuple<int64_t, int64_t, int64_t>;
+
+struct RedundancyGrid {
+  explicit RedundancyGrid(double resolution) : resolution(resolution) {}
+
+  CellIndex getIndex(const Eigen::Vector3d& pos) const {
+    return {static_cast<int64_t>(std::floor(pos.x() / resolution)),
+            static_cast<int64_t>(std::floor(pos.y() / resolution)),
+            static_cast<int64_t>(std::floor(pos.z() / resolution))};
+  }
+
+  void insert(NodeId root, const Descriptor& descriptor) {
+    cells[getIndex(descriptor.root_position)].insert(root);
+  }
+
+  void erase(NodeId root, const Descriptor& descriptor) {
+    auto iter = cells.find(getIndex(descriptor.root_position));
+    if (iter == cells.end()) {
+      return;
+    }
+
+    iter->second.erase(root);
+    if (iter->second.empty()) {
+      cells.erase(iter);
+    }
+  }
+
+  template <typename Callback>
+  void forEachNeighbor(const Eigen::Vector3d& pos, const Callback& callback) const {
+    const auto center = getIndex(pos);
+    for (int64_t dx = -1; dx <= 1; ++dx) {
+      for (int64_t dy = -1; dy <= 1; ++dy) {
+        for (int64_t dz = -1; dz <= 1; ++dz) {
+          const CellIndex index{std::get<0>(center) + dx,
+                                std::get<1>(center) + dy,
+                                std::get<2>(center) + dz};
+          auto iter = cells.find(index);
+          if (iter == cells.end()) {
+            continue;
+          }
+
+          for (const auto root : iter->second) {
+            if (callback(root)) {
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const double resolution;
+  std::map<CellIndex, std::set<NodeId>> cells;
+};
+
+std::vector<NodeId> getEvictionOrder(const DescriptorCache& cache,
+                                     DescriptorEvictionPolicy policy,
+                                     const std::map<NodeId, size_t>& match_counts) {
+  std::vector<NodeId> order;
+  order.reserve(cache.size());
+  for (const auto& root_descriptor_pair : cache) {
+    order.push_back(root_descriptor_pair.first);
+  }
+
+  const auto get_count = [&](NodeId root) -> size_t {
+    auto iter = match_counts.find(root);
+    return iter == match_counts.end() ? 0 : iter->second;
+  };
+
+  const auto get_stamp = [&](NodeId root) {
+    const auto& descriptor = cache.at(root);
+    return descriptor ? descriptor->timestamp : std::chrono::nanoseconds(0);
+  };
+
+  std::stable_sort(order.begin(), order.end(), [&](NodeId lhs, NodeId rhs) {
+    const bool lhs_valid = cache.at(lhs) != nullptr;
+    const bool rhs_valid = cache.at(rhs) != nullptr;
+    if (lhs_valid != rhs_valid) {
+      return !lhs_valid;
+    }
+
+    if (policy == DescriptorEvictionPolicy::LEAST_MATCHED) {
+      const auto lhs_count = get_count(lhs);
+      const auto rhs_count = get_count(rhs);
+      if (lhs_count != rhs_count) {
+        return lhs_count < rhs_count;
+      }
+    }
+
+    return get_stamp(lhs) < get_stamp(rhs);
+  });
+
+  return order;
+}
+
+std::vector<NodeId> selectDescriptorsToEvict(
+    const DescriptorCache& cache,
+    size_t capacity,
+    const DescriptorEvictionConfig& config,
+    DescriptorScoreType score_type,
+    const std::map<NodeId, size_t>& match_counts) {
+  if (cache.size() <= capacity) {
+    return {};
+  }
+
+  const size_t num_to_evict = cache.size() - capacity;
+  const auto order = getEvictionOrder(cache, config.policy, match_counts);
+
+  std::vector<NodeId> evicted;
+  std::unordered_set<NodeId> evicted_set;
+  const auto evict = [&](NodeId root) {
+    evicted.push_back(root);
+    evicted_set.insert(root);
+  };
+
+  // descriptors without a value sort first and can never match
+  for (const auto root : order) {
+    if (evicted.size() >= num_to_evict || cache.at(root)) {
+      break;
+    }
+
+    evict(root);
+  }
+
+  if (config.prune_redundant && config.redundancy_radius_m > 0.0) {
+    RedundancyGrid grid(config.redundancy_radius_m);
+    for (const auto& root_descriptor_pair : cache) {
+      if (root_descriptor_pair.second) {
+        grid.insert(root_descriptor_pair.first, *root_descriptor_pair.second);
+      }
+    }
+
+    for (const auto root : order) {
+      if (evicted.size() >= num_to_evict) {
+        break;
+      }
+
+      const auto& descriptor = cache.at(root);
+      if (!descriptor || descriptor->is_null) {
+        continue;
+      }
+
+      bool redundant = false;
+      grid.forEachNeighbor(descriptor->root_position, [&](NodeId other) {
+        if (other == root) {
+          return false;
+        }
+
+        const auto& other_descriptor = *cache.at(other);
+        if (other_descriptor.is_null) {
+          return false;
+        }
+
+        const double dist =
+            (descriptor->root_position - other_descriptor.root_position).norm();
+        if (dist > config.redundancy_radius_m) {
+          return false;
+        }
+
+        const float score =
+            computeDescriptorScore(*descriptor, other_descriptor, score_type);
+        redundant = score >= config.redundancy_min_score;
+        return redundant;
+      });
+
+      if (redundant) {
+        grid.erase(root, *descriptor);
+        evict(root);
+      }
+    }
+  }
+
+  for (const auto root : order) {
+    if (evicted.size() >= num_to_evict) {
+      break;
+    }
+
+    if (!evicted_set.count(root)) {
+      evict(root);
+    }
+  }
+
+  return evicted;
+}
+
+}  // namespace lcd
+}  // namespace hydra
@@ -36,6 +36,10 @@
 
 #include <glog/logging.h>
 
+#include <cmath>
+#include <mutex>
+#include <random>
+
 namespace hydra {
 namespace lcd {
 
@@ -97,9 +101,89 @@ float computeDistance(const Descriptor& lhs,
   }
 }
 
+float computeCompressedBowScore(const CompressedBow& lhs,
+                                const CompressedBow& rhs,
+                                DescriptorScoreType type) {
+  switch (type) {
+    case DescriptorScoreType::COSINE:
+      return 0.5f * computeCompressedBowCosine(lhs, rhs) + 0.5f;
+    case DescriptorScoreType::L1:
+    default:
+      return computeCompressedBowL1Score(lhs, rhs);
+  }
+}
+
+// scores one block of each multi-scale descriptor as an unnormalized single-scale
+// histogram (matches computeCosineDistance and computeL1Distance without copies)
+float computeBlockScore(const Eigen::Ref<const Eigen::VectorXf>& lhs,
+                        const Eigen::Ref<const Eigen::VectorXf>& rhs,
+                        DescriptorScoreType type) {
+  switch (type) {
+    case DescriptorScoreType::COSINE: {
+      const float lhs_scale = lhs.norm();
+      const float rhs_scale = rhs.norm();
+      if (lhs_scale == 0.0f && rhs_scale == 0.0f) {
+        return 1.0f;
+      }
+
+      const float scale = lhs_scale * rhs_scale;
+      const float distance = scale == 0.0f ? 0.0f : lhs.dot(rhs) / scale;
+      return 0.5f * distance + 0.5f;
+    }
+    case DescriptorScoreType::L1:
+    default: {
+      float lhs_scale = lhs.lpNorm<1>();
+      float rhs_scale = rhs.lpNorm<1>();
+      if (lhs_scale == 0.0f && rhs_scale == 0.0f) {
+        return 1.0f;
+      }
+
+      lhs_scale = lhs_scale == 0.0f ? 1.0f : lhs_scale;
+      rhs_scale = rhs_scale == 0.0f ? 1.0f : rhs_scale;
+      // entries where either side is zero don't contribute to the difference
+      const float l1_diff = (lhs / lhs_scale - rhs / rhs_scale).lpNorm<1>() -
+                            lhs.lpNorm<1>() / lhs_scale - rhs.lpNorm<1>() / rhs_scale;
+      return 1.0f - 0.5f * (2.0f + l1_diff);
+    }
+  }
+}
+
+inline bool isMultiScale(const Descriptor& lhs, const Descriptor& rhs) {
+  return lhs.num_scales > 1 && lhs.num_scales == rhs.num_scales &&
+         lhs.values.rows() == rhs.values.rows() && lhs.words.size() == 0 &&
+         rhs.words.size() == 0;
+}
+
 float computeDescriptorScore(const Descriptor& lhs,
                              const Descriptor& rhs,
                              DescriptorScoreType type) {
+  if (isMultiScale(lhs, rhs)) {
+    const int block_size = lhs.values.rows() / lhs.num_scales;
+    float score = 0.0f;
+    for (size_t i = 0; i < lhs.num_scales; ++i) {
+      score += computeBlockScore(lhs.values.segment(i * block_size, block_size),
+                                 rhs.values.segment(i * block_size, block_size),
+                                 type);
+    }
+
+    return score / lhs.num_scales;
+  }
+
+  if (!lhs.bow.empty() || !rhs.bow.empty()) {
+    // compress the other descriptor on the fly if only one side is compressed
+    if (lhs.bow.empty()) {
+      const CompressedBow lhs_bow(lhs.words, lhs.values);
+      return computeCompressedBowScore(lhs_bow, rhs.bow, type);
+    }
+
+    if (rhs.bow.empty()) {
+      const CompressedBow rhs_bow(rhs.words, rhs.values);
+      return computeCompressedBowScore(lhs.bow, rhs_bow, type);
+    }
+
+    return computeCompressedBowScore(lhs.bow, rhs.bow, type);
+  }
+
   switch (type) {
     case DescriptorScoreType::COSINE:
       // map [-1, 1] to [0, 1]
@@ -111,6 +195,95 @@ float computeDescriptorScore(const Descriptor& lhs,
   }
 }
 
+float computeCoarseDescriptorScore(const Descriptor& lhs,
+                                   const Descriptor& rhs,
+                                   DescriptorScoreType type) {
+  if (!isMultiScale(lhs, rhs)) {
+    return computeDescriptorScore(lhs, rhs, type);
+  }
+
+  const int block_size = lhs.values.rows() / lhs.num_scales;
+  return computeBlockScore(
+      lhs.values.tail(block_size), rhs.values.tail(block_size), type);
+}
+
+SearchStageStats& SearchStageStats::operator+=(const SearchStageStats& other) {
+  num_candidates += other.num_candidates;
+  num_filtered += other.num_filtered;
+  num_sketch_rejected += other.num_sketch_rejected;
+  num_sketch_capped += other.num_sketch_capped;
+  num_coarse_rejected += other.num_coarse_rejected;
+  num_scored += other.num_scored;
+  num_valid += other.num_valid;
+  num_registration += other.num_registration;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& out, const SearchStageStats& stats) {
+  out << "candidates: " << stats.num_candidates << ", filtered: " << stats.num_filtered
+      << ", sketch rejected: " << stats.num_sketch_rejected
+      << ", sketch capped: " << stats.num_sketch_capped
+      << ", coarse rejected: " << stats.num_coarse_rejected
+      << ", scored: " << stats.num_scored << ", valid: " << stats.num_valid
+      << ", registration: " << stats.num_registration;
+  return out;
+}
+
+const Eigen::MatrixXf& getSketchProjection(size_t dimension, size_t num_bits) {
+  static std::mutex mutex;
+  static std::map<std::pair<size_t, size_t>, Eigen::MatrixXf> projections;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto key = std::make_pair(dimension, num_bits);
+  auto iter = projections.find(key);
+  if (iter != projections.end()) {
+    return iter->second;
+  }
+
+  // fixed seed so that all sketches of the same size are comparable
+  std::mt19937 rng(dimension * 7919 + num_bits);
+  std::normal_distribution<float> dist(0.0f, 1.0f);
+  Eigen::MatrixXf projection(num_bits, dimension);
+  for (int r = 0; r < projection.rows(); ++r) {
+    for (int c = 0; c < projection.cols(); ++c) {
+      projection(r, c) = dist(rng);
+    }
+  }
+
+  // std::map never invalidates references on insertion
+  return projections.emplace(key, projection).first->second;
+}
+
+void computeDescriptorSketch(Descriptor& descriptor, size_t num_bits) {
+  descriptor.sketch.clear();
+  if (num_bits == 0 || descriptor.is_null || descriptor.words.size() > 0 ||
+      descriptor.values.size() == 0) {
+    return;
+  }
+
+  const Eigen::VectorXf centered =
+      descriptor.values.array() - descriptor.values.mean();
+  const auto& projection = getSketchProjection(centered.size(), num_bits);
+  const Eigen::VectorXf projected = projection * centered;
+
+  descriptor.sketch.resize((num_bits + 63) / 64, 0);
+  for (size_t i = 0; i < num_bits; ++i) {
+    if (projected(i) > 0.0f) {
+      descriptor.sketch[i / 64] |= (uint64_t(1) << (i % 64));
+    }
+  }
+}
+
+size_t computeSketchDistance(const Descriptor& lhs, const Descriptor& rhs) {
+  CHECK_EQ(lhs.sketch.size(), rhs.sketch.size());
+  size_t distance = 0;
+  for (size_t i = 0; i < lhs.sketch.size(); ++i) {
+    distance += __builtin_popcountll(lhs.sketch[i] ^ rhs.sketch[i]);
+  }
+
+  return distance;
+}
+
 LayerSearchResults searchDescriptors(
     const Descriptor& descriptor,
     const DescriptorMatchConfig& match_config,
@@ -128,6 +301,7 @@ LayerSearchResults searchDescriptors(
   size_t num_null = 0;
   size_t num_default_match = 0;
   size_t num_shared_nodes = 0;
+  std::vector<std::pair<NodeId, const Descriptor*>> candidates;
 
   VLOG(10) << "--------------------------------------------------";
 
@@ -137,12 +311,15 @@ LayerSearchResults searchDescriptors(
       continue;
     }
 
-    const auto& other_ptr = descriptors.at(valid_id);
-    if (!other_ptr) {
+    // descriptors may have been evicted from the cache for this layer
+    const auto other_iter = descriptors.find(valid_id);
+    if (other_iter == descriptors.end() || !other_iter->second) {
       num_null++;
       continue;
     }
 
+    const auto& other_ptr = other_iter->second;
+
     const bool same_robot = NodeSymbol(query_id).category() ==
                             NodeSymbol(*root_leaf_map.at(valid_id).begin()).category();
     if (!same_robot) {
@@ -180,8 +357,82 @@ LayerSearchResults searchDescriptors(
       continue;
     }
 
+    candidates.push_back({valid_id, &other_descriptor});
+  }
+
+  SearchStageStats stats;
+  stats.num_candidates = valid_matches.size();
+  stats.num_filtered = valid_matches.size() - candidates.size() - num_default_match;
+
+  // coarse stage: prune candidates by sketch distance before exact scoring
+  if (match_config.sketch_bits > 0 && !descriptor.sketch.empty()) {
+    const size_t max_distance = static_cast<size_t>(
+        std::floor(match_config.max_sketch_distance * match_config.sketch_bits));
+    std::vector<std::pair<size_t, size_t>> distance_indices;
+    std::vector<size_t> unsketched;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      const auto& other = *candidates[i].second;
+      if (other.sketch.size() != descriptor.sketch.size()) {
+        // no comparable sketch: always passed on to exact scoring (outside the cap)
+        unsketched.push_back(i);
+        continue;
+      }
+
+      const size_t distance = computeSketchDistance(descriptor, other);
+      if (distance > max_distance) {
+        ++stats.num_sketch_rejected;
+        continue;
+      }
+
+      distance_indices.push_back({distance, i});
+    }
+
+    const size_t max_candidates = match_config.max_sketch_candidates;
+    if (max_candidates > 0 && distance_indices.size() > max_candidates) {
+      stats.num_sketch_capped = distance_indices.size() - max_candidates;
+      std::nth_element(distance_indices.begin(),
+                       distance_indices.begin() + max_candidates,
+                       distance_indices.end());
+      distance_indices.resize(max_candidates);
+    }
+
+    // keep the original candidate order for exact scoring
+    std::vector<size_t> index_order(unsketched);
+    for (const auto& distance_index : distance_indices) {
+      index_order.push_back(distance_index.second);
+    }
+    std::sort(index_order.begin(), index_order.end());
+
+    std::vector<std::pair<NodeId, const Descriptor*>> pruned;
+    for (const auto index : index_order) {
+      pruned.push_back(candidates[index]);
+    }
+    candidates = std::move(pruned);
+  }
+
+  // multi-scale descriptors: reject candidates that disagree at the coarsest scale
+  if (match_config.min_coarse_score > 0.0f && descriptor.num_scales > 1) {
+    std::vector<std::pair<NodeId, const Descriptor*>> coarse_valid;
+    for (const auto& candidate : candidates) {
+      const auto& other = *candidate.second;
+      const float coarse_score =
+          computeCoarseDescriptorScore(descriptor, other, match_config.type);
+      if (coarse_score < match_config.min_coarse_score) {
+        ++stats.num_coarse_rejected;
+        continue;
+      }
+
+      coarse_valid.push_back(candidate);
+    }
+    candidates = std::move(coarse_valid);
+  }
+
+  // fine stage: exact scores for remaining candidates
+  for (const auto& candidate : candidates) {
+    const auto valid_id = candidate.first;
     const float curr_score =
-        computeDescriptorScore(descriptor, other_descriptor, match_config.type);
+        computeDescriptorScore(descriptor, *candidate.second, match_config.type);
+    ++stats.num_scored;
     if (curr_score > best_score) {
       best_score = curr_score;
     }
@@ -194,11 +445,15 @@ LayerSearchResults searchDescriptors(
     }
   }
 
+  stats.num_valid = new_valid_match_scores.size();
+
   // TODO(nathan) add layer id in again or handle stats better
   VLOG(1) << "matching "
           << " -> shared: " << num_same_parent << ", null: " << num_null
           << ", horizon: " << num_inside_horizon << ", low: " << num_low_score
           << ", default: " << num_default_match << ", shared: " << num_shared_nodes
+          << ", sketch: " << stats.num_sketch_rejected + stats.num_sketch_capped
+          << ", coarse: " << stats.num_coarse_rejected
           << ", valid: " << new_valid_match_scores.size();
 
   std::sort(new_valid_match_scores.begin(),
@@ -238,6 +493,7 @@ LayerSearchResults searchDescriptors(
     }
   }
 
+  stats.num_registration = matches.size();
   if (match_scores.empty()) {
     match_scores.push_back(best_score);
   }
@@ -247,7 +503,8 @@ LayerSearchResults searchDescriptors(
           descriptor.nodes,
           match_nodes,
           descriptor.root_node,
-          matches};
+          matches,
+          stats};
 }
 
 LayerSearchResults searchLeafDescriptors(const Descriptor& descriptor,
@@ -258,8 +515,14 @@ LayerSearchResults searchLeafDescriptors(const Descriptor& descriptor,
   float best_score = 0.0f;
   std::vector<std::pair<std::pair<NodeId, NodeId>, float>> new_valid_match_scores;
   std::set<NodeId> new_valid_matches;
+  SearchStageStats stats;
   for (const auto& valid_id : valid_matches) {
-    const DescriptorCache& leaf_cache = leaf_cache_map.at(valid_id);
+    const auto leaf_iter = leaf_cache_map.find(valid_id);
+    if (leaf_iter == leaf_cache_map.end()) {
+      continue;
+    }
+
+    const DescriptorCache& leaf_cache = leaf_iter->second;
 
     for (const auto& id_desc_pair : leaf_cache) {
       bool same_robot = true;
@@ -267,7 +530,9 @@ LayerSearchResults searchLeafDescriptors(const Descriptor& descriptor,
           NodeSymbol(query_id).category()) {
         same_robot = false;
       }
+      ++stats.num_candidates;
       if (id_desc_pair.first == query_id) {
+        ++stats.num_filtered;
         continue;  // disallow self matches even if they probably can't happen
       }
 
@@ -275,11 +540,13 @@ LayerSearchResults searchLeafDescriptors(const Descriptor& descriptor,
       std::chrono::duration<double> diff_s =
           descriptor.timestamp - other_descriptor.timestamp;
       if (same_robot && diff_s.count() < match_config.min_time_separation_s) {
+        ++stats.num_filtered;
         continue;
       }
 
       const float curr_score =
           computeDescriptorScore(descriptor, other_descriptor, match_config.type);
+      ++stats.num_scored;
 
       if (curr_score > best_score) {
         best_score = curr_score;
@@ -322,12 +589,15 @@ LayerSearchResults searchLeafDescriptors(const Descriptor& descriptor,
     }
   }
 
+  stats.num_valid = new_valid_match_scores.size();
+  stats.num_registration = matches.size();
   return {match_scores,
           new_valid_matches,
           descriptor.nodes,
           match_nodes,
           descriptor.root_node,
-          matches};
+          matches,
+          stats};
 }
 
 }  // namespace lcd
@@ -0,0 +1,181 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/loop_closure/descriptor_refresh.h"
+
+#include <glog/logging.h>
+
+#include <cmath>
+
+namespace hydra {
+namespace lcd {
+
+DescriptorRefreshTracker::DescriptorRefreshTracker(
+    const DescriptorRefreshConfig& config)
+    : config(config), num_stale_(0) {
+  if (enabled()) {
+    CHECK_GT(config.radius_m, 0.0) << "refresh radius must be positive";
+  }
+}
+
+bool DescriptorRefreshTracker::enabled() const {
+  return config.max_refreshes_per_update > 0;
+}
+
+DescriptorRefreshTracker::CellIndex DescriptorRefreshTracker::getIndex(
+    const Eigen::Vector3d& pos) const {
+  return {static_cast<int64_t>(std::floor(pos.x() / config.radius_m)),
+          static_cast<int64_t>(std::floor(pos.y() / config.radius_m)),
+          static_cast<int64_t>(std::floor(pos.z() / config.radius_m))};
+}
+
+void DescriptorRefreshTracker::eraseFromCell(NodeId root, const CellIndex& cell) {
+  auto iter = cells_.find(cell);
+  if (iter == cells_.end()) {
+    return;
+  }
+
+  iter->second.erase(root);
+  if (iter->second.empty()) {
+    cells_.erase(iter);
+  }
+}
+
+void DescriptorRefreshTracker::addRoot(NodeId root, const Eigen::Vector3d& position) {
+  if (!enabled()) {
+    return;
+  }
+
+  const auto cell = getIndex(position);
+  auto iter = roots_.find(root);
+  if (iter == roots_.end()) {
+    iter = roots_.emplace(root, RootInfo()).first;
+  } else if (iter->second.cell != cell) {
+    eraseFromCell(root, iter->second.cell);
+  }
+
+  iter->second.position = position;
+  iter->second.cell = cell;
+  cells_[cell].insert(root);
+}
+
+void DescriptorRefreshTracker::removeRoot(NodeId root) {
+  auto iter = roots_.find(root);
+  if (iter == roots_.end()) {
+    return;
+  }
+
+  if (iter->second.stale) {
+    --num_stale_;  // the queue entry is dropped lazily when popped
+  }
+
+  eraseFromCell(root, iter->second.cell);
+  roots_.erase(iter);
+}
+
+size_t DescriptorRefreshTracker::markChanged(const Eigen::Vector3d& position) {
+  size_t num_marked = 0;
+  const auto center = getIndex(position);
+  for (int64_t dx = -1; dx <= 1; ++dx) {
+    for (int64_t dy = -1; dy <= 1; ++dy) {
+      for (int64_t dz = -1; dz <= 1; ++dz) {
+        const CellIndex index{std::get<0>(center) + dx,
+                              std::get<1>(center) + dy,
+                              std::get<2>(center) + dz};
+        auto iter = cells_.find(index);
+        if (iter == cells_.end()) {
+          continue;
+        }
+
+        for (const auto root : iter->second) {
+          auto& info = roots_.at(root);
+          if (info.stale || (info.position - position).norm() > config.radius_m) {
+            continue;
+          }
+
+          info.stale = true;
+          stale_queue_.push_back(root);
+          ++num_stale_;
+          ++num_marked;
+        }
+      }
+    }
+  }
+
+  return num_marked;
+}
+
+std::vector<NodeId> DescriptorRefreshTracker::popStaleRoots(uint64_t timestamp_ns) {
+  std::vector<NodeId> to_refresh;
+  const auto period_ns = static_cast<uint64_t>(config.min_refresh_period_s * 1.0e9);
+
+  // each queued root is visited at most once so that waiting roots keep their order
+  size_t num_to_visit = stale_queue_.size();
+  while (num_to_visit > 0 && to_refresh.size() < config.max_refreshes_per_update) {
+    --num_to_visit;
+    const auto root = stale_queue_.front();
+    stale_queue_.pop_front();
+
+    auto iter = roots_.find(root);
+    if (iter == roots_.end() || !iter->second.stale) {
+      continue;  // removed (or re-added) since it was queued
+    }
+
+    auto& info = iter->second;
+    if (info.refreshed && timestamp_ns < info.last_refresh_ns + period_ns) {
+      stale_queue_.push_back(root);
+      continue;
+    }
+
+    info.stale = false;
+    info.refreshed = true;
+    info.last_refresh_ns = timestamp_ns;
+    --num_stale_;
+    to_refresh.push_back(root);
+  }
+
+  return to_refresh;
+}
+
+bool DescriptorRefreshTracker::isStale(NodeId root) const {
+  auto iter = roots_.find(root);
+  return iter != roots_.end() && iter->second.stale;
+}
+
+size_t DescriptorRefreshTracker::numStale() const { return num_stale_; }
+
+size_t DescriptorRefreshTracker::numRoots() const { return roots_.size(); }
+
+}  // namespace lcd
+}  // namespace hydra
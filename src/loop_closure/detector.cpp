@@ -41,7 +41,11 @@
 
 #include <glog/logging.h>
 
+#include <atomic>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 #include "hydra/utils/timing_utilities.h"
 
@@ -70,6 +74,23 @@ std::string showVector(const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>& vector,
 }
 
 #if defined(HYDRA_USE_GNN) && HYDRA_USE_GNN
+std::string selectGnnModel(const std::string& model_path,
+                           const std::string& quantized_path,
+                           bool use_quantized) {
+  if (!use_quantized) {
+    return model_path;
+  }
+
+  if (quantized_path.empty()) {
+    LOG(WARNING) << "No quantized model provided for " << model_path
+                 << ". Using original model";
+    return model_path;
+  }
+
+  LOG(INFO) << "Using quantized model " << quantized_path << " for " << model_path;
+  return quantized_path;
+}
+
 void configureDescriptorFactories(lcd::LcdDetector& detector,
                                   const LcdDetectorConfig& config) {
   ObjectGnnDescriptor::LabelEmbeddings embeddings;
@@ -83,19 +104,46 @@ void configureDescriptorFactories(lcd::LcdDetector& detector,
     embeddings = loadLabelEmbeddings(config.gnn_lcd.label_embeddings_file);
   }
 
+  // only applied if no other model has been loaded yet in this process
+  gnn::RuntimeConfig runtime_config;
+  runtime_config.use_global_thread_pools = config.gnn_lcd.use_global_thread_pools;
+  runtime_config.global_intra_op_threads = config.gnn_lcd.num_intra_op_threads;
+  runtime_config.global_inter_op_threads = config.gnn_lcd.num_inter_op_threads;
+  gnn::configureRuntime(runtime_config);
+
+  gnn::SessionConfig session_config;
+  session_config.intra_op_threads = config.gnn_lcd.num_intra_op_threads;
+  session_config.inter_op_threads = config.gnn_lcd.num_inter_op_threads;
+  session_config.optimization_level = config.gnn_lcd.optimization_level;
+  session_config.cache_optimized_model = config.gnn_lcd.cache_optimized_models;
+  session_config.optimized_model_dir = config.gnn_lcd.optimized_model_dir;
+
+  const auto& gnn_config = config.gnn_lcd;
+  auto objects = std::make_unique<ObjectGnnDescriptor>(
+      selectGnnModel(gnn_config.object_model_path,
+                     gnn_config.quantized_object_model_path,
+                     gnn_config.use_quantized_models),
+      config.object_extraction,
+      gnn_config.object_connection_radius_m,
+      embeddings,
+      gnn_config.objects_pos_in_feature,
+      session_config);
+  auto places = std::make_unique<PlaceGnnDescriptor>(
+      selectGnnModel(gnn_config.places_model_path,
+                     gnn_config.quantized_places_model_path,
+                     gnn_config.use_quantized_models),
+      config.places_extraction,
+      gnn_config.places_pos_in_feature,
+      session_config);
+
+  if (!gnn_config.input_log_dir.empty()) {
+    objects->logInputs(gnn_config.input_log_dir + "/objects");
+    places->logInputs(gnn_config.input_log_dir + "/places");
+  }
+
   LcdDetector::FactoryMap factories;
-  factories.emplace(
-      DsgLayers::OBJECTS,
-      std::make_unique<ObjectGnnDescriptor>(config.gnn_lcd.object_model_path,
-                                            config.object_extraction,
-                                            config.gnn_lcd.object_connection_radius_m,
-                                            embeddings,
-                                            config.gnn_lcd.objects_pos_in_feature));
-  factories.emplace(
-      DsgLayers::PLACES,
-      std::make_unique<PlaceGnnDescriptor>(config.gnn_lcd.places_model_path,
-                                           config.places_extraction,
-                                           config.gnn_lcd.places_pos_in_feature));
+  factories.emplace(DsgLayers::OBJECTS, std::move(objects));
+  factories.emplace(DsgLayers::PLACES, std::move(places));
   detector.setDescriptorFactories(std::move(factories));
 }
 #else
@@ -107,7 +155,10 @@ void configureDescriptorFactories(lcd::LcdDetector&, const LcdDetectorConfig&) {
 using DsgNode = DynamicSceneGraphNode;
 using hydra::timing::ScopedTimer;
 
-LcdDetector::LcdDetector(const LcdDetectorConfig& config) : config_(config) {
+LcdDetector::LcdDetector(const LcdDetectorConfig& config)
+    : config_(config),
+      subgraph_cache_(std::make_shared<SubgraphCache>()),
+      refresh_tracker_(config.descriptor_refresh) {
   for (const auto& id_func_pair : layer_factories_) {
     cache_map_[id_func_pair.first] = DescriptorCache();
   }
@@ -131,6 +182,10 @@ void LcdDetector::setRegistrationSolver(size_t level,
     return;
   }
 
+  if (solver) {
+    solver->subgraph_cache = subgraph_cache_;
+  }
+
   registration_solvers_[level] = std::move(solver);
 }
 
@@ -162,6 +217,10 @@ const std::map<size_t, LayerSearchResults>& LcdDetector::getLatestMatches() cons
   return matches_;
 }
 
+const std::map<size_t, SearchStageStats>& LcdDetector::getSearchStats() const {
+  return search_stats_;
+}
+
 const std::map<LayerId, size_t>& LcdDetector::getLayerRemapping() const {
   return layer_to_internal_index_;
 }
@@ -170,6 +229,19 @@ const DescriptorCache& LcdDetector::getDescriptorCache(LayerId layer) {
   return cache_map_.at(layer);
 }
 
+void LcdDetector::resetSubgraphCache() {
+  VLOG(3) << "[DSG LCD] Subgraph cache: " << subgraph_cache_->numHits() << " hits, "
+          << subgraph_cache_->numMisses() << " misses, " << subgraph_cache_->size()
+          << " entries";
+  subgraph_cache_->clear();
+}
+
+const SubgraphCache& LcdDetector::getSubgraphCache() const { return *subgraph_cache_; }
+
+const DescriptorRefreshTracker& LcdDetector::getRefreshTracker() const {
+  return refresh_tracker_;
+}
+
 void LcdDetector::dumpDescriptors(const std::string& log_path) const {
   const Eigen::IOFormat format(
       Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", ", ", "", "", "[", "]");
@@ -207,20 +279,37 @@ void LcdDetector::dumpDescriptors(const std::string& log_path) const {
 }
 
 void LcdDetector::makeDefaultDescriptorFactories() {
-  layer_factories_.emplace(
-      DsgLayers::OBJECTS,
-      std::make_unique<ObjectDescriptorFactory>(config_.object_extraction,
-                                                config_.num_semantic_classes));
-  layer_factories_.emplace(
-      DsgLayers::PLACES,
-      std::make_unique<PlaceDescriptorFactory>(config_.places_extraction,
-                                               config_.place_histogram_config));
-  agent_factory_ = std::make_unique<AgentDescriptorFactory>();
+  const auto& scales = config_.descriptor_scales_m;
+  if (scales.empty()) {
+    layer_factories_.emplace(
+        DsgLayers::OBJECTS,
+        std::make_unique<ObjectDescriptorFactory>(config_.object_extraction,
+                                                  config_.num_semantic_classes));
+    layer_factories_.emplace(
+        DsgLayers::PLACES,
+        std::make_unique<PlaceDescriptorFactory>(config_.places_extraction,
+                                                 config_.place_histogram_config));
+  } else {
+    layer_factories_.emplace(
+        DsgLayers::OBJECTS,
+        std::make_unique<MultiScaleObjectDescriptorFactory>(
+            config_.object_extraction, scales, config_.num_semantic_classes));
+    layer_factories_.emplace(
+        DsgLayers::PLACES,
+        std::make_unique<MultiScalePlaceDescriptorFactory>(
+            config_.places_extraction, scales, config_.place_histogram_config));
+  }
+
+  agent_factory_ = std::make_unique<AgentDescriptorFactory>(config_.compress_agent_bow);
+  agent_factory_->subgraph_cache = subgraph_cache_;
 }
 
 void LcdDetector::resetLayerAssignments() {
   // TODO(nathan) this is messy
   registration_solvers_.clear();
+  for (auto& id_factory_pair : layer_factories_) {
+    id_factory_pair.second->subgraph_cache = subgraph_cache_;
+  }
 
   size_t internal_idx = 1;  // agent is 0
   for (const auto& id_config_pair : config_.search_configs) {
@@ -237,9 +326,10 @@ void LcdDetector::resetLayerAssignments() {
 
     auto iter = config_.registration_configs.find(layer);
     if (iter != config_.registration_configs.end()) {
-      registration_solvers_.emplace(internal_idx,
-                                    std::make_unique<DsgTeaserSolver>(
-                                        layer, iter->second, config_.teaser_config));
+      auto solver = std::make_unique<DsgTeaserSolver>(
+          layer, iter->second, config_.teaser_config);
+      solver->subgraph_cache = subgraph_cache_;
+      registration_solvers_.emplace(internal_idx, std::move(solver));
     }
 
     internal_idx++;
@@ -252,37 +342,109 @@ void LcdDetector::resetLayerAssignments() {
   match_config_map_[0] = config_.agent_search_config;
 }
 
-bool LcdDetector::addNewDescriptors(const DynamicSceneGraph& graph,
-                                    const DynamicSceneGraphNode& agent_node) {
-  auto parent = agent_node.getParent();
-  if (!parent) {
-    return false;
+struct DescriptorTask {
+  const DynamicSceneGraphNode* agent_node;
+  NodeId root;
+  const DescriptorFactory* factory;
+  std::optional<LayerId> layer;  // unset for agent descriptors
+  Descriptor::Ptr descriptor;
+};
+
+void constructDescriptors(const DynamicSceneGraph& graph,
+                          const LcdDetectorConfig& config,
+                          std::vector<DescriptorTask>& tasks) {
+  std::map<LayerId, size_t> sketch_bits;
+  for (const auto& id_config_pair : config.search_configs) {
+    sketch_bits[id_config_pair.first] = id_config_pair.second.sketch_bits;
   }
 
-  if (!root_leaf_map_.count(*parent)) {
-    root_leaf_map_[*parent] = std::set<NodeId>();
+  // construct descriptors in parallel against the (unchanging) graph
+  std::atomic<size_t> next_task(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto worker = [&]() {
+    size_t index;
+    while ((index = next_task++) < tasks.size()) {
+      auto& task = tasks[index];
+      try {
+        task.descriptor = task.factory->construct(graph, *task.agent_node);
+        if (task.layer && task.descriptor) {
+          auto iter = sketch_bits.find(*task.layer);
+          if (iter != sketch_bits.end()) {
+            computeDescriptorSketch(*task.descriptor, iter->second);
+          }
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        error = std::current_exception();
+      }
+    }
+  };
+
+  size_t num_threads = config.num_descriptor_threads;
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
   }
+  num_threads = std::max<size_t>(1, std::min(num_threads, tasks.size()));
 
-  root_leaf_map_[*parent].insert(agent_node.id);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
 
-  if (!leaf_cache_.count(*parent)) {
-    leaf_cache_[*parent] = DescriptorCache();
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
   }
 
-  leaf_cache_[*parent][agent_node.id] = agent_factory_->construct(graph, agent_node);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
 
-  for (const auto& prefix_func_pair : layer_factories_) {
-    if (cache_map_[prefix_func_pair.first].count(*parent)) {
+void LcdDetector::addNewDescriptors(const DynamicSceneGraph& graph,
+                                    const std::set<NodeId>& agent_nodes) {
+  // plan every descriptor up front in agent (and therefore root) order
+  std::vector<DescriptorTask> tasks;
+  std::map<LayerId, std::set<NodeId>> scheduled;
+  for (const auto& agent_id : agent_nodes) {
+    const DynamicSceneGraphNode& agent_node = graph.getDynamicNode(agent_id).value();
+    auto parent = agent_node.getParent();
+    if (!parent) {
       continue;
     }
 
-    // guaranteed to exist by constructor
-    Descriptor::Ptr layer_descriptor =
-        prefix_func_pair.second->construct(graph, agent_node);
-    cache_map_[prefix_func_pair.first][*parent] = std::move(layer_descriptor);
+    const auto agent_factory = agent_factory_.get();
+    tasks.push_back({&agent_node, *parent, agent_factory, std::nullopt, nullptr});
+    for (const auto& prefix_func_pair : layer_factories_) {
+      const auto layer = prefix_func_pair.first;
+      if (cache_map_[layer].count(*parent) || scheduled[layer].count(*parent)) {
+        continue;
+      }
+
+      scheduled[layer].insert(*parent);
+      tasks.push_back(
+          {&agent_node, *parent, prefix_func_pair.second.get(), layer, nullptr});
+    }
   }
 
-  return true;
+  constructDescriptors(graph, config_, tasks);
+
+  // commit in plan order so the caches do not depend on scheduling
+  for (auto& task : tasks) {
+    if (task.layer) {
+      if (*task.layer == root_layer_ && task.descriptor) {
+        refresh_tracker_.addRoot(task.root, task.descriptor->root_position);
+      }
+
+      cache_map_[*task.layer][task.root] = std::move(task.descriptor);
+      continue;
+    }
+
+    const auto agent_id = task.agent_node->id;
+    root_leaf_map_[task.root].insert(agent_id);
+    leaf_cache_[task.root][agent_id] = std::move(task.descriptor);
+  }
 }
 
 void LcdDetector::updateDescriptorCache(
@@ -307,10 +469,162 @@ void LcdDetector::updateDescriptorCache(
     }
   }
 
-  for (const auto& agent_node : new_agent_nodes) {
-    const DynamicSceneGraphNode& node = dsg.getDynamicNode(agent_node).value();
-    addNewDescriptors(dsg, node);
+  addNewDescriptors(dsg, new_agent_nodes);
+
+  const size_t num_evicted = evictDescriptors();
+  VLOG_IF(1, num_evicted > 0) << "Evicted " << num_evicted << " descriptors ("
+                              << numDescriptors() << " remaining)";
+}
+
+size_t LcdDetector::evictDescriptors() {
+  const auto& config = config_.descriptor_cache;
+  if (config.capacity.empty()) {
+    return 0;
   }
+
+  // evict from the root layer first, as that removes the root from every layer
+  std::vector<LayerId> layers;
+  if (config.capacity.count(root_layer_)) {
+    layers.push_back(root_layer_);
+  }
+
+  for (const auto& layer_capacity_pair : config.capacity) {
+    if (layer_capacity_pair.first != root_layer_) {
+      layers.push_back(layer_capacity_pair.first);
+    }
+  }
+
+  size_t num_evicted = 0;
+  for (const auto layer : layers) {
+    auto iter = cache_map_.find(layer);
+    if (iter == cache_map_.end()) {
+      continue;
+    }
+
+    auto search_iter = config_.search_configs.find(layer);
+    const auto score_type = search_iter == config_.search_configs.end()
+                                ? DescriptorScoreType::L1
+                                : search_iter->second.type;
+    const auto to_evict = selectDescriptorsToEvict(iter->second,
+                                                   config.capacity.at(layer),
+                                                   config,
+                                                   score_type,
+                                                   match_counts_[layer]);
+    for (const auto root : to_evict) {
+      removeDescriptor(layer, root);
+    }
+
+    num_evicted += to_evict.size();
+  }
+
+  return num_evicted;
+}
+
+void LcdDetector::removeDescriptor(LayerId layer, NodeId root) {
+  if (layer != root_layer_) {
+    cache_map_[layer].erase(root);
+    match_counts_[layer].erase(root);
+    return;
+  }
+
+  // searches start from the root layer, so nothing else can reach the root
+  for (auto& id_cache_pair : cache_map_) {
+    id_cache_pair.second.erase(root);
+  }
+
+  for (auto& id_count_pair : match_counts_) {
+    id_count_pair.second.erase(root);
+  }
+
+  leaf_cache_.erase(root);
+  root_leaf_map_.erase(root);
+  refresh_tracker_.removeRoot(root);
+}
+
+size_t LcdDetector::markChangedNodes(const DynamicSceneGraph& dsg,
+                                     const std::unordered_set<NodeId>& nodes) {
+  if (!refresh_tracker_.enabled()) {
+    return 0;
+  }
+
+  size_t num_marked = 0;
+  for (const auto node_id : nodes) {
+    auto node_opt = dsg.getNode(node_id);
+    if (!node_opt) {
+      continue;
+    }
+
+    num_marked += refresh_tracker_.markChanged(node_opt->get().attributes().position);
+  }
+
+  VLOG_IF(3, num_marked > 0) << "[DSG LCD] Marked " << num_marked
+                             << " descriptor roots as stale ("
+                             << refresh_tracker_.numStale() << " total)";
+  return num_marked;
+}
+
+size_t LcdDetector::refreshDescriptors(const DynamicSceneGraph& dsg,
+                                       uint64_t timestamp) {
+  const auto to_refresh = refresh_tracker_.popStaleRoots(timestamp);
+  if (to_refresh.empty()) {
+    return 0;
+  }
+
+  ScopedTimer timer("lcd/refresh_descriptors", timestamp, true, 2, false);
+
+  std::vector<DescriptorTask> tasks;
+  for (const auto root : to_refresh) {
+    auto leaf_iter = root_leaf_map_.find(root);
+    if (!dsg.hasNode(root) || leaf_iter == root_leaf_map_.end()) {
+      continue;
+    }
+
+    // descriptors are constructed from an agent node, so pick any that is still
+    // attached to the root
+    const DynamicSceneGraphNode* agent_node = nullptr;
+    for (const auto agent_id : leaf_iter->second) {
+      auto node_opt = dsg.getDynamicNode(agent_id);
+      if (node_opt && node_opt->get().getParent() == root) {
+        agent_node = &node_opt->get();
+        break;
+      }
+    }
+
+    if (!agent_node) {
+      continue;
+    }
+
+    for (const auto& id_factory_pair : layer_factories_) {
+      const auto layer = id_factory_pair.first;
+      auto cache_iter = cache_map_.find(layer);
+      if (cache_iter == cache_map_.end() || !cache_iter->second.count(root)) {
+        continue;  // evicted descriptors stay evicted
+      }
+
+      tasks.push_back({agent_node, root, id_factory_pair.second.get(), layer, nullptr});
+    }
+  }
+
+  constructDescriptors(dsg, config_, tasks);
+
+  // swap in place so match counts and eviction state carry over
+  std::set<NodeId> refreshed;
+  for (auto& task : tasks) {
+    if (!task.descriptor) {
+      continue;  // keep the previous descriptor
+    }
+
+    if (*task.layer == root_layer_) {
+      refresh_tracker_.addRoot(task.root, task.descriptor->root_position);
+    }
+
+    cache_map_[*task.layer][task.root] = std::move(task.descriptor);
+    refreshed.insert(task.root);
+  }
+
+  VLOG(2) << "[DSG LCD] Refreshed " << refreshed.size() << " of " << to_refresh.size()
+          << " stale roots (" << refresh_tracker_.numStale() << " remaining)";
+  return refreshed.size();
 }
 
 std::vector<DsgRegistrationSolution> LcdDetector::registerAndVerify(
@@ -410,6 +724,7 @@ std::vector<DsgRegistrationSolution> LcdDetector::detect(const DynamicSceneGraph
     auto descriptor = layer_factories_[layer]->construct(dsg, latest_node);
     if (descriptor) {
       VLOG(2) << "level " << idx << ": " << showVector(descriptor->values, 3, 20, 9);
+      computeDescriptorSketch(*descriptor, config.sketch_bits);
       matches_[idx] = searchDescriptors(*descriptor,
                                         config,
                                         prev_valid_roots,
@@ -433,6 +748,20 @@ std::vector<DsgRegistrationSolution> LcdDetector::detect(const DynamicSceneGraph
                                         agent_id);
   }
 
+  for (const auto& id_match_pair : matches_) {
+    search_stats_[id_match_pair.first] += id_match_pair.second.stats;
+    VLOG(2) << "level " << id_match_pair.first
+            << " search: " << id_match_pair.second.stats;
+    if (id_match_pair.first == 0) {
+      continue;
+    }
+
+    auto& counts = match_counts_[internal_index_to_layer_.at(id_match_pair.first)];
+    for (const auto root : id_match_pair.second.match_root) {
+      ++counts[root];
+    }
+  }
+
   if (matches_.empty()) {
     VLOG(1) << "No LCD matches for node " << NodeSymbol(agent_id).getLabel()
             << " against " << numDescriptors() << " descriptors";
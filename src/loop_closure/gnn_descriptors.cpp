@@ -38,6 +38,10 @@
 #include <yaml-cpp/yaml.h>
 
 #include <deque>
+#include <filesystem>
+#include <iomanip>
+
+#include "hydra/gnn/tensor_io.h"
 
 namespace hydra {
 namespace lcd {
@@ -45,11 +49,54 @@ namespace lcd {
 using Dsg = DynamicSceneGraph;
 using DsgNode = DynamicSceneGraphNode;
 
+inline gnn::Tensor& getInputBuffer(gnn::TensorMap& input,
+                                   const std::string& name,
+                                   int64_t rows,
+                                   int64_t cols,
+                                   gnn::Tensor::Type type) {
+  auto iter = input.find(name);
+  if (iter == input.end() || iter->second.type() != type) {
+    iter = input.insert_or_assign(name, gnn::Tensor(rows, cols, type)).first;
+    return iter->second;
+  }
+
+  iter->second.resize(rows, cols);
+  return iter->second;
+}
+
+inline void setupInputLog(const std::string& directory) {
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+  if (ec) {
+    LOG(ERROR) << "Unable to create input log directory " << directory << ": "
+               << ec.message();
+  }
+}
+
+inline void logInput(const std::string& directory,
+                     size_t& num_logged,
+                     const gnn::TensorMap& input) {
+  if (directory.empty()) {
+    return;
+  }
+
+  std::stringstream ss;
+  ss << directory << "/" << std::setfill('0') << std::setw(6) << num_logged
+     << ".tensors";
+  if (!gnn::saveTensorMap(ss.str(), input)) {
+    LOG(WARNING) << "Unable to save GNN input to " << ss.str();
+    return;
+  }
+
+  ++num_logged;
+}
+
 ObjectGnnDescriptor::ObjectGnnDescriptor(const std::string& model_path,
                                          const SubgraphConfig& config,
                                          double max_edge_distance_m,
                                          const LabelEmbeddings& label_embeddings,
-                                         bool use_pos_in_feature)
+                                         bool use_pos_in_feature,
+                                         const gnn::SessionConfig& session_config)
     : config_(config),
       max_edge_distance_m_(max_edge_distance_m),
       label_embeddings_(label_embeddings),
@@ -70,19 +117,33 @@ ObjectGnnDescriptor::ObjectGnnDescriptor(const std::string& model_path,
     }
   }
 
-  model_.reset(new gnn::GnnInterface(model_path));
+  model_.reset(new gnn::GnnInterface(model_path, {}, session_config));
+}
+
+void ObjectGnnDescriptor::logInputs(const std::string& directory) {
+  input_log_dir_ = directory;
+  setupInputLog(input_log_dir_);
 }
 
 gnn::TensorMap ObjectGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
                                               const std::set<NodeId>& nodes) const {
+  gnn::TensorMap input;
+  makeInput(graph, nodes, input);
+  return input;
+}
+
+void ObjectGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
+                                    const std::set<NodeId>& nodes,
+                                    gnn::TensorMap& input) const {
+  const auto float_type = gnn::Tensor::Type::FLOAT32;
   const size_t feature_size = label_embedding_size_ + (use_pos_in_feature_ ? 6 : 3);
-  gnn::Tensor x(nodes.size(), feature_size, gnn::Tensor::Type::FLOAT32);
+  auto& x = getInputBuffer(input, "x", nodes.size(), feature_size, float_type);
   auto x_map = x.map<float>();
 
-  gnn::Tensor pos;
-  if (!use_pos_in_feature_) {
-    pos = gnn::Tensor(nodes.size(), 3, gnn::Tensor::Type::FLOAT32);
-  }
+  // pos is only written to when positions are not part of the node features
+  auto& pos = use_pos_in_feature_
+                  ? x
+                  : getInputBuffer(input, "pos", nodes.size(), 3, float_type);
   auto pos_map = pos.map<float>();
 
   size_t index = 0;
@@ -113,7 +174,7 @@ gnn::TensorMap ObjectGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
     ++index;
   }
 
-  std::list<std::pair<int64_t, int64_t>> edges;
+  std::vector<std::pair<int64_t, int64_t>> edges;
   for (const auto& source : nodes) {
     const auto source_position = graph.getPosition(source);
     for (const auto& target : nodes) {
@@ -131,7 +192,8 @@ gnn::TensorMap ObjectGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
   }
 
   // note that edges is built in an undirected manner, so edges.size() = 2 * |E|
-  gnn::Tensor edge_index(2, edges.size(), gnn::Tensor::Type::INT64);
+  auto& edge_index =
+      getInputBuffer(input, "edge_index", 2, edges.size(), gnn::Tensor::Type::INT64);
   auto edge_map = edge_index.map<int64_t>();
   size_t edge_idx = 0;
   for (const auto& edge : edges) {
@@ -139,12 +201,6 @@ gnn::TensorMap ObjectGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
     edge_map(1, edge_idx) = edge.second;
     ++edge_idx;
   }
-
-  if (use_pos_in_feature_) {
-    return {{"x", x}, {"edge_index", edge_index}};
-  } else {
-    return {{"x", x}, {"edge_index", edge_index}, {"pos", pos}};
-  }
 }
 
 Descriptor::Ptr ObjectGnnDescriptor::construct(const Dsg& graph,
@@ -156,7 +212,9 @@ Descriptor::Ptr ObjectGnnDescriptor::construct(const Dsg& graph,
 
   auto descriptor = std::make_unique<Descriptor>();
   descriptor->normalized = false;
-  descriptor->nodes = getSubgraphNodes(config_, graph, *parent, false);
+  descriptor->nodes =
+      getSubgraphGeometry(config_, graph, *parent, false, subgraph_cache.get())
+          ->nodeSet();
   descriptor->root_node = *parent;
   descriptor->root_position = graph.getPosition(*parent);
   descriptor->timestamp = agent_node.timestamp;
@@ -166,7 +224,10 @@ Descriptor::Ptr ObjectGnnDescriptor::construct(const Dsg& graph,
     return descriptor;
   }
 
-  auto input = makeInput(graph, descriptor->nodes);
+  // input buffers are reused between calls and only grow to the largest subgraph
+  auto buffers = input_buffers_.acquire();
+  auto& input = *buffers;
+  makeInput(graph, descriptor->nodes, input);
   VLOG(20) << "Inputs:";
   VLOG(20) << "  - x: " << std::endl << input.at("x").map<float>();
   VLOG(20) << "  - edge_index: " << std::endl << input.at("edge_index").map<int64_t>();
@@ -174,30 +235,50 @@ Descriptor::Ptr ObjectGnnDescriptor::construct(const Dsg& graph,
     VLOG(20) << "  - pos: " << std::endl << input.at("pos").map<float>();
   }
 
-  auto output = (*model_)(input).at("output");
+  if (!input_log_dir_.empty()) {
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    logInput(input_log_dir_, num_logged_inputs_, input);
+  }
+
+  // output is written directly into the descriptor
+  (*model_)(input, "output", descriptor->values);
   VLOG(20) << "--------------------------------------";
-  VLOG(20) << "Output type: " << output;
-  VLOG(20) << "Output:" << std::endl << output.map<float>();
-  descriptor->values = output.map<float>().transpose();
+  VLOG(20) << "Output:" << std::endl << descriptor->values.transpose();
   return descriptor;
 }
 
 PlaceGnnDescriptor::PlaceGnnDescriptor(const std::string& model_path,
                                        const SubgraphConfig& config,
-                                       bool use_pos_in_feature)
+                                       bool use_pos_in_feature,
+                                       const gnn::SessionConfig& session_config)
     : config_(config), use_pos_in_feature_(use_pos_in_feature) {
-  model_.reset(new gnn::GnnInterface(model_path));
+  model_.reset(new gnn::GnnInterface(model_path, {}, session_config));
+}
+
+void PlaceGnnDescriptor::logInputs(const std::string& directory) {
+  input_log_dir_ = directory;
+  setupInputLog(input_log_dir_);
 }
 
 gnn::TensorMap PlaceGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
                                              const std::set<NodeId>& nodes) const {
-  gnn::Tensor x(nodes.size(), use_pos_in_feature_ ? 5 : 2, gnn::Tensor::Type::FLOAT32);
+  gnn::TensorMap input;
+  makeInput(graph, nodes, input);
+  return input;
+}
+
+void PlaceGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
+                                   const std::set<NodeId>& nodes,
+                                   gnn::TensorMap& input) const {
+  const auto float_type = gnn::Tensor::Type::FLOAT32;
+  const size_t feature_size = use_pos_in_feature_ ? 5 : 2;
+  auto& x = getInputBuffer(input, "x", nodes.size(), feature_size, float_type);
   auto x_map = x.map<float>();
 
-  gnn::Tensor pos;
-  if (!use_pos_in_feature_) {
-    pos = gnn::Tensor(nodes.size(), 3, gnn::Tensor::Type::FLOAT32);
-  }
+  // pos is only written to when positions are not part of the node features
+  auto& pos = use_pos_in_feature_
+                  ? x
+                  : getInputBuffer(input, "pos", nodes.size(), 3, float_type);
   auto pos_map = pos.map<float>();
 
   size_t index = 0;
@@ -217,7 +298,7 @@ gnn::TensorMap PlaceGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
     ++index;
   }
 
-  std::list<std::pair<int64_t, int64_t>> edges;
+  std::vector<std::pair<int64_t, int64_t>> edges;
   for (const auto source : nodes) {
     const SceneGraphNode& node = *graph.getNode(source);
     for (const auto sibling : node.siblings()) {
@@ -230,7 +311,8 @@ gnn::TensorMap PlaceGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
   }
 
   // note that edges is built in an undirected manner, so edges.size() = 2 * |E|
-  gnn::Tensor edge_index(2, edges.size(), gnn::Tensor::Type::INT64);
+  auto& edge_index =
+      getInputBuffer(input, "edge_index", 2, edges.size(), gnn::Tensor::Type::INT64);
   auto edge_map = edge_index.map<int64_t>();
   size_t edge_idx = 0;
   for (const auto& edge : edges) {
@@ -238,12 +320,6 @@ gnn::TensorMap PlaceGnnDescriptor::makeInput(const DynamicSceneGraph& graph,
     edge_map(1, edge_idx) = edge.second;
     ++edge_idx;
   }
-
-  if (use_pos_in_feature_) {
-    return {{"x", x}, {"edge_index", edge_index}};
-  } else {
-    return {{"x", x}, {"edge_index", edge_index}, {"pos", pos}};
-  }
 }
 
 Descriptor::Ptr PlaceGnnDescriptor::construct(const Dsg& graph,
@@ -255,7 +331,9 @@ Descriptor::Ptr PlaceGnnDescriptor::construct(const Dsg& graph,
 
   auto descriptor = std::make_unique<Descriptor>();
   descriptor->normalized = false;
-  descriptor->nodes = getSubgraphNodes(config_, graph, *parent, true);
+  descriptor->nodes =
+      getSubgraphGeometry(config_, graph, *parent, true, subgraph_cache.get())
+          ->nodeSet();
   descriptor->root_node = *parent;
   descriptor->root_position = graph.getPosition(*parent);
   descriptor->timestamp = agent_node.timestamp;
@@ -264,7 +342,10 @@ Descriptor::Ptr PlaceGnnDescriptor::construct(const Dsg& graph,
     return nullptr;
   }
 
-  auto input = makeInput(graph, descriptor->nodes);
+  // input buffers are reused between calls and only grow to the largest subgraph
+  auto buffers = input_buffers_.acquire();
+  auto& input = *buffers;
+  makeInput(graph, descriptor->nodes, input);
   VLOG(20) << "Inputs:";
   VLOG(20) << "  - x: " << std::endl << input.at("x").map<float>();
   VLOG(20) << "  - edge_index: " << std::endl << input.at("edge_index").map<int64_t>();
@@ -272,11 +353,15 @@ Descriptor::Ptr PlaceGnnDescriptor::construct(const Dsg& graph,
     VLOG(20) << "  - pos: " << std::endl << input.at("pos").map<float>();
   }
 
-  auto output = (*model_)(input).at("output");
+  if (!input_log_dir_.empty()) {
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    logInput(input_log_dir_, num_logged_inputs_, input);
+  }
+
+  // output is written directly into the descriptor
+  (*model_)(input, "output", descriptor->values);
   VLOG(20) << "--------------------------------------";
-  VLOG(20) << "Output type: " << output;
-  VLOG(20) << "Output:" << std::endl << output.map<float>();
-  descriptor->values = output.map<float>().transpose();
+  VLOG(20) << "Output:" << std::endl << descriptor->values.transpose();
   return descriptor;
 }
 
@@ -43,6 +43,7 @@
 namespace hydra {
 
 using hydra::timing::ScopedTimer;
+using hydra::timing::TimedLock;
 using lcd::LayerRegistrationConfig;
 
 LoopClosureModule::LoopClosureModule(const RobotPrefixConfig& prefix,
@@ -132,7 +133,7 @@ void LoopClosureModule::spinOnceImpl(bool force_update) {
   const size_t timestamp_ns = processFrontendOutput();
 
   {  // start critical section
-    std::unique_lock<std::mutex> lock(dsg_->mutex);
+    TimedLock lock(dsg_->mutex, "lcd/shared_dsg_lock", timestamp_ns);
     if (!force_update && timestamp_ns < dsg_->last_update_time) {
       return;
     }
@@ -143,6 +144,13 @@ void LoopClosureModule::spinOnceImpl(bool force_update) {
     CHECK_EQ(lcd_graph_->numEdges(false), dsg_->graph->numEdges(false));
   }  // end critical section
 
+  // node positions may have changed after the merge
+  lcd_detector_->resetSubgraphCache();
+
+  lcd_detector_->markChangedNodes(*lcd_graph_, changed_nodes_);
+  changed_nodes_.clear();
+  lcd_detector_->refreshDescriptors(*lcd_graph_, timestamp_ns);
+
   auto query_agent = getQueryAgentId(timestamp_ns);
   while (query_agent) {
     const Eigen::Vector3d query_pos = lcd_graph_->getPosition(*query_agent);
@@ -179,6 +187,10 @@ size_t LoopClosureModule::processFrontendOutput() {
                                    msg->archived_places.begin(),
                                    msg->archived_places.end());
 
+  // archived places and objects change the neighborhood of nearby descriptors
+  changed_nodes_.insert(msg->archived_places.begin(), msg->archived_places.end());
+  changed_nodes_.insert(msg->archived_objects.begin(), msg->archived_objects.end());
+
   VLOG(5) << "[Hydra LCD] Adding nodes: "
           << displayNodeSymbolContainer(msg->new_agent_nodes);
   for (const auto& node : msg->new_agent_nodes) {
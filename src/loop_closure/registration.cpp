@@ -34,8 +34,12 @@
  * -------------------------------------------------------------------------- */
 #include "hydra/loop_closure/registration.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <random>
+#include <unordered_map>
 
 #include "hydra/utils/timing_utilities.h"
 
@@ -167,6 +171,328 @@ void logRegistrationProblem(const std::string& path_prefix,
   // TODO(nathan) output position data
 }
 
+LayerRegistrationSolution solveLayerRegistration(
+    const LayerRegistrationConfig& config,
+    teaser::RobustRegistrationSolver& solver,
+    LayerId layer_id,
+    const std::vector<std::pair<NodeId, NodeId>>& correspondences,
+    const Eigen::Matrix<double, 3, Eigen::Dynamic>& src_points,
+    const Eigen::Matrix<double, 3, Eigen::Dynamic>& dest_points,
+    size_t num_src_nodes,
+    size_t num_dest_nodes) {
+  if (correspondences.size() < config.min_correspondences) {
+    VLOG(2) << "not enough correspondences for registration at layer " << layer_id
+            << ": " << correspondences.size() << " / " << config.min_correspondences;
+    return {};
+  }
+
+  VLOG(20) << "=======================================================";
+  VLOG(20) << "Source: " << std::endl << src_points;
+  VLOG(20) << "Dest: " << std::endl << dest_points;
+
+  VLOG(1) << "[DSG LCD] Registering layer " << layer_id << " with "
+          << correspondences.size() << " correspondences out of " << num_src_nodes
+          << " source and " << num_dest_nodes << " destination nodes";
+
+  auto params = solver.getParams();
+  solver.reset(params);
+
+  teaser::RegistrationSolution result = solver.solve(src_points, dest_points);
+  if (!result.valid) {
+    return {};
+  }
+
+  std::vector<std::pair<NodeId, NodeId>> valid_correspondences;
+  valid_correspondences.reserve(std::min(num_src_nodes, num_dest_nodes));
+
+  auto inliers = solver.getInlierMaxClique();
+  if (inliers.size() < config.min_inliers) {
+    VLOG(2) << "[DSG LCD] Not enough inliers for registration at layer " << layer_id
+            << ": " << inliers.size() << " / " << config.min_inliers;
+    return {};
+  }
+
+  for (const auto& index : inliers) {
+    CHECK_LT(static_cast<size_t>(index), correspondences.size());
+    valid_correspondences.push_back(correspondences.at(index));
+  }
+
+  return {true,
+          gtsam::Pose3(gtsam::Rot3(result.rotation), result.translation),
+          valid_correspondences};
+}
+
+LayerRegistrationSolution registerDsgLayer(const LayerRegistrationConfig& config,
+                                           teaser::RobustRegistrationSolver& solver,
+                                           LayerId layer_id,
+                                           const SubgraphGeometry& src,
+                                           const SubgraphGeometry& dest,
+                                           bool match_labels) {
+  std::vector<std::pair<size_t, size_t>> indices;
+  indices.reserve(src.size() * dest.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    for (size_t j = 0; j < dest.size(); ++j) {
+      if (!match_labels || src.labels[i] == dest.labels[j]) {
+        indices.emplace_back(i, j);
+      }
+    }
+  }
+
+  std::vector<std::pair<NodeId, NodeId>> correspondences(indices.size());
+  Eigen::Matrix<double, 3, Eigen::Dynamic> src_points(3, indices.size());
+  Eigen::Matrix<double, 3, Eigen::Dynamic> dest_points(3, indices.size());
+  for (size_t k = 0; k < indices.size(); ++k) {
+    const auto [i, j] = indices[k];
+    correspondences[k] = {src.nodes[i], dest.nodes[j]};
+    src_points.col(k) = src.positions.col(i);
+    dest_points.col(k) = dest.positions.col(j);
+  }
+
+  return solveLayerRegistration(config,
+                                solver,
+                                layer_id,
+                                correspondences,
+                                src_points,
+                                dest_points,
+                                src.size(),
+                                dest.size());
+}
+
+void PreVerificationStats::record(PreVerificationResult result) {
+  ++num_checked;
+  switch (result) {
+    case PreVerificationResult::HISTOGRAM_REJECTED:
+      ++num_histogram_rejected;
+      break;
+    case PreVerificationResult::TRIANGLE_REJECTED:
+      ++num_triangle_rejected;
+      break;
+    case PreVerificationResult::ACCEPTED:
+    default:
+      ++num_accepted;
+      break;
+  }
+}
+
+PreVerificationStats& PreVerificationStats::operator+=(
+    const PreVerificationStats& other) {
+  num_checked += other.num_checked;
+  num_histogram_rejected += other.num_histogram_rejected;
+  num_triangle_rejected += other.num_triangle_rejected;
+  num_accepted += other.num_accepted;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& out, const PreVerificationStats& stats) {
+  out << "checked: " << stats.num_checked
+      << ", histogram rejected: " << stats.num_histogram_rejected
+      << ", triangle rejected: " << stats.num_triangle_rejected
+      << ", accepted: " << stats.num_accepted;
+  return out;
+}
+
+Eigen::VectorXd getDistanceHistogram(const PreVerificationConfig& config,
+                                     const SubgraphGeometry& geometry) {
+  Eigen::VectorXd histogram = Eigen::VectorXd::Zero(config.num_bins);
+  const double bin_width = config.max_distance_m / config.num_bins;
+  size_t num_pairs = 0;
+  for (size_t i = 0; i < geometry.size(); ++i) {
+    for (size_t j = i + 1; j < geometry.size(); ++j) {
+      const auto& positions = geometry.positions;
+      const double dist = (positions.col(i) - positions.col(j)).norm();
+      const size_t bin = std::min(static_cast<size_t>(dist / bin_width),
+                                  static_cast<size_t>(config.num_bins - 1));
+      histogram(bin) += 1.0;
+      ++num_pairs;
+    }
+  }
+
+  if (num_pairs) {
+    histogram /= static_cast<double>(num_pairs);
+  }
+
+  return histogram;
+}
+
+double pairwiseDistanceSimilarity(const PreVerificationConfig& config,
+                                  const SubgraphGeometry& src,
+                                  const SubgraphGeometry& dest) {
+  if (src.size() < 2 || dest.size() < 2 || config.num_bins == 0) {
+    return 1.0;
+  }
+
+  const auto src_hist = getDistanceHistogram(config, src);
+  const auto dest_hist = getDistanceHistogram(config, dest);
+  return src_hist.cwiseMin(dest_hist).sum();
+}
+
+/**
+ * @brief Destination vertices of each label sorted by distance to a destination vertex
+ *
+ * Entries are built on first use so that each lookup for a triangle vertex is a
+ * binary search instead of a scan over every vertex with the label.
+ */
+class DestDistanceIndex {
+ public:
+  using Entry = std::pair<double, size_t>;
+  using Range = std::pair<std::vector<Entry>::const_iterator,
+                          std::vector<Entry>::const_iterator>;
+
+  explicit DestDistanceIndex(const SubgraphGeometry& dest) : dest_(dest) {
+    for (size_t i = 0; i < dest_.size(); ++i) {
+      const auto iter = group_lookup_.emplace(dest_.labels[i], groups_.size()).first;
+      if (iter->second == groups_.size()) {
+        groups_.emplace_back();
+      }
+
+      groups_[iter->second].push_back(i);
+    }
+  }
+
+  //! returns nullptr if no destination vertex has the label
+  const std::vector<size_t>* getGroup(SubgraphGeometry::Label label) const {
+    const auto iter = group_lookup_.find(label);
+    return iter == group_lookup_.end() ? nullptr : &groups_[iter->second];
+  }
+
+  //! vertices of the label with a distance to vertex within tolerance of distance
+  Range getNearby(size_t vertex,
+                  SubgraphGeometry::Label label,
+                  double distance,
+                  double tolerance) {
+    const size_t group = group_lookup_.at(label);
+    const size_t key = vertex * groups_.size() + group;
+    auto iter = sorted_.find(key);
+    if (iter == sorted_.end()) {
+      std::vector<Entry> entries;
+      for (const auto other : groups_[group]) {
+        if (other == vertex) {
+          continue;
+        }
+
+        const double dist = (dest_.positions.col(vertex) - dest_.positions.col(other))
+                                .norm();
+        entries.emplace_back(dist, other);
+      }
+
+      std::sort(entries.begin(), entries.end());
+      iter = sorted_.emplace(key, std::move(entries)).first;
+    }
+
+    const auto& entries = iter->second;
+    const Entry lower{distance - tolerance, 0};
+    const Entry upper{distance + tolerance, std::numeric_limits<size_t>::max()};
+    return {std::lower_bound(entries.begin(), entries.end(), lower),
+            std::upper_bound(entries.begin(), entries.end(), upper)};
+  }
+
+ private:
+  const SubgraphGeometry& dest_;
+  std::unordered_map<SubgraphGeometry::Label, size_t> group_lookup_;
+  std::vector<std::vector<size_t>> groups_;
+  std::unordered_map<size_t, std::vector<Entry>> sorted_;
+};
+
+double triangleCongruenceRatio(const PreVerificationConfig& config,
+                               const SubgraphGeometry& src,
+                               const SubgraphGeometry& dest) {
+  if (src.size() < 3 || config.num_triangle_samples == 0) {
+    return 1.0;
+  }
+
+  DestDistanceIndex index(dest);
+  const auto src_dist = [&](size_t i, size_t j) {
+    return (src.positions.col(i) - src.positions.col(j)).norm();
+  };
+  const auto dest_dist = [&](size_t i, size_t j) {
+    return (dest.positions.col(i) - dest.positions.col(j)).norm();
+  };
+
+  std::mt19937 rng(config.seed);
+  std::uniform_int_distribution<size_t> dist(0, src.size() - 1);
+  size_t num_congruent = 0;
+  for (size_t n = 0; n < config.num_triangle_samples; ++n) {
+    const size_t i = dist(rng);
+    size_t j = dist(rng);
+    while (j == i) {
+      j = dist(rng);
+    }
+    size_t k = dist(rng);
+    while (k == i || k == j) {
+      k = dist(rng);
+    }
+
+    const auto& label_j = src.labels[j];
+    const auto& label_k = src.labels[k];
+    const auto group_i = index.getGroup(src.labels[i]);
+    if (!group_i || !index.getGroup(label_j) || !index.getGroup(label_k)) {
+      continue;
+    }
+
+    const double tolerance = config.triangle_tolerance_m;
+    const double d_ij = src_dist(i, j);
+    const double d_ik = src_dist(i, k);
+    const double d_jk = src_dist(j, k);
+    bool found = false;
+    for (const auto a : *group_i) {
+      // both remaining vertices have to be at the right distance from the first
+      const auto b_range = index.getNearby(a, label_j, d_ij, tolerance);
+      if (b_range.first == b_range.second) {
+        continue;
+      }
+
+      const auto c_range = index.getNearby(a, label_k, d_ik, tolerance);
+      for (auto b = b_range.first; b != b_range.second && !found; ++b) {
+        for (auto c = c_range.first; c != c_range.second; ++c) {
+          if (c->second == b->second) {
+            continue;
+          }
+
+          if (std::abs(dest_dist(b->second, c->second) - d_jk) <= tolerance) {
+            found = true;
+            break;
+          }
+        }
+      }
+
+      if (found) {
+        break;
+      }
+    }
+
+    if (found) {
+      ++num_congruent;
+    }
+  }
+
+  return static_cast<double>(num_congruent) / config.num_triangle_samples;
+}
+
+PreVerificationResult preVerifyRegistration(const PreVerificationConfig& config,
+                                            const SubgraphGeometry& src,
+                                            const SubgraphGeometry& dest,
+                                            bool match_labels) {
+  const double similarity = pairwiseDistanceSimilarity(config, src, dest);
+  if (similarity < config.min_histogram_similarity) {
+    VLOG(2) << "[DSG LCD] Pre-verification rejected: histogram similarity "
+            << similarity << " < " << config.min_histogram_similarity;
+    return PreVerificationResult::HISTOGRAM_REJECTED;
+  }
+
+  if (!match_labels) {
+    return PreVerificationResult::ACCEPTED;
+  }
+
+  const double ratio = triangleCongruenceRatio(config, src, dest);
+  if (ratio < config.min_triangle_ratio) {
+    VLOG(2) << "[DSG LCD] Pre-verification rejected: congruent triangle ratio "
+            << ratio << " < " << config.min_triangle_ratio;
+    return PreVerificationResult::TRIANGLE_REJECTED;
+  }
+
+  return PreVerificationResult::ACCEPTED;
+}
+
 DsgTeaserSolver::DsgTeaserSolver(LayerId layer_id,
                                  const LayerRegistrationConfig& config,
                                  const TeaserParams& params)
@@ -184,20 +510,26 @@ DsgRegistrationSolution DsgTeaserSolver::solve(const DynamicSceneGraph& dsg,
       dsg.getDynamicNode(query_agent_id).value().get().timestamp.count();
   ScopedTimer timer(timer_prefix, timestamp, true, 2, false);
 
-  LayerRegistrationProblem<std::set<NodeId>> problem;
+  // the query subgraph is usually already cached by the descriptor factories
+  SubgraphGeometry::Ptr src;
+  SubgraphGeometry::Ptr dest;
   if (config.recreate_subgraph) {
     const bool is_places = layer_id == DsgLayers::PLACES;
-    problem.src_nodes =
-        getSubgraphNodes(config.subgraph_extraction, dsg, match.query_root, is_places);
-    problem.dest_nodes =
-        getSubgraphNodes(config.subgraph_extraction, dsg, match.match_root, is_places);
+    const auto& subgraph_config = config.subgraph_extraction;
+    auto cache = subgraph_cache.get();
+    const auto query = match.query_root;
+    const auto target = match.match_root;
+    src = getSubgraphGeometry(subgraph_config, dsg, query, is_places, cache);
+    dest = getSubgraphGeometry(subgraph_config, dsg, target, is_places, cache);
   } else {
-    problem.src_nodes = match.query_nodes;
-    problem.dest_nodes = match.match_nodes;
+    src = std::make_shared<SubgraphGeometry>(
+        dsg, layer_id, match.query_root, match.query_nodes);
+    dest = std::make_shared<SubgraphGeometry>(
+        dsg, layer_id, match.match_root, match.match_nodes);
   }
 
-  if (problem.src_nodes.size() <= 3 || problem.dest_nodes.size() <= 3) {
-    if (problem.src_nodes.empty()) {
+  if (src->size() <= 3 || dest->size() <= 3) {
+    if (src->empty()) {
       LOG(ERROR) << "Invalid query: " << NodeSymbol(match.query_root).getLabel();
     } else {
       LOG(ERROR) << "Invalid match: " << NodeSymbol(match.match_root).getLabel();
@@ -206,27 +538,30 @@ DsgRegistrationSolution DsgTeaserSolver::solve(const DynamicSceneGraph& dsg,
     return {};
   }
 
-  size_t num_same = 0;
-  for (const auto& qnode : problem.src_nodes) {
-    if (problem.dest_nodes.count(qnode)) {
-      num_same++;
-    }
-  }
-
+  const size_t num_same = countSharedNodes(*src, *dest);
   if (num_same >= config.max_same_nodes) {
     VLOG(2) << "Rejecting registration: " << num_same << " / " << config.max_same_nodes
             << " shared nodes";
     return {};
   }
 
-  const auto& layer = dsg.getLayer(layer_id);
-  LayerRegistrationSolution solution;
-  if (config.use_pairwise_registration) {
-    solution = registerDsgLayerPairwise(config, solver, problem, layer);
-  } else {
-    solution = registerDsgLayerSemantic(config, solver, problem, layer);
+  const bool match_labels = !config.use_pairwise_registration;
+  if (config.pre_verification.enable) {
+    const auto pre_timer_name = timer_prefix + "_pre_verification";
+    ScopedTimer pre_timer(pre_timer_name, timestamp, true, 2, false);
+    const auto result =
+        preVerifyRegistration(config.pre_verification, *src, *dest, match_labels);
+    pre_verification_stats.record(result);
+    VLOG(3) << "[DSG LCD] " << DsgLayers::LayerIdToString(layer_id)
+            << " pre-verification: " << pre_verification_stats;
+    if (result != PreVerificationResult::ACCEPTED) {
+      return {};
+    }
   }
 
+  const auto solution =
+      registerDsgLayer(config, solver, layer_id, *src, *dest, match_labels);
+
   if (config.log_registration_problem) {
     logRegistrationProblem(log_prefix, dsg, solution, match, query_agent_id);
   }
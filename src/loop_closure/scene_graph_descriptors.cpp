@@ -36,12 +36,17 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 namespace hydra {
 namespace lcd {
 
 using Dsg = DynamicSceneGraph;
 using DsgNode = DynamicSceneGraphNode;
 
+AgentDescriptorFactory::AgentDescriptorFactory(bool compress_bow)
+    : compress_bow(compress_bow) {}
+
 Descriptor::Ptr AgentDescriptorFactory::construct(const Dsg& graph,
                                                   const DsgNode& agent_node) const {
   auto parent = agent_node.getParent();
@@ -52,8 +57,12 @@ Descriptor::Ptr AgentDescriptorFactory::construct(const Dsg& graph,
   const auto& attrs = agent_node.attributes<AgentNodeAttributes>();
   auto descriptor = std::make_unique<Descriptor>();
   descriptor->normalized = true;
-  descriptor->words = attrs.dbow_ids;
-  descriptor->values = attrs.dbow_values;
+  if (compress_bow) {
+    descriptor->bow = CompressedBow(attrs.dbow_ids, attrs.dbow_values);
+  } else {
+    descriptor->words = attrs.dbow_ids;
+    descriptor->values = attrs.dbow_values;
+  }
   descriptor->root_node = *parent;
   descriptor->nodes.insert(agent_node.id);
   descriptor->timestamp = agent_node.timestamp;
@@ -82,14 +91,15 @@ Descriptor::Ptr ObjectDescriptorFactory::construct(const Dsg& graph,
   descriptor->root_node = *parent;
   descriptor->timestamp = agent_node.timestamp;
   descriptor->root_position = root_position;
-  descriptor->nodes = getSubgraphNodes(config, graph, *parent, false);
+  const auto subgraph =
+      getSubgraphGeometry(config, graph, *parent, false, subgraph_cache.get());
+  descriptor->nodes = subgraph->nodeSet();
 
-  for (const auto node : descriptor->nodes) {
-    const auto attrs = graph.getNode(node)->get().attributes<SemanticNodeAttributes>();
-    const size_t label = attrs.semantic_label;
+  for (size_t i = 0; i < subgraph->size(); ++i) {
+    const size_t label = subgraph->labels[i];
     if (label > static_cast<size_t>(descriptor->values.rows())) {
       LOG(ERROR) << "label " << static_cast<int>(label) << " for node "
-                 << NodeSymbol(node).getLabel() << " exceeds max label "
+                 << NodeSymbol(subgraph->nodes[i]).getLabel() << " exceeds max label "
                  << descriptor->values.rows();
       continue;
     }
@@ -120,7 +130,9 @@ Descriptor::Ptr PlaceDescriptorFactory::construct(const Dsg& graph,
   descriptor->root_node = *parent;
   descriptor->timestamp = agent_node.timestamp;
   descriptor->root_position = root_position;
-  descriptor->nodes = getSubgraphNodes(config, graph, *parent, true);
+  descriptor->nodes =
+      getSubgraphGeometry(config, graph, *parent, true, subgraph_cache.get())
+          ->nodeSet();
 
   const auto& places = graph.getLayer(DsgLayers::PLACES);
   for (const auto node : descriptor->nodes) {
@@ -131,5 +143,117 @@ Descriptor::Ptr PlaceDescriptorFactory::construct(const Dsg& graph,
   return descriptor;
 }
 
+namespace {
+
+inline std::vector<double> getScaleRadii(const SubgraphConfig& config,
+                                         std::vector<double> radii_m) {
+  std::sort(radii_m.begin(), radii_m.end());
+  radii_m.erase(std::unique(radii_m.begin(), radii_m.end()), radii_m.end());
+
+  // the extraction config bounds the coarsest scale
+  auto last = std::lower_bound(radii_m.begin(), radii_m.end(), config.max_radius_m);
+  radii_m.erase(last, radii_m.end());
+  radii_m.push_back(config.max_radius_m);
+  return radii_m;
+}
+
+}  // namespace
+
+MultiScaleDescriptorFactory::MultiScaleDescriptorFactory(
+    const SubgraphConfig& config,
+    const std::vector<double>& radii_m,
+    size_t num_bins,
+    bool is_places)
+    : config(config),
+      radii_m(getScaleRadii(config, radii_m)),
+      num_bins(num_bins),
+      is_places(is_places) {}
+
+Descriptor::Ptr MultiScaleDescriptorFactory::construct(
+    const Dsg& graph, const DsgNode& agent_node) const {
+  auto parent = agent_node.getParent();
+  if (!parent) {
+    return nullptr;
+  }
+
+  const Eigen::Vector3d root_position =
+      graph.getNode(*parent).value().get().attributes().position;
+
+  const size_t num_scales = radii_m.size();
+  auto descriptor = std::make_unique<Descriptor>();
+  descriptor->normalized = false;
+  descriptor->num_scales = num_scales;
+  descriptor->values = decltype(descriptor->values)::Zero(num_scales * num_bins, 1);
+  descriptor->root_node = *parent;
+  descriptor->timestamp = agent_node.timestamp;
+  descriptor->root_position = root_position;
+
+  const auto subgraph =
+      getSubgraphGeometry(config, graph, *parent, is_places, subgraph_cache.get());
+  descriptor->nodes = subgraph->nodeSet();
+
+  std::vector<std::pair<double, size_t>> distances;
+  distances.reserve(subgraph->size());
+  for (size_t i = 0; i < subgraph->size(); ++i) {
+    distances.emplace_back((subgraph->positions.col(i) - root_position).norm(), i);
+  }
+  std::sort(distances.begin(), distances.end());
+
+  // nodes are within radius r if their distance is strictly less than r, and the
+  // coarsest scale is every node of the subgraph
+  Eigen::VectorXf counts = Eigen::VectorXf::Zero(num_bins);
+  size_t scale = 0;
+  for (const auto& [distance, index] : distances) {
+    while (scale + 1 < num_scales && distance >= radii_m[scale]) {
+      descriptor->values.segment(scale * num_bins, num_bins) = counts;
+      ++scale;
+    }
+
+    const size_t bin = getBin(graph, *subgraph, index);
+    if (bin < num_bins) {
+      counts(bin) += 1.0f;
+    }
+  }
+
+  for (; scale < num_scales; ++scale) {
+    descriptor->values.segment(scale * num_bins, num_bins) = counts;
+  }
+
+  return descriptor;
+}
+
+MultiScaleObjectDescriptorFactory::MultiScaleObjectDescriptorFactory(
+    const SubgraphConfig& config,
+    const std::vector<double>& radii_m,
+    size_t num_classes)
+    : MultiScaleDescriptorFactory(config, radii_m, num_classes, false) {}
+
+size_t MultiScaleObjectDescriptorFactory::getBin(const Dsg&,
+                                                 const SubgraphGeometry& subgraph,
+                                                 size_t index) const {
+  const size_t label = subgraph.labels[index];
+  if (label >= num_bins) {
+    LOG(ERROR) << "label " << label << " for node "
+               << NodeSymbol(subgraph.nodes[index]).getLabel() << " exceeds max label "
+               << num_bins;
+  }
+
+  return label;
+}
+
+MultiScalePlaceDescriptorFactory::MultiScalePlaceDescriptorFactory(
+    const SubgraphConfig& config,
+    const std::vector<double>& radii_m,
+    const HistogramConfig<double>& histogram)
+    : MultiScaleDescriptorFactory(config, radii_m, histogram.bins, true),
+      histogram(histogram) {}
+
+size_t MultiScalePlaceDescriptorFactory::getBin(const Dsg& graph,
+                                                const SubgraphGeometry& subgraph,
+                                                size_t index) const {
+  const auto& node = graph.getNode(subgraph.nodes[index]).value().get();
+  return histogram.getBin(node.attributes<PlaceNodeAttributes>().distance);
+}
+
 }  // namespace lcd
 }  // namespace hydra
@@ -36,6 +36,8 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 namespace hydra {
 
 SubgraphConfig::SubgraphConfig(double radius_m)
@@ -171,4 +173,120 @@ std::set<NodeId> getSubgraphNodes(const SubgraphConfig& config,
   return getFilteredNodeSet(config, graph, origin, found);
 }
 
+SubgraphGeometry::SubgraphGeometry(const DynamicSceneGraph& graph,
+                                   LayerId layer_id,
+                                   NodeId root,
+                                   const std::set<NodeId>& to_add)
+    : root(root) {
+  const auto& layer = graph.getLayer(layer_id);
+  nodes.reserve(to_add.size());
+  for (const auto node : to_add) {
+    if (layer.hasNode(node)) {
+      nodes.push_back(node);
+    }
+  }
+
+  // std::set iteration order keeps nodes sorted
+  positions.resize(3, nodes.size());
+  labels.resize(nodes.size(), 0);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const SceneGraphNode& node = layer.getNode(nodes[i]).value();
+    positions.col(i) = node.attributes().position;
+    const auto attrs = dynamic_cast<const SemanticNodeAttributes*>(&node.attributes());
+    if (attrs) {
+      labels[i] = attrs->semantic_label;
+    }
+  }
+}
+
+bool SubgraphGeometry::contains(NodeId node) const {
+  return std::binary_search(nodes.begin(), nodes.end(), node);
+}
+
+std::set<NodeId> SubgraphGeometry::nodeSet() const {
+  return std::set<NodeId>(nodes.begin(), nodes.end());
+}
+
+size_t countSharedNodes(const SubgraphGeometry& lhs, const SubgraphGeometry& rhs) {
+  size_t num_shared = 0;
+  auto liter = lhs.nodes.begin();
+  auto riter = rhs.nodes.begin();
+  while (liter != lhs.nodes.end() && riter != rhs.nodes.end()) {
+    if (*liter < *riter) {
+      ++liter;
+    } else if (*riter < *liter) {
+      ++riter;
+    } else {
+      ++num_shared;
+      ++liter;
+      ++riter;
+    }
+  }
+
+  return num_shared;
+}
+
+SubgraphCache::Key SubgraphCache::makeKey(const SubgraphConfig& config,
+                                          NodeId root_node,
+                                          bool is_places) {
+  if (config.fixed_radius) {
+    // min radius and min nodes are unused for fixed radius subgraphs
+    return {root_node, is_places, true, config.max_radius_m, 0.0, 0};
+  }
+
+  return {root_node,
+          is_places,
+          false,
+          config.max_radius_m,
+          config.min_radius_m,
+          config.min_nodes};
+}
+
+SubgraphGeometry::Ptr SubgraphCache::get(const SubgraphConfig& config,
+                                         const DynamicSceneGraph& graph,
+                                         NodeId root_node,
+                                         bool is_places) {
+  const auto key = makeKey(config, root_node, is_places);
+  {  // start critical section
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+      ++num_hits_;
+      return iter->second;
+    }
+  }  // end critical section
+
+  // extraction happens outside the lock; concurrent misses for the same key compute
+  // identical subgraphs and the first one inserted wins
+  ++num_misses_;
+  auto geometry = getSubgraphGeometry(config, graph, root_node, is_places);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.emplace(key, geometry).first->second;
+}
+
+void SubgraphCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+}
+
+size_t SubgraphCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.size();
+}
+
+SubgraphGeometry::Ptr getSubgraphGeometry(const SubgraphConfig& config,
+                                          const DynamicSceneGraph& graph,
+                                          NodeId root_node,
+                                          bool is_places,
+                                          SubgraphCache* cache) {
+  if (cache) {
+    return cache->get(config, graph, root_node, is_places);
+  }
+
+  const auto nodes = getSubgraphNodes(config, graph, root_node, is_places);
+  const LayerId layer = is_places ? DsgLayers::PLACES : DsgLayers::OBJECTS;
+  return std::make_shared<SubgraphGeometry>(graph, layer, root_node, nodes);
+}
+
 }  // namespace hydra
@@ -51,6 +51,12 @@ void GraphExtractorInterface::pushGvdIndex(const GlobalIndex& index) {
   modified_voxel_queue_.push(index);
 }
 
+void GraphExtractorInterface::pushDirtyBlocks(const GvdDirtyTracker& tracker) {
+  for (const auto& index : tracker.pushed) {
+    pushGvdIndex(index);
+  }
+}
+
 void GraphExtractorInterface::assignMeshVertices(const GvdLayer& gvd,
                                                  const GvdParentMap& parents,
                                                  const GvdVertexMap& parent_vertices) {
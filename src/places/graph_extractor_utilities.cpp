@@ -35,6 +35,7 @@
 #include "hydra/places/graph_extractor_utilities.h"
 
 #include "hydra/places/nearest_voxel_utilities.h"
+#include "hydra/utils/compact_graph.h"
 #include "hydra/utils/nearest_neighbor_utilities.h"
 
 namespace hydra {
@@ -345,7 +346,12 @@ void findFreespaceEdges(const FreespaceEdgeConfig& config,
                         const std::unordered_set<NodeId>& nodes,
                         const NodeIndexMap& indices,
                         EdgeInfoMap& proposed_edges) {
-  auto components = graph_utilities::getConnectedComponents(graph, nodes, true);
+  const CompactGraph compact_graph(graph, nodes);
+  Components components;
+  for (const auto& component : getConnectedComponents(compact_graph)) {
+    components.push_back(compact_graph.getNodeIds(component));
+  }
+
   if (components.size() <= 1) {
     return;  // nothing to do
   }
@@ -0,0 +1,85 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/places/gvd_dirty_tracker.h"
+
+namespace hydra {
+namespace places {
+
+GvdDirtyBlock::GvdDirtyBlock(size_t num_voxels)
+    : pushed(num_voxels) {}
+
+GvdDirtyTracker::GvdDirtyTracker(int voxels_per_side)
+    : voxels_per_side(voxels_per_side) {}
+
+GvdDirtyBlock& GvdDirtyTracker::getBlock(const GlobalIndex& index,
+                                         size_t& linear_index) {
+  BlockIndex block_index;
+  VoxelIndex voxel_index;
+  voxblox::getBlockAndVoxelIndexFromGlobalVoxelIndex(
+      index, voxels_per_side, &block_index, &voxel_index);
+  const size_t vps = voxels_per_side;
+  linear_index = voxel_index.x() + vps * (voxel_index.y() + vps * voxel_index.z());
+
+  auto iter = blocks.find(block_index);
+  if (iter == blocks.end()) {
+    const size_t num_voxels = voxels_per_side * voxels_per_side * voxels_per_side;
+    iter = blocks.emplace(block_index, GvdDirtyBlock(num_voxels)).first;
+  }
+
+  return iter->second;
+}
+
+void GvdDirtyTracker::markPushed(const GlobalIndex& index) {
+  size_t linear_index;
+  auto& block = getBlock(index, linear_index);
+  if (block.pushed.test(linear_index)) {
+    return;
+  }
+
+  block.pushed.set(linear_index);
+  pushed.push_back(index);
+}
+
+void GvdDirtyTracker::removeBlock(const BlockIndex& index) { blocks.erase(index); }
+
+bool GvdDirtyTracker::empty() const { return blocks.empty(); }
+
+void GvdDirtyTracker::clear() {
+  blocks.clear();
+  pushed.clear();
+}
+
+}  // namespace places
+}  // namespace hydra
@@ -46,6 +46,8 @@
 #include "hydra/places/compression_graph_extractor.h"
 #include "hydra/places/floodfill_graph_extractor.h"
 #include "hydra/places/gvd_utilities.h"
+#include "hydra/reconstruction/dynamic_voxel_detector.h"
+#include "hydra/reconstruction/tsdf_change_tracker.h"
 #include "hydra/reconstruction/voxblox_utilities.h"
 #include "hydra/utils/timing_utilities.h"
 
@@ -57,11 +59,15 @@ using EdgeNeighborhood = Neighborhood<voxblox::Connectivity::kTwentySix>;
 
 GvdIntegrator::GvdIntegrator(const GvdIntegratorConfig& config,
                              const Layer<GvdVoxel>::Ptr& gvd_layer)
-    : default_distance_(config.max_distance_m), config_(config), gvd_layer_(gvd_layer) {
+    : default_distance_(config.max_distance_m),
+      config_(config),
+      gvd_layer_(gvd_layer),
+      dynamic_voxels_(nullptr) {
   // TODO(nathan) we could consider an exception here
   CHECK(gvd_layer_);
 
   voxel_size_ = gvd_layer_->voxel_size();
+  dirty_tracker_ = GvdDirtyTracker(gvd_layer_->voxels_per_side());
   // config_.positive_distance_only toggles between only integrating to the negative
   // truncation distance or integrating to the full max distance
   min_integration_distance_m_ = config_.positive_distance_only
@@ -97,7 +103,8 @@ void GvdIntegrator::updateFromTsdf(uint64_t timestamp_ns,
                                    const Layer<VertexVoxel>& vertices,
                                    const MeshLayer& mesh,
                                    bool clear_updated_flag,
-                                   bool use_all_blocks) {
+                                   bool use_all_blocks,
+                                   const TsdfChangeTracker* tsdf_changes) {
   BlockIndexList blocks;
   if (use_all_blocks) {
     tsdf.getAllAllocatedBlocks(&blocks);
@@ -110,8 +117,22 @@ void GvdIntegrator::updateFromTsdf(uint64_t timestamp_ns,
   update_stats_.clear();
 
   for (const BlockIndex& idx : blocks) {
-    propagateSurface(idx, mesh, vertices);
-    processTsdfBlock(tsdf.getBlockByIndex(idx), idx);
+    const VoxelMask* changes = nullptr;
+    if (!use_all_blocks && tsdf_changes) {
+      changes = tsdf_changes->getChanges(idx);
+    }
+
+    if (!changes) {
+      // no record of which voxels changed, so we have to check the full block
+      propagateSurface(idx, mesh, vertices);
+      processTsdfBlock(tsdf.getBlockByIndex(idx), idx);
+      continue;
+    }
+
+    // voxels that flip surface status also need to be checked
+    VoxelMask to_check = *changes;
+    propagateSurface(idx, mesh, vertices, &to_check);
+    processTsdfBlock(tsdf.getBlockByIndex(idx), idx, &to_check);
   }
 
   if (!clear_updated_flag) {
@@ -138,11 +159,16 @@ void GvdIntegrator::updateGvd(uint64_t timestamp_ns) {
   if (config_.extract_graph) {
     VLOG(3) << "[GVD update] Starting graph extraction";
     ScopedTimer timer("places/graph_extractor", timestamp_ns);
+    if (config_.use_dirty_masks) {
+      graph_extractor_->pushDirtyBlocks(dirty_tracker_);
+    }
+
     graph_extractor_->extract(*gvd_layer_, timestamp_ns);
     graph_extractor_->assignMeshVertices(
         *gvd_layer_, parent_tracker_.parents, parent_tracker_.parent_vertices);
   }
 
+  dirty_tracker_.clear();
   VLOG(2) << "[GVD update]" << std::endl << update_stats_;
 }
 
@@ -167,10 +193,15 @@ void GvdIntegrator::archiveBlocks(const BlockIndexList& blocks) {
     }
 
     VLOG(5) << "Removing block: " << idx.transpose();
+    dirty_tracker_.removeBlock(idx);
     gvd_layer_->removeBlock(idx);
   }
 }
 
+void GvdIntegrator::setDynamicVoxels(const DynamicVoxelDetector* detector) {
+  dynamic_voxels_ = detector;
+}
+
 bool GvdIntegrator::setFixedParent(const Layer<GvdVoxel>& layer,
                                    const GvdNeighborhood::IndexMatrix& neighbor_indices,
                                    GvdVoxel& voxel) {
@@ -235,7 +266,14 @@ void GvdIntegrator::updateGvdVoxel(const GlobalIndex& voxel_index,
 
   voxel.num_extra_basis = new_basis;
 
-  if (voxel.num_extra_basis == config_.min_basis_for_extraction) {
+  if (voxel.num_extra_basis != config_.min_basis_for_extraction) {
+    return;
+  }
+
+  if (config_.use_dirty_masks) {
+    // pushes are deferred until the end of the update so each voxel is pushed once
+    dirty_tracker_.markPushed(voxel_index);
+  } else {
     graph_extractor_->pushGvdIndex(voxel_index);
   }
 }
@@ -276,13 +314,17 @@ void GvdIntegrator::updateVoronoiQueue(GvdVoxel& voxel,
 
 void GvdIntegrator::propagateSurface(const BlockIndex& block_index,
                                      const MeshLayer& mesh,
-                                     const Layer<VertexVoxel>& vertices) {
+                                     const Layer<VertexVoxel>& vertices,
+                                     VoxelMask* surface_changes) {
   const auto& vertex_block = vertices.getBlockByIndex(block_index);
   auto gvd_block = gvd_layer_->allocateBlockPtrByIndex(block_index);
 
   for (size_t idx = 0u; idx < vertex_block.num_voxels(); ++idx) {
     const auto& vertex_voxel = vertex_block.getVoxelByLinearIndex(idx);
     auto& gvd_voxel = gvd_block->getVoxelByLinearIndex(idx);
+    if (surface_changes && gvd_voxel.on_surface != vertex_voxel.on_surface) {
+      surface_changes->set(idx);
+    }
 
     // latches surface status from mesh integrator
     gvd_voxel.on_surface = vertex_voxel.on_surface;
@@ -313,29 +355,57 @@ void GvdIntegrator::propagateSurface(const BlockIndex& block_index,
 }
 
 void GvdIntegrator::processTsdfBlock(const Block<TsdfVoxel>& tsdf_block,
-                                     const BlockIndex& block_index) {
+                                     const BlockIndex& block_index,
+                                     const VoxelMask* voxels) {
   // Allocate the same block in the ESDF layer.
   auto gvd_block = gvd_layer_->getBlockPtrByIndex(block_index);
   gvd_block->set_updated(true);
 
+  // dynamic voxels keep their last static state until they are released
+  const VoxelMask* dynamic =
+      dynamic_voxels_ ? dynamic_voxels_->getDynamicMask(block_index) : nullptr;
+
+  if (voxels) {
+    voxels->forEach([&](size_t idx) {
+      if (dynamic && dynamic->test(idx)) {
+        return;
+      }
+
+      processTsdfVoxel(
+          tsdf_block.getVoxelByLinearIndex(idx), *gvd_block, block_index, idx);
+    });
+    return;
+  }
+
   for (size_t idx = 0u; idx < tsdf_block.num_voxels(); ++idx) {
-    const TsdfVoxel& tsdf_voxel = tsdf_block.getVoxelByLinearIndex(idx);
-    if (tsdf_voxel.weight < config_.min_weight) {
-      continue;  // If this voxel is unobserved in the original map, skip it.
+    if (dynamic && dynamic->test(idx)) {
+      continue;
     }
 
-    GvdVoxel& gvd_voxel = gvd_block->getVoxelByLinearIndex(idx);
-    GlobalIndex global_index = voxblox::getGlobalVoxelIndexFromBlockAndVoxelIndex(
-        block_index,
-        gvd_block->computeVoxelIndexFromLinearIndex(idx),
-        gvd_layer_->voxels_per_side());
+    processTsdfVoxel(
+        tsdf_block.getVoxelByLinearIndex(idx), *gvd_block, block_index, idx);
+  }
+}
+
+void GvdIntegrator::processTsdfVoxel(const TsdfVoxel& tsdf_voxel,
+                                     Block<GvdVoxel>& gvd_block,
+                                     const BlockIndex& block_index,
+                                     size_t idx) {
+  if (tsdf_voxel.weight < config_.min_weight) {
+    return;  // If this voxel is unobserved in the original map, skip it.
+  }
 
-    if (!gvd_voxel.observed) {
-      updateUnobservedVoxel(tsdf_voxel, global_index, gvd_voxel);
-      gvd_voxel.observed = true;
-    } else {
-      updateObservedVoxel(tsdf_voxel, global_index, gvd_voxel);
-    }
+  GvdVoxel& gvd_voxel = gvd_block.getVoxelByLinearIndex(idx);
+  GlobalIndex global_index = voxblox::getGlobalVoxelIndexFromBlockAndVoxelIndex(
+      block_index,
+      gvd_block.computeVoxelIndexFromLinearIndex(idx),
+      gvd_layer_->voxels_per_side());
+
+  if (!gvd_voxel.observed) {
+    updateUnobservedVoxel(tsdf_voxel, global_index, gvd_voxel);
+    gvd_voxel.observed = true;
+  } else {
+    updateObservedVoxel(tsdf_voxel, global_index, gvd_voxel);
   }
 }
 
@@ -0,0 +1,228 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/reconstruction/compact_semantic_integrator.h"
+
+#include <glog/logging.h>
+#include <voxblox/integrator/integrator_utils.h>
+
+#include <algorithm>
+#include <list>
+#include <thread>
+
+namespace hydra {
+
+using voxblox::Block;
+using voxblox::BlockIndex;
+using voxblox::GlobalIndex;
+using voxblox::Point;
+using voxblox::RayCaster;
+using voxblox::TsdfVoxel;
+
+CompactSemanticTsdfIntegrator::CompactSemanticTsdfIntegrator(
+    const Config& config,
+    const SemanticConfig& semantic_config,
+    voxblox::Layer<TsdfVoxel>* tsdf_layer,
+    SemanticLayer* semantic_layer)
+    : TsdfIntegratorBase(config, tsdf_layer),
+      semantic_config_(semantic_config),
+      semantic_layer_(CHECK_NOTNULL(semantic_layer)),
+      change_tracker_(nullptr) {
+  CHECK(semantic_config_.semantic_label_to_color_)
+      << "label to color map required for semantic integration";
+  CHECK_EQ(semantic_layer_->voxels_per_side(), tsdf_layer->voxels_per_side());
+
+  num_labels_ = semantic_config_.semantic_label_to_color_->getNumLabels();
+  CHECK_GT(num_labels_, 1u);
+  CHECK_LE(num_labels_, 256u) << "compact semantic voxels only support 8-bit labels";
+
+  // every observation scales all other labels by the same amount, so only the
+  // likelihood ratio between the observed label and any other label matters
+  const float p_match = semantic_config_.semantic_measurement_probability_;
+  const float p_other = (1.0f - p_match) / (num_labels_ - 1);
+  log_likelihood_ratio_ = std::log(p_match) - std::log(p_other);
+}
+
+void CompactSemanticTsdfIntegrator::setChangeTracker(TsdfChangeTracker* tracker) {
+  change_tracker_ = tracker;
+}
+
+void CompactSemanticTsdfIntegrator::integratePointCloud(
+    const voxblox::Transformation& T_G_C,
+    const voxblox::Pointcloud& points_C,
+    const voxblox::Colors& colors,
+    const bool freespace_points) {
+  CHECK_EQ(points_C.size(), colors.size());
+  std::unique_ptr<voxblox::ThreadSafeIndex> index_getter(
+      voxblox::ThreadSafeIndexFactory::get(config_.integration_order_mode, points_C));
+
+  std::list<std::thread> threads;
+  for (size_t i = 0; i < config_.integrator_threads; ++i) {
+    threads.emplace_back(&CompactSemanticTsdfIntegrator::integrateFunction,
+                         this,
+                         T_G_C,
+                         points_C,
+                         colors,
+                         freespace_points,
+                         index_getter.get());
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  updateLayerWithStoredBlocks();
+}
+
+void CompactSemanticTsdfIntegrator::integrateFunction(
+    const voxblox::Transformation& T_G_C,
+    const voxblox::Pointcloud& points_C,
+    const voxblox::Colors& colors,
+    const bool freespace_points,
+    voxblox::ThreadSafeIndex* index_getter) {
+  const auto& label_map = *semantic_config_.semantic_label_to_color_;
+  const auto& dynamic_labels = semantic_config_.dynamic_labels_;
+
+  size_t point_idx;
+  while (index_getter->getNextIndex(&point_idx)) {
+    const Point& point_C = points_C[point_idx];
+    const voxblox::Color& color = colors[point_idx];
+    bool is_clearing;
+    if (!isPointValid(point_C, freespace_points, &is_clearing)) {
+      continue;
+    }
+
+    const kimera::SemanticLabel label =
+        label_map.getSemanticLabelFromColor(kimera::HashableColor(color));
+    if (std::find(dynamic_labels.begin(), dynamic_labels.end(), label) !=
+        dynamic_labels.end()) {
+      continue;
+    }
+
+    const Point origin = T_G_C.getPosition();
+    const Point point_G = T_G_C * point_C;
+    RayCaster ray_caster(origin,
+                         point_G,
+                         is_clearing,
+                         config_.voxel_carving_enabled,
+                         config_.max_ray_length_m,
+                         voxel_size_inv_,
+                         config_.default_truncation_distance);
+
+    Block<TsdfVoxel>::Ptr block = nullptr;
+    BlockIndex block_idx;
+    Block<CompactSemanticVoxel>::Ptr semantic_block = nullptr;
+    BlockIndex semantic_block_idx;
+    VoxelMask* changes = nullptr;
+    BlockIndex changes_idx;
+    GlobalIndex global_voxel_idx;
+    while (ray_caster.nextRayIndex(&global_voxel_idx)) {
+      TsdfVoxel* voxel =
+          allocateStorageAndGetVoxelPtr(global_voxel_idx, &block, &block_idx);
+      updateTsdfVoxel(
+          origin, point_G, global_voxel_idx, color, getVoxelWeight(point_C), voxel);
+      if (change_tracker_) {
+        BlockIndex curr_idx;
+        const size_t linear_idx =
+            change_tracker_->getLinearIndex(global_voxel_idx, curr_idx);
+        if (!changes || curr_idx != changes_idx) {
+          changes = &change_tracker_->getMask(curr_idx);
+          changes_idx = curr_idx;
+        }
+
+        changes->setAtomic(linear_idx);
+      }
+
+      if (is_clearing) {
+        continue;
+      }
+
+      const Point voxel_center =
+          voxblox::getCenterPointFromGridIndex(global_voxel_idx, voxel_size_);
+      const float sdf = computeDistance(origin, point_G, voxel_center);
+      if (std::abs(sdf) > config_.default_truncation_distance) {
+        continue;  // only voxels near the surface observe the label
+      }
+
+      CompactSemanticVoxel* semantic_voxel =
+          getSemanticVoxelPtr(global_voxel_idx, &semantic_block, &semantic_block_idx);
+      updateSemanticVoxel(global_voxel_idx, label, voxel, semantic_voxel);
+    }
+  }
+}
+
+CompactSemanticVoxel* CompactSemanticTsdfIntegrator::getSemanticVoxelPtr(
+    const GlobalIndex& global_voxel_idx,
+    Block<CompactSemanticVoxel>::Ptr* last_block,
+    BlockIndex* last_block_idx) {
+  const BlockIndex block_idx = voxblox::getBlockIndexFromGlobalVoxelIndex(
+      global_voxel_idx, voxels_per_side_inv_);
+
+  if (block_idx != *last_block_idx || *last_block == nullptr) {
+    // the layer and the block update flags aren't thread-safe, so all block lookups
+    // are serialized (and the block is flagged once per lookup instead of per voxel)
+    std::lock_guard<std::mutex> lock(semantic_block_mutex_);
+    *last_block = semantic_layer_->allocateBlockPtrByIndex(block_idx);
+    (*last_block)->updated().set();
+    *last_block_idx = block_idx;
+  }
+
+  const voxblox::VoxelIndex local_voxel_idx =
+      voxblox::getLocalFromGlobalVoxelIndex(global_voxel_idx, voxels_per_side_);
+  return &((*last_block)->getVoxelByVoxelIndex(local_voxel_idx));
+}
+
+void CompactSemanticTsdfIntegrator::updateSemanticVoxel(
+    const GlobalIndex& global_voxel_idx,
+    kimera::SemanticLabel label,
+    TsdfVoxel* tsdf_voxel,
+    CompactSemanticVoxel* semantic_voxel) {
+  std::lock_guard<std::mutex> lock(mutexes_.get(global_voxel_idx));
+  updateCompactSemanticVoxel(
+      *semantic_voxel, label, log_likelihood_ratio_, num_labels_);
+
+  if (semantic_config_.color_mode != kimera::ColorMode::kSemantic) {
+    return;
+  }
+
+  // the mesh relies on voxel colors to encode the most likely label
+  const auto best_label = getMostLikelyLabel(*semantic_voxel);
+  if (best_label) {
+    tsdf_voxel->color =
+        semantic_config_.semantic_label_to_color_->getColorFromSemanticLabel(
+            *best_label);
+  }
+}
+
+}  // namespace hydra
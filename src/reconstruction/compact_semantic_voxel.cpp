@@ -0,0 +1,142 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/reconstruction/compact_semantic_voxel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace hydra {
+
+using Voxel = CompactSemanticVoxel;
+
+inline float dequantize(uint16_t value) { return -value / Voxel::kLogScale; }
+
+inline uint16_t quantize(float value) {
+  const float scaled = std::round(-value * Voxel::kLogScale);
+  return static_cast<uint16_t>(
+      std::min<float>(scaled, std::numeric_limits<uint16_t>::max()));
+}
+
+// log of the mean of the per-label probabilities of the untracked labels after the
+// evicted label joins the (num_untracked - 1) that stay untracked
+inline float mergeResidual(float residual, float evicted, size_t num_untracked) {
+  if (num_untracked <= 1) {
+    return evicted;  // the evicted label is the only untracked label left
+  }
+
+  const float max = std::max(residual, evicted);
+  const float others = (num_untracked - 1) * std::exp(residual - max);
+  return max + std::log((others + std::exp(evicted - max)) / num_untracked);
+}
+
+void updateCompactSemanticVoxel(CompactSemanticVoxel& voxel,
+                                uint8_t label,
+                                float log_likelihood_ratio,
+                                size_t total_labels) {
+  float scores[Voxel::kMaxLabels];
+  size_t observed = voxel.num_labels;
+  for (size_t i = 0; i < voxel.num_labels; ++i) {
+    scores[i] = dequantize(voxel.log_probs[i]);
+    if (voxel.labels[i] == label) {
+      observed = i;
+    }
+  }
+
+  float residual = dequantize(voxel.residual);
+  if (observed == voxel.num_labels) {
+    if (voxel.num_labels < Voxel::kMaxLabels) {
+      ++voxel.num_labels;
+    } else {
+      // evict the least likely label into the residual (which is shared by every
+      // untracked label, including the newly observed one before this update)
+      observed = std::min_element(scores, scores + voxel.num_labels) - scores;
+      const size_t num_untracked =
+          total_labels > voxel.num_labels ? total_labels - voxel.num_labels : 1;
+      residual = mergeResidual(residual, scores[observed], num_untracked);
+    }
+
+    scores[observed] = dequantize(voxel.residual);
+    voxel.labels[observed] = label;
+  }
+
+  scores[observed] += log_likelihood_ratio;
+
+  // values are stored relative to the most likely entry, so every entry is
+  // re-quantized against the new maximum
+  const float max_score =
+      std::max(residual, *std::max_element(scores, scores + voxel.num_labels));
+  for (size_t i = 0; i < voxel.num_labels; ++i) {
+    voxel.log_probs[i] = quantize(scores[i] - max_score);
+  }
+  voxel.residual = quantize(residual - max_score);
+}
+
+std::optional<uint8_t> getMostLikelyLabel(const CompactSemanticVoxel& voxel) {
+  if (!voxel.num_labels) {
+    return std::nullopt;
+  }
+
+  const auto iter =
+      std::min_element(voxel.log_probs, voxel.log_probs + voxel.num_labels);
+  if (*iter > voxel.residual) {
+    return std::nullopt;  // no tracked label is more likely than the residual
+  }
+
+  return voxel.labels[iter - voxel.log_probs];
+}
+
+Eigen::VectorXf getLabelDistribution(const CompactSemanticVoxel& voxel,
+                                     size_t total_labels) {
+  const size_t num_untracked = total_labels - voxel.num_labels;
+  Eigen::VectorXf probs =
+      Eigen::VectorXf::Constant(total_labels, std::exp(dequantize(voxel.residual)));
+  for (size_t i = 0; i < voxel.num_labels; ++i) {
+    if (voxel.labels[i] >= total_labels) {
+      continue;
+    }
+
+    probs(voxel.labels[i]) = std::exp(dequantize(voxel.log_probs[i]));
+  }
+
+  float total = num_untracked * std::exp(dequantize(voxel.residual));
+  for (size_t i = 0; i < voxel.num_labels; ++i) {
+    total += std::exp(dequantize(voxel.log_probs[i]));
+  }
+
+  return probs / total;
+}
+
+}  // namespace hydra
@@ -0,0 +1,223 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/reconstruction/dynamic_voxel_detector.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace hydra {
+
+using voxblox::Block;
+using voxblox::BlockIndex;
+using voxblox::BlockIndexList;
+using voxblox::TsdfVoxel;
+
+DynamicVoxelDetector::BlockState::BlockState(size_t num_voxels)
+    : observed(num_voxels), occupied(num_voxels), dynamic(num_voxels), num_dynamic(0) {}
+
+DynamicVoxelDetector::DynamicVoxelDetector(const DynamicVoxelConfig& config,
+                                           float voxel_size,
+                                           int voxels_per_side)
+    : config_(config),
+      num_voxels_(voxels_per_side * voxels_per_side * voxels_per_side),
+      frame_(0),
+      num_dynamic_(0),
+      layer_(new DynamicLayer(voxel_size, voxels_per_side)) {
+  CHECK_LT(config_.occupied_distance_m, config_.free_distance_m)
+      << "occupied distance must be smaller than free distance";
+  CHECK_GT(config_.min_flips, 0u);
+}
+
+void DynamicVoxelDetector::update(TsdfLayer& tsdf,
+                                  float min_weight,
+                                  TsdfChangeTracker* changes) {
+  ++frame_;
+
+  BlockIndexList blocks;
+  tsdf.getAllUpdatedBlocks(voxblox::Update::kMesh, &blocks);
+  for (const auto& block_index : blocks) {
+    updateBlock(tsdf.getBlockByIndex(block_index), block_index, min_weight);
+  }
+
+  releaseVoxels(tsdf, changes);
+}
+
+const VoxelMask* DynamicVoxelDetector::getDynamicMask(
+    const BlockIndex& block_index) const {
+  auto iter = states_.find(block_index);
+  if (iter == states_.end() || iter->second.num_dynamic == 0) {
+    return nullptr;
+  }
+
+  return &iter->second.dynamic;
+}
+
+bool DynamicVoxelDetector::isDynamic(const BlockIndex& block_index,
+                                     size_t linear_index) const {
+  const auto mask = getDynamicMask(block_index);
+  return mask && mask->test(linear_index);
+}
+
+void DynamicVoxelDetector::removeBlock(const BlockIndex& block_index) {
+  auto iter = states_.find(block_index);
+  if (iter == states_.end()) {
+    return;
+  }
+
+  num_dynamic_ -= iter->second.num_dynamic;
+  states_.erase(iter);
+  layer_->removeBlock(block_index);
+}
+
+DynamicVoxelDetector::BlockState& DynamicVoxelDetector::getState(
+    const BlockIndex& block_index) {
+  auto iter = states_.find(block_index);
+  if (iter == states_.end()) {
+    iter = states_.emplace(block_index, BlockState(num_voxels_)).first;
+  }
+
+  return iter->second;
+}
+
+void DynamicVoxelDetector::updateBlock(const Block<TsdfVoxel>& block,
+                                       const BlockIndex& block_index,
+                                       float min_weight) {
+  auto& state = getState(block_index);
+  Block<DynamicVoxel>::Ptr dynamic_block = layer_->getBlockPtrByIndex(block_index);
+
+  for (size_t idx = 0; idx < block.num_voxels(); ++idx) {
+    const auto& voxel = block.getVoxelByLinearIndex(idx);
+    if (voxel.weight < min_weight) {
+      continue;
+    }
+
+    bool occupied;
+    if (voxel.distance < config_.occupied_distance_m) {
+      occupied = true;
+    } else if (voxel.distance > config_.free_distance_m) {
+      occupied = false;
+    } else {
+      continue;  // inside the hysteresis band: keep the previous state
+    }
+
+    if (!state.observed.test(idx)) {
+      state.observed.set(idx);
+      if (occupied) {
+        state.occupied.set(idx);
+      }
+      continue;
+    }
+
+    if (state.occupied.test(idx) == occupied) {
+      continue;
+    }
+
+    if (occupied) {
+      state.occupied.set(idx);
+    } else {
+      state.occupied.reset(idx);
+    }
+
+    if (!dynamic_block) {
+      dynamic_block = layer_->allocateBlockPtrByIndex(block_index);
+    }
+
+    auto& dynamic_voxel = dynamic_block->getVoxelByLinearIndex(idx);
+    if (frame_ - dynamic_voxel.last_flip > config_.flip_window) {
+      dynamic_voxel.num_flips = 0;
+    }
+
+    dynamic_voxel.num_flips = std::min(dynamic_voxel.num_flips + 1, 255);
+    dynamic_voxel.last_flip = frame_;
+    dynamic_voxel.distance = voxel.distance;
+    if (dynamic_voxel.dynamic || dynamic_voxel.num_flips < config_.min_flips) {
+      continue;
+    }
+
+    dynamic_voxel.dynamic = true;
+    state.dynamic.set(idx);
+    ++state.num_dynamic;
+    ++num_dynamic_;
+  }
+}
+
+void DynamicVoxelDetector::releaseVoxels(TsdfLayer& tsdf, TsdfChangeTracker* changes) {
+  BlockIndexList blocks;
+  layer_->getAllAllocatedBlocks(&blocks);
+  for (const auto& block_index : blocks) {
+    auto& state = getState(block_index);
+    auto& dynamic_block = layer_->getBlockByIndex(block_index);
+
+    bool has_flips = false;
+    bool released = false;
+    for (size_t idx = 0; idx < dynamic_block.num_voxels(); ++idx) {
+      auto& voxel = dynamic_block.getVoxelByLinearIndex(idx);
+      if (!voxel.dynamic && voxel.num_flips == 0) {
+        continue;
+      }
+
+      const uint64_t age = frame_ - voxel.last_flip;
+      if (voxel.dynamic && age >= config_.release_frames) {
+        voxel.dynamic = false;
+        voxel.num_flips = 0;
+        state.dynamic.reset(idx);
+        --state.num_dynamic;
+        --num_dynamic_;
+        released = true;
+        if (changes) {
+          changes->getMask(block_index).set(idx);
+        }
+      } else if (!voxel.dynamic && age > config_.flip_window) {
+        voxel.num_flips = 0;
+      }
+
+      has_flips |= voxel.dynamic || voxel.num_flips > 0;
+    }
+
+    if (released && tsdf.hasBlock(block_index)) {
+      // released voxels have to be re-meshed and propagated to the GVD
+      auto& updated = tsdf.getBlockByIndex(block_index).updated();
+      updated.set(voxblox::Update::kMesh);
+      updated.set(voxblox::Update::kEsdf);
+    }
+
+    if (!has_flips) {
+      layer_->removeBlock(block_index);
+    }
+  }
+}
+
+}  // namespace hydra
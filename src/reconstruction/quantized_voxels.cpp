@@ -0,0 +1,172 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/reconstruction/quantized_voxels.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace hydra {
+
+using voxblox::Block;
+using voxblox::TsdfVoxel;
+
+static constexpr float kMaxDistanceValue = std::numeric_limits<int16_t>::max();
+
+TsdfQuantizer::TsdfQuantizer(float truncation_distance)
+    : distance_resolution(0.5f * truncation_distance / kMaxDistanceValue) {
+  CHECK_GT(truncation_distance, 0.0f);
+}
+
+int16_t TsdfQuantizer::quantizeDistance(float distance) const {
+  // distance_resolution is half of the quantization step
+  const float scaled = std::round(distance / (2.0f * distance_resolution));
+  const float clamped = std::clamp(scaled, -kMaxDistanceValue, kMaxDistanceValue);
+  return static_cast<int16_t>(clamped);
+}
+
+float TsdfQuantizer::dequantizeDistance(int16_t distance) const {
+  return distance * 2.0f * distance_resolution;
+}
+
+uint16_t TsdfQuantizer::quantizeWeight(float weight) {
+  if (!(weight > 0.0f)) {
+    return 0;  // covers negative and NaN weights
+  }
+
+  uint32_t bits;
+  std::memcpy(&bits, &weight, sizeof(bits));
+  // round to nearest (ties away from zero) before truncating the lower half
+  bits += 0x8000;
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+float TsdfQuantizer::dequantizeWeight(uint16_t weight) {
+  const uint32_t bits = static_cast<uint32_t>(weight) << 16;
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+QuantizedTsdfVoxel TsdfQuantizer::quantize(const TsdfVoxel& voxel) const {
+  QuantizedTsdfVoxel quantized;
+  quantized.distance = quantizeDistance(voxel.distance);
+  quantized.weight = quantizeWeight(voxel.weight);
+  quantized.color = voxel.color;
+  return quantized;
+}
+
+TsdfVoxel TsdfQuantizer::dequantize(const QuantizedTsdfVoxel& voxel) const {
+  TsdfVoxel result;
+  result.distance = dequantizeDistance(voxel.distance);
+  result.weight = dequantizeWeight(voxel.weight);
+  result.color = voxel.color;
+  return result;
+}
+
+void TsdfQuantizer::quantizeBlock(const Block<TsdfVoxel>& block,
+                                  Block<QuantizedTsdfVoxel>& quantized) const {
+  CHECK_EQ(block.num_voxels(), quantized.num_voxels());
+  for (size_t i = 0; i < block.num_voxels(); ++i) {
+    quantized.getVoxelByLinearIndex(i) = quantize(block.getVoxelByLinearIndex(i));
+  }
+  quantized.has_data() = block.has_data();
+}
+
+void TsdfQuantizer::dequantizeBlock(const Block<QuantizedTsdfVoxel>& quantized,
+                                    Block<TsdfVoxel>& block) const {
+  CHECK_EQ(block.num_voxels(), quantized.num_voxels());
+  for (size_t i = 0; i < block.num_voxels(); ++i) {
+    block.getVoxelByLinearIndex(i) = dequantize(quantized.getVoxelByLinearIndex(i));
+  }
+  block.has_data() = quantized.has_data();
+}
+
+void TsdfQuantizer::mergeBlock(const Block<QuantizedTsdfVoxel>& quantized,
+                               float max_weight,
+                               Block<TsdfVoxel>& block) const {
+  CHECK_EQ(block.num_voxels(), quantized.num_voxels());
+  for (size_t i = 0; i < block.num_voxels(); ++i) {
+    const auto prev = dequantize(quantized.getVoxelByLinearIndex(i));
+    if (prev.weight <= 0.0f) {
+      continue;
+    }
+
+    auto& voxel = block.getVoxelByLinearIndex(i);
+    if (voxel.weight <= 0.0f) {
+      voxel = prev;
+      continue;
+    }
+
+    const float total = prev.weight + voxel.weight;
+    voxel.distance =
+        (prev.distance * prev.weight + voxel.distance * voxel.weight) / total;
+    voxel.color = voxblox::Color::blendTwoColors(
+        prev.color, prev.weight, voxel.color, voxel.weight);
+    voxel.weight = std::min(total, max_weight);
+  }
+
+  block.has_data() = block.has_data() || quantized.has_data();
+}
+
+size_t mergeQuantizedBlocks(const TsdfQuantizer& quantizer,
+                            float max_weight,
+                            const voxblox::BlockIndexList& blocks,
+                            voxblox::Layer<QuantizedTsdfVoxel>& quantized,
+                            voxblox::Layer<TsdfVoxel>& tsdf) {
+  size_t num_merged = 0;
+  for (const auto& idx : blocks) {
+    const auto stored = quantized.getBlockPtrByIndex(idx);
+    if (!stored) {
+      continue;
+    }
+
+    const auto block = tsdf.getBlockPtrByIndex(idx);
+    if (!block) {
+      continue;
+    }
+
+    quantizer.mergeBlock(*stored, max_weight, *block);
+    quantized.removeBlock(idx);
+    ++num_merged;
+  }
+
+  return num_merged;
+}
+
+}  // namespace hydra
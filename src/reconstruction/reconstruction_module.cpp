@@ -37,7 +37,10 @@
 #include <kimera_semantics/semantic_tsdf_integrator_factory.h>
 #include <tf2_eigen/tf2_eigen.h>
 
+#include <cmath>
+
 #include "hydra/places/gvd_integrator.h"
+#include "hydra/reconstruction/compact_semantic_integrator.h"
 #include "hydra/reconstruction/voxel_aware_mesh_integrator.h"
 #include "hydra/utils/display_utilities.h"
 #include "hydra/utils/timing_utilities.h"
@@ -53,6 +56,7 @@ using pose_graph_tools::PoseGraph;
 using pose_graph_tools::PoseGraphEdge;
 using pose_graph_tools::PoseGraphNode;
 using timing::ScopedTimer;
+using voxblox::BlockIndex;
 using voxblox::BlockIndexList;
 using voxblox::Layer;
 using voxblox::MeshLayer;
@@ -80,18 +84,55 @@ ReconstructionModule::ReconstructionModule(const RobotPrefixConfig& prefix,
   queue_->max_size = config_.max_input_queue_size;
 
   tsdf_.reset(new Layer<TsdfVoxel>(config_.voxel_size, config_.voxels_per_side));
-  semantics_.reset(
-      new Layer<SemanticVoxel>(config_.voxel_size, config_.voxels_per_side));
+  if (config_.quantize_inactive_blocks) {
+    quantized_tsdf_.reset(
+        new Layer<QuantizedTsdfVoxel>(config_.voxel_size, config_.voxels_per_side));
+    tsdf_quantizer_ = TsdfQuantizer(config_.tsdf.default_truncation_distance);
+  }
 
   gvd_.reset(new Layer<GvdVoxel>(config_.voxel_size, config_.voxels_per_side));
   vertices_.reset(new Layer<VertexVoxel>(config_.voxel_size, config_.voxels_per_side));
   mesh_.reset(new MeshLayer(tsdf_->block_size()));
 
-  tsdf_integrator_ = SemanticTsdfIntegratorFactory::create(
-      "fast", config_.tsdf, config_.semantics, tsdf_.get(), semantics_.get());
+  if (config_.semantic_integrator == "compact") {
+    compact_semantics_.reset(
+        new Layer<CompactSemanticVoxel>(config_.voxel_size, config_.voxels_per_side));
+    auto integrator = std::make_unique<CompactSemanticTsdfIntegrator>(
+        config_.tsdf, config_.semantics, tsdf_.get(), compact_semantics_.get());
+    if (config_.use_tsdf_change_masks) {
+      tsdf_changes_.reset(new TsdfChangeTracker(config_.voxels_per_side));
+      integrator->setChangeTracker(tsdf_changes_.get());
+    }
+
+    tsdf_integrator_ = std::move(integrator);
+  } else {
+    if (config_.use_tsdf_change_masks) {
+      // the generic integrators don't report voxel changes, so we diff the blocks
+      tsdf_changes_.reset(new TsdfChangeTracker(config_.voxels_per_side));
+      tsdf_change_detector_.reset(
+          new TsdfChangeDetector(config_.tsdf.default_truncation_distance));
+    }
+
+    semantics_.reset(
+        new Layer<SemanticVoxel>(config_.voxel_size, config_.voxels_per_side));
+    tsdf_integrator_ =
+        SemanticTsdfIntegratorFactory::create(config_.semantic_integrator,
+                                              config_.tsdf,
+                                              config_.semantics,
+                                              tsdf_.get(),
+                                              semantics_.get());
+  }
+
   mesh_integrator_.reset(
       new MeshIntegrator(config_.mesh, tsdf_.get(), vertices_, mesh_.get()));
   gvd_integrator_.reset(new GvdIntegrator(config_.gvd, gvd_));
+
+  if (config_.dynamic_voxels.enable) {
+    dynamic_voxels_.reset(new DynamicVoxelDetector(
+        config_.dynamic_voxels, config_.voxel_size, config_.voxels_per_side));
+    mesh_integrator_->setDynamicVoxels(dynamic_voxels_.get());
+    gvd_integrator_->setDynamicVoxels(dynamic_voxels_.get());
+  }
 }
 
 ReconstructionModule::~ReconstructionModule() { stop(); }
@@ -237,6 +278,9 @@ bool ReconstructionModule::spinOnce(const ReconstructionInput& msg) {
 void ReconstructionModule::update(const ReconstructionInput& msg, bool full_update) {
   std::unique_lock<std::mutex> lock(tsdf_mutex_);
   const auto world_T_camera = getCameraPose(msg);
+  if (quantized_tsdf_) {
+    restoreActiveBlocks(world_T_camera.getPosition());
+  }
 
   {  // timing scope
     ScopedTimer timer("places/tsdf", msg.timestamp_ns);
@@ -244,10 +288,33 @@ void ReconstructionModule::update(const ReconstructionInput& msg, bool full_upda
         world_T_camera, *msg.pointcloud, *msg.pointcloud_colors, false);
   }  // timing scope
 
+  if (quantized_tsdf_) {
+    // rays can reach stored blocks outside the active radius
+    BlockIndexList integrated;
+    tsdf_->getAllUpdatedBlocks(voxblox::Update::kMesh, &integrated);
+    const auto num_merged = mergeQuantizedBlocks(tsdf_quantizer_,
+                                                 config_.tsdf.max_weight,
+                                                 integrated,
+                                                 *quantized_tsdf_,
+                                                 *tsdf_);
+    VLOG_IF(3, num_merged > 0) << "[Hydra Reconstruction] Merged " << num_merged
+                               << " quantized blocks into new observations";
+  }
+
   if (!tsdf_ || tsdf_->getNumberOfAllocatedBlocks() == 0) {
     return;
   }
 
+  if (tsdf_change_detector_) {
+    ScopedTimer timer("places/tsdf_changes", msg.timestamp_ns);
+    tsdf_change_detector_->update(*tsdf_, *tsdf_changes_);
+  }
+
+  if (dynamic_voxels_) {
+    ScopedTimer timer("places/dynamic_voxels", msg.timestamp_ns);
+    dynamic_voxels_->update(*tsdf_, config_.mesh.min_weight, tsdf_changes_.get());
+  }
+
   {  // timing scope
     ScopedTimer timer("places/mesh", msg.timestamp_ns);
     mesh_integrator_->generateMesh(true, true);
@@ -299,18 +366,45 @@ void ReconstructionModule::updateGvd() {
     msg->pose_graphs.insert(
         msg->pose_graphs.begin(), pose_graphs.begin(), pose_graphs.end());
     timer.reset(new ScopedTimer("places/spin_gvd", msg->timestamp_ns));
-    gvd_integrator_->updateFromTsdf(
-        msg->timestamp_ns, *tsdf_, *vertices_, *mesh_, true);
+    gvd_integrator_->updateFromTsdf(msg->timestamp_ns,
+                                    *tsdf_,
+                                    *vertices_,
+                                    *mesh_,
+                                    true,
+                                    false,
+                                    tsdf_changes_.get());
+    if (tsdf_changes_) {
+      // every block with recorded changes was updated and consumed by the GVD
+      tsdf_changes_->clear();
+    }
 
     if (config_.clear_distant_blocks) {
       archived_blocks = findBlocksToArchive(msg->current_position.cast<float>());
       for (const auto& index : archived_blocks) {
-        semantics_->removeBlock(index);
+        if (quantized_tsdf_) {
+          quantized_tsdf_->removeBlock(index);
+        }
+        if (semantics_) {
+          semantics_->removeBlock(index);
+        }
+        if (compact_semantics_) {
+          compact_semantics_->removeBlock(index);
+        }
+        if (dynamic_voxels_) {
+          dynamic_voxels_->removeBlock(index);
+        }
+        if (tsdf_change_detector_) {
+          tsdf_change_detector_->removeBlock(index);
+        }
         tsdf_->removeBlock(index);
         mesh_->removeMesh(index);
       }
     }
 
+    if (quantized_tsdf_) {
+      quantizeInactiveBlocks(msg->current_position.cast<float>());
+    }
+
     addMeshToOutput(*msg, archived_blocks);
   }  // end critical section
 
@@ -483,26 +577,37 @@ void ReconstructionModule::addMeshToOutput(ReconstructionOutput& output,
 }
 
 void ReconstructionModule::showStats() const {
-  const std::string tsdf_memory_str =
-      getHumanReadableMemoryString(tsdf_->getMemorySize());
-  const std::string semantic_memory_str =
-      getHumanReadableMemoryString(semantics_->getMemorySize());
+  size_t tsdf_memory = tsdf_->getMemorySize();
+  if (quantized_tsdf_) {
+    tsdf_memory += quantized_tsdf_->getMemorySize();
+  }
+  const std::string tsdf_memory_str = getHumanReadableMemoryString(tsdf_memory);
+  const size_t semantic_memory = semantics_ ? semantics_->getMemorySize()
+                                            : compact_semantics_->getMemorySize();
+  const std::string semantic_memory_str = getHumanReadableMemoryString(semantic_memory);
   const std::string gvd_memory_str =
       getHumanReadableMemoryString(gvd_->getMemorySize());
   const std::string mesh_memory_str =
       getHumanReadableMemoryString(mesh_->getMemorySize());
-  const size_t total =
-      tsdf_->getMemorySize() + semantics_->getMemorySize() + gvd_->getMemorySize();
+  const size_t total = tsdf_memory + semantic_memory + gvd_->getMemorySize();
   LOG(INFO) << "Memory used: [TSDF=" << tsdf_memory_str
             << ", Semantics=" << semantic_memory_str << ", GVD=" << gvd_memory_str
             << ", Mesh= " << mesh_memory_str
             << ", Total=" << getHumanReadableMemoryString(total) << "]";
+  if (dynamic_voxels_) {
+    LOG(INFO) << "Dynamic voxels: " << dynamic_voxels_->numDynamic();
+  }
 }
 
 BlockIndexList ReconstructionModule::findBlocksToArchive(
     const voxblox::Point& center) const {
   BlockIndexList blocks;
   tsdf_->getAllAllocatedBlocks(&blocks);
+  if (quantized_tsdf_) {
+    BlockIndexList quantized_blocks;
+    quantized_tsdf_->getAllAllocatedBlocks(&quantized_blocks);
+    blocks.insert(blocks.end(), quantized_blocks.begin(), quantized_blocks.end());
+  }
 
   BlockIndexList to_archive;
   for (const auto& idx : blocks) {
@@ -518,4 +623,70 @@ BlockIndexList ReconstructionModule::findBlocksToArchive(
   return to_archive;
 }
 
+double ReconstructionModule::getResidentRadius() const {
+  // every neighbor of a block inside the active radius stays at full precision so
+  // that meshing and gradients across the boundary of the active region see both sides
+  return config_.active_block_radius_m + std::sqrt(3.0) * tsdf_->block_size();
+}
+
+void ReconstructionModule::quantizeInactiveBlocks(const voxblox::Point& center) {
+  BlockIndexList blocks;
+  tsdf_->getAllAllocatedBlocks(&blocks);
+
+  // hysteresis of a block to avoid converting blocks back and forth
+  const double radius = getResidentRadius() + tsdf_->block_size();
+  for (const auto& idx : blocks) {
+    auto block = tsdf_->getBlockPtrByIndex(idx);
+    if ((center - block->origin()).norm() < radius) {
+      continue;
+    }
+
+    if (block->updated().test(voxblox::Update::kMesh) ||
+        block->updated().test(voxblox::Update::kEsdf)) {
+      continue;  // pending updates need the full precision block
+    }
+
+    auto quantized = quantized_tsdf_->allocateBlockPtrByIndex(idx);
+    tsdf_quantizer_.quantizeBlock(*block, *quantized);
+    if (tsdf_change_detector_) {
+      tsdf_change_detector_->removeBlock(idx);
+    }
+    tsdf_->removeBlock(idx);
+  }
+}
+
+void ReconstructionModule::restoreActiveBlocks(const voxblox::Point& center) {
+  const double radius = getResidentRadius();
+  const float block_size = quantized_tsdf_->block_size();
+  const int extent = std::ceil(radius / block_size) + 1;
+  const BlockIndex center_index =
+      quantized_tsdf_->computeBlockIndexFromCoordinates(center);
+
+  // look up the blocks around the sensor instead of scanning every stored block
+  for (int x = -extent; x <= extent; ++x) {
+    for (int y = -extent; y <= extent; ++y) {
+      for (int z = -extent; z <= extent; ++z) {
+        const BlockIndex idx = center_index + BlockIndex(x, y, z);
+        auto quantized = quantized_tsdf_->getBlockPtrByIndex(idx);
+        if (!quantized) {
+          continue;
+        }
+
+        if ((center - quantized->origin()).norm() >= radius) {
+          continue;
+        }
+
+        // restored blocks don't get update flags: quantization doesn't need remeshing
+        auto block = tsdf_->allocateBlockPtrByIndex(idx);
+        tsdf_quantizer_.dequantizeBlock(*quantized, *block);
+        if (tsdf_change_detector_) {
+          // restoring a block doesn't change what the GVD has already seen
+          tsdf_change_detector_->resetBlock(idx, *block);
+        }
+        quantized_tsdf_->removeBlock(idx);
+      }
+    }
+  }
+}
+
 }  // namespace hydra
@@ -0,0 +1,149 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/reconstruction/tsdf_change_tracker.h"
+
+namespace hydra {
+
+using voxblox::BlockIndex;
+using voxblox::GlobalIndex;
+
+TsdfChangeTracker::TsdfChangeTracker(int voxels_per_side)
+    : voxels_per_side_(voxels_per_side) {}
+
+VoxelMask& TsdfChangeTracker::getMask(const BlockIndex& block_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = masks_.find(block_index);
+  if (iter == masks_.end()) {
+    const size_t num_voxels = voxels_per_side_ * voxels_per_side_ * voxels_per_side_;
+    iter = masks_.emplace(block_index, VoxelMask(num_voxels)).first;
+  }
+
+  // references to elements of unordered maps are stable under insertion
+  return iter->second;
+}
+
+void TsdfChangeTracker::markChanged(const GlobalIndex& index) {
+  BlockIndex block_index;
+  const size_t linear_index = getLinearIndex(index, block_index);
+  getMask(block_index).setAtomic(linear_index);
+}
+
+const VoxelMask* TsdfChangeTracker::getChanges(const BlockIndex& block_index) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = masks_.find(block_index);
+  return iter == masks_.end() ? nullptr : &iter->second;
+}
+
+void TsdfChangeTracker::clearBlock(const BlockIndex& block_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  masks_.erase(block_index);
+}
+
+void TsdfChangeTracker::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  masks_.clear();
+}
+
+size_t TsdfChangeTracker::getLinearIndex(const GlobalIndex& index,
+                                         BlockIndex& block_index) const {
+  voxblox::VoxelIndex voxel_index;
+  voxblox::getBlockAndVoxelIndexFromGlobalVoxelIndex(
+      index, voxels_per_side_, &block_index, &voxel_index);
+  const size_t vps = voxels_per_side_;
+  return voxel_index.x() + vps * (voxel_index.y() + vps * voxel_index.z());
+}
+
+TsdfChangeDetector::TsdfChangeDetector(float truncation_distance)
+    : quantizer_(truncation_distance) {}
+
+size_t TsdfChangeDetector::update(voxblox::Layer<voxblox::TsdfVoxel>& tsdf,
+                                  TsdfChangeTracker& changes) {
+  voxblox::BlockIndexList blocks;
+  tsdf.getAllUpdatedBlocks(voxblox::Update::kMap, &blocks);
+
+  size_t num_changed = 0;
+  for (const auto& idx : blocks) {
+    auto& block = tsdf.getBlockByIndex(idx);
+    block.updated().reset(voxblox::Update::kMap);
+
+    auto& state = blocks_[idx];
+    state.resize(block.num_voxels());
+
+    VoxelMask* mask = nullptr;
+    for (size_t i = 0; i < block.num_voxels(); ++i) {
+      const VoxelState curr = getState(block.getVoxelByLinearIndex(i));
+      VoxelState& prev = state[i];
+      if (curr.distance == prev.distance && curr.weight == prev.weight) {
+        continue;
+      }
+
+      prev = curr;
+      if (!mask) {
+        mask = &changes.getMask(idx);
+      }
+
+      mask->set(i);
+      ++num_changed;
+    }
+  }
+
+  return num_changed;
+}
+
+void TsdfChangeDetector::resetBlock(const BlockIndex& index,
+                                    const voxblox::Block<voxblox::TsdfVoxel>& block) {
+  auto& state = blocks_[index];
+  state.resize(block.num_voxels());
+  for (size_t i = 0; i < block.num_voxels(); ++i) {
+    state[i] = getState(block.getVoxelByLinearIndex(i));
+  }
+}
+
+void TsdfChangeDetector::removeBlock(const BlockIndex& index) { blocks_.erase(index); }
+
+size_t TsdfChangeDetector::numBlocks() const { return blocks_.size(); }
+
+TsdfChangeDetector::VoxelState TsdfChangeDetector::getState(
+    const voxblox::TsdfVoxel& voxel) const {
+  VoxelState state;
+  if (voxel.weight > 0.0f) {
+    state.distance = quantizer_.quantizeDistance(voxel.distance);
+    state.weight = TsdfQuantizer::quantizeWeight(voxel.weight);
+  }
+
+  return state;
+}
+
+}  // namespace hydra
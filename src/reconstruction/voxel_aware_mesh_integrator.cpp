@@ -41,7 +41,9 @@
 #include <glog/logging.h>
 #include <voxblox/utils/meshing_utils.h>
 
+#include <algorithm>
 #include <iomanip>
+#include <limits>
 
 #include "hydra/reconstruction/voxblox_utilities.h"
 #include "hydra/reconstruction/voxel_aware_marching_cubes.h"
@@ -70,16 +72,52 @@ using TsdfLayer = Layer<TsdfVoxel>;
 using TsdfBlock = Block<TsdfVoxel>;
 using VertexLayer = Layer<VertexVoxel>;
 
+namespace {
+
+// dynamic corners are treated as unobserved: they take the most-free distance of the
+// static corners so that static surfaces in the cube are still meshed
+inline bool fillDynamicCorners(uint8_t dynamic_corners, SdfMatrix& sdf) {
+  if (!dynamic_corners) {
+    return true;
+  }
+
+  if (dynamic_corners == 0xFF) {
+    return false;
+  }
+
+  FloatingPoint max_static = std::numeric_limits<FloatingPoint>::lowest();
+  for (int i = 0; i < 8; ++i) {
+    if (!(dynamic_corners & (1u << i))) {
+      max_static = std::max(max_static, sdf(i));
+    }
+  }
+
+  for (int i = 0; i < 8; ++i) {
+    if (dynamic_corners & (1u << i)) {
+      sdf(i) = max_static;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
 VoxelAwareMeshIntegrator::VoxelAwareMeshIntegrator(const MeshIntegratorConfig& config,
                                                    TsdfLayer* sdf_layer,
                                                    const VertexLayer::Ptr& vertex_layer,
                                                    MeshLayer* mesh_layer)
     : MeshIntegrator<TsdfVoxel>(config, sdf_layer, mesh_layer),
-      vertex_layer_(vertex_layer) {
+      vertex_layer_(vertex_layer),
+      dynamic_voxels_(nullptr) {
   DCHECK(vertex_layer_ != nullptr);
   cube_coord_offsets_ = cube_index_offsets_.cast<FloatingPoint>() * voxel_size_;
 }
 
+void VoxelAwareMeshIntegrator::setDynamicVoxels(const DynamicVoxelDetector* detector) {
+  dynamic_voxels_ = detector;
+}
+
 void VoxelAwareMeshIntegrator::launchThreads(const BlockIndexList& blocks,
                                              bool interior_pass) {
   std::unique_ptr<ThreadSafeIndex> index_getter(
@@ -261,20 +299,35 @@ void VoxelAwareMeshIntegrator::extractMeshInsideBlock(const TsdfBlock& block,
   auto vertex_block = vertex_layer_->getBlockPtrByIndex(block_idx);
   DCHECK(vertex_block != nullptr);
 
+  const VoxelMask* dynamic =
+      dynamic_voxels_ ? dynamic_voxels_->getDynamicMask(block_idx) : nullptr;
+
   SdfMatrix sdf;
   PointMatrix coords;
   std::vector<VertexVoxel*> voxels(8, nullptr);
+  uint8_t dynamic_corners = 0;
   for (int i = 0; i < 8; ++i) {
     VoxelIndex corner_index = index + cube_index_offsets_.col(i);
+    coords.col(i) = point + cube_coord_offsets_.col(i);
+
+    const auto linear_idx = block.computeLinearIndexFromVoxelIndex(corner_index);
+    if (dynamic && dynamic->test(linear_idx)) {
+      dynamic_corners |= (1u << i);
+      continue;
+    }
+
     const auto& voxel = block.getVoxelByVoxelIndex(corner_index);
     if (!vutils::getSdfIfValid(voxel, config_.min_weight, &(sdf(i)))) {
       return;
     }
 
-    coords.col(i) = point + cube_coord_offsets_.col(i);
     voxels[i] = &vertex_block->getVoxelByVoxelIndex(corner_index);
   }
 
+  if (!fillDynamicCorners(dynamic_corners, sdf)) {
+    return;
+  }
+
   VoxelAwareMarchingCubes::meshCube(block_idx, coords, sdf, new_mesh_idx, mesh, voxels);
 }
 
@@ -295,10 +348,13 @@ void VoxelAwareMeshIntegrator::extractMeshOnBorder(const TsdfBlock& block,
   SdfMatrix sdf;
   PointMatrix coords;
   std::vector<VertexVoxel*> voxels(8, nullptr);
+  uint8_t dynamic_corners = 0;
   for (int i = 0; i < 8; ++i) {
     VoxelIndex corner_index = index + cube_index_offsets_.col(i);
+    coords.col(i) = point + cube_coord_offsets_.col(i);
 
     const TsdfVoxel* voxel;
+    BlockIndex voxel_block_idx = block_idx;
     if (block.isValidVoxelIndex(corner_index)) {
       voxel = &block.getVoxelByVoxelIndex(corner_index);
       voxels[i] = &vertex_block->getVoxelByVoxelIndex(corner_index);
@@ -309,6 +365,8 @@ void VoxelAwareMeshIntegrator::extractMeshOnBorder(const TsdfBlock& block,
         return;
       }
 
+      voxel_block_idx = neighbor_idx;
+
       const auto& neighbor_block = sdf_layer_const_->getBlockByIndex(neighbor_idx);
       CHECK(neighbor_block.isValidVoxelIndex(corner_index));
 
@@ -319,11 +377,21 @@ void VoxelAwareMeshIntegrator::extractMeshOnBorder(const TsdfBlock& block,
       // voxels[i] = &neighbor_vertex_block->getVoxelByVoxelIndex(corner_index);
     }
 
+    // corner index is local to the block containing the voxel at this point
+    const auto linear_idx = block.computeLinearIndexFromVoxelIndex(corner_index);
+    if (dynamic_voxels_ && dynamic_voxels_->isDynamic(voxel_block_idx, linear_idx)) {
+      dynamic_corners |= (1u << i);
+      voxels[i] = nullptr;
+      continue;
+    }
+
     if (!vutils::getSdfIfValid(*voxel, config_.min_weight, &(sdf(i)))) {
       return;
     }
+  }
 
-    coords.col(i) = point + cube_coord_offsets_.col(i);
+  if (!fillDynamicCorners(dynamic_corners, sdf)) {
+    return;
   }
 
   VoxelAwareMarchingCubes::meshCube(block_idx, coords, sdf, new_mesh_idx, mesh, voxels);
@@ -63,7 +63,8 @@ void ClusterResults::fillFromInitialClusters(const InitialClusters& initial_clus
 ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
                                         const InitialClusters& initial_clusters,
                                         size_t max_iters,
-                                        double gamma) {
+                                        double gamma,
+                                        const NodeFilter& filter) {
   return clusterGraphByModularity(
       layer,
       initial_clusters,
@@ -71,20 +72,32 @@ ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
         return G.getEdge(n1, n2)->get().info->weight;
       },
       max_iters,
-      gamma);
+      gamma,
+      filter);
 }
 
 ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
                                         const InitialClusters& initial_clusters,
                                         const EdgeWeightFunc& edge_weight_func,
                                         size_t max_iters,
-                                        double gamma) {
+                                        double gamma,
+                                        const NodeFilter& filter) {
   std::map<NodeId, double> degrees;
   std::map<NodeId, std::map<NodeId, double>> neighbors;
+  size_t num_sibling_pairs = 0;
   for (const auto& id_node_pair : layer.nodes()) {
+    if (!passesFilter(filter, id_node_pair.first)) {
+      continue;
+    }
+
     double degree = 0.0;
     neighbors[id_node_pair.first] = std::map<NodeId, double>();
     for (const auto& sibling : id_node_pair.second->siblings()) {
+      if (!passesFilter(filter, sibling)) {
+        continue;
+      }
+
+      ++num_sibling_pairs;
       double edge_weight = edge_weight_func(layer, id_node_pair.first, sibling);
       // we should probably assert that this isn't happening, but it should be pretty
       // feasbile to not return negative weights
@@ -95,7 +108,8 @@ ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
     degrees[id_node_pair.first] = degree;
   }
 
-  const double m = layer.numEdges();
+  // every edge is seen from both endpoints
+  const double m = filter ? num_sibling_pairs / 2 : layer.numEdges();
 
   std::map<size_t, double> community_degrees;
   std::map<NodeId, size_t> labels;
@@ -111,7 +125,7 @@ ClusterResults clusterGraphByModularity(const SceneGraphLayer& layer,
 
   std::set<NodeId> unlabeled_nodes;
   for (const auto& id_node_pair : layer.nodes()) {
-    if (labels.count(id_node_pair.first)) {
+    if (labels.count(id_node_pair.first) || !passesFilter(filter, id_node_pair.first)) {
       continue;
     }
 
@@ -193,7 +207,8 @@ struct EdgeInfo {
 };
 
 ClusterResults clusterGraphByNeighbors(const SceneGraphLayer& layer,
-                                       const InitialClusters& initial_clusters) {
+                                       const InitialClusters& initial_clusters,
+                                       const NodeFilter& filter) {
   std::map<NodeId, size_t> labels;
   for (size_t i = 0; i < initial_clusters.size(); ++i) {
     const auto& component = initial_clusters[i];
@@ -205,7 +220,7 @@ ClusterResults clusterGraphByNeighbors(const SceneGraphLayer& layer,
   // populate frontier from all room boundaries
   std::priority_queue<EdgeInfo> frontier;
   for (auto&& [id, node] : layer.nodes()) {
-    if (labels.count(id)) {
+    if (labels.count(id) || !passesFilter(filter, id)) {
       continue;
     }
 
@@ -230,7 +245,7 @@ ClusterResults clusterGraphByNeighbors(const SceneGraphLayer& layer,
     labels[candidate.id] = candidate.label;
     const SceneGraphNode& node = layer.getNode(candidate.id).value();
     for (const auto sibling : node.siblings()) {
-      if (labels.count(sibling)) {
+      if (labels.count(sibling) || !passesFilter(filter, sibling)) {
         continue;
       }
 
@@ -36,10 +36,88 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <iomanip>
 
 namespace hydra {
 
+RollbackDisjointSet::RollbackDisjointSet() : num_applied(0) {}
+
+std::optional<NodeId> RollbackDisjointSet::doUnion(NodeId lhs,
+                                                   NodeId rhs,
+                                                   double distance,
+                                                   bool rhs_better) {
+  CHECK_EQ(num_applied, events.size()) << "cannot add unions after a rollback";
+
+  const NodeId lhs_set = findSet(lhs);
+  const NodeId rhs_set = findSet(rhs);
+  if (lhs_set == rhs_set) {
+    return std::nullopt;
+  }
+
+  const size_t lhs_size = sizes.at(lhs_set);
+  const size_t rhs_size = sizes.at(rhs_set);
+  const auto erased = DisjointSet::doUnion(lhs_set, rhs_set, rhs_better);
+  const NodeId parent = erased.value() == rhs_set ? lhs_set : rhs_set;
+  const size_t child_size = erased.value() == rhs_set ? rhs_size : lhs_size;
+  events.push_back({distance, parent, erased.value(), child_size});
+  ++num_applied;
+  return erased;
+}
+
+void RollbackDisjointSet::setThreshold(double threshold) {
+  while (num_applied > 0 && events[num_applied - 1].distance <= threshold) {
+    const auto& event = events[--num_applied];
+    parents[event.child] = event.child;
+    sizes[event.parent] -= event.child_size;
+    sizes[event.child] = event.child_size;
+    roots.insert(event.child);
+  }
+
+  while (num_applied < events.size() && events[num_applied].distance > threshold) {
+    const auto& event = events[num_applied++];
+    parents[event.child] = event.parent;
+    sizes[event.parent] += event.child_size;
+    sizes.erase(event.child);
+    roots.erase(event.child);
+  }
+}
+
+std::vector<std::vector<NodeId>> RollbackDisjointSet::getComponents(
+    size_t min_component_size, const NodeFilter& filter) const {
+  std::vector<NodeId> nodes;
+  nodes.reserve(parents.size());
+  for (const auto& id_parent_pair : parents) {
+    if (!filter || filter(id_parent_pair.first)) {
+      nodes.push_back(id_parent_pair.first);
+    }
+  }
+
+  std::sort(nodes.begin(), nodes.end());
+
+  std::vector<std::vector<NodeId>> components;
+  std::unordered_map<NodeId, size_t> root_to_component;
+  for (const auto node : nodes) {
+    const auto root = findSet(node);
+    auto iter = root_to_component.find(root);
+    if (iter == root_to_component.end()) {
+      iter = root_to_component.emplace(root, components.size()).first;
+      components.push_back({});
+    }
+
+    components[iter->second].push_back(node);
+  }
+
+  std::vector<std::vector<NodeId>> filtered;
+  for (auto& component : components) {
+    if (component.size() >= min_component_size) {
+      filtered.push_back(std::move(component));
+    }
+  }
+
+  return filtered;
+}
+
 BarcodeTracker::BarcodeTracker() : BarcodeTracker(0) {}
 
 BarcodeTracker::BarcodeTracker(size_t min_component_size)
@@ -51,7 +129,7 @@ void BarcodeTracker::addNode(NodeId node, double distance) {
   }
 }
 
-bool BarcodeTracker::doUnion(DisjointSet& components,
+bool BarcodeTracker::doUnion(RollbackDisjointSet& components,
                              const std::unordered_map<NodeId, double>& node_distances,
                              NodeId lhs,
                              NodeId rhs,
@@ -62,7 +140,7 @@ bool BarcodeTracker::doUnion(DisjointSet& components,
   // note that this works: nothing in disjoint set relies on lhs and rhs, just their
   // parents
   const auto rhs_better = node_distances.at(rhs_set) >= node_distances.at(lhs_set);
-  const auto erased = components.doUnion(lhs_set, rhs_set, rhs_better);
+  const auto erased = components.doUnion(lhs_set, rhs_set, distance, rhs_better);
   if (!erased) {
     return false;
   }
@@ -139,15 +217,24 @@ std::ostream& operator<<(std::ostream& out, const Entry& e) {
 void fillEntries(const SceneGraphLayer& layer,
                  std::vector<Entry>& entries,
                  std::unordered_map<NodeId, double>& node_distances,
-                 bool include_nodes) {
+                 bool include_nodes,
+                 const NodeFilter& filter) {
   entries.reserve(layer.edges().size() + layer.nodes().size());
 
   for (const auto& id_edge_pair : layer.edges()) {
     const auto& edge = id_edge_pair.second;
+    if (!passesFilter(filter, edge.source) || !passesFilter(filter, edge.target)) {
+      continue;
+    }
+
     entries.push_back({edge.info->weight, edge.source, edge.target});
   }
 
   for (auto&& [id, node] : layer.nodes()) {
+    if (!passesFilter(filter, id)) {
+      continue;
+    }
+
     const auto distance = node->attributes<PlaceNodeAttributes>().distance;
     node_distances.emplace(id, distance);
 
@@ -162,7 +249,7 @@ void fillEntries(const SceneGraphLayer& layer,
 bool updateComponentsFromEdge(NodeId source,
                               NodeId target,
                               double edge_distance,
-                              DisjointSet& components,
+                              RollbackDisjointSet& components,
                               BarcodeTracker& tracker,
                               UnusedEdgeMap& unused_edges,
                               std::unordered_map<NodeId, double>& node_distances) {
@@ -194,7 +281,7 @@ bool updateComponentsFromEdge(NodeId source,
 }
 
 void updateComponentsFromNode(NodeId node,
-                              DisjointSet& components,
+                              RollbackDisjointSet& components,
                               BarcodeTracker& tracker,
                               UnusedEdgeMap& unused_edges,
                               std::unordered_map<NodeId, double>& node_distances) {
@@ -258,16 +345,23 @@ Filtration getGraphFiltration(const SceneGraphLayer& layer,
                               BarcodeTracker& tracker,
                               double diff_threshold_m,
                               const ComponentCallback& count_components,
-                              bool include_nodes) {
+                              bool include_nodes,
+                              RollbackDisjointSet* components_out,
+                              const NodeFilter& filter) {
   std::vector<Entry> entries;
   std::unordered_map<NodeId, double> node_distances;
-  fillEntries(layer, entries, node_distances, include_nodes);
+  fillEntries(layer, entries, node_distances, include_nodes, filter);
 
-  DisjointSet components;
+  RollbackDisjointSet local_components;
+  auto& components = components_out ? *components_out : local_components;
   UnusedEdgeMap unused_edges;
   if (!include_nodes) {
     // seed components with all nodes if we're not including nodes in the filtration
     for (const auto& id_node_pair : layer.nodes()) {
+      if (!passesFilter(filter, id_node_pair.first)) {
+        continue;
+      }
+
       updateComponentsFromNode(
           id_node_pair.first, components, tracker, unused_edges, node_distances);
     }
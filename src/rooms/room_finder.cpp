@@ -39,6 +39,7 @@
 #include <Eigen/Dense>
 #include <algorithm>
 #include <queue>
+#include <unordered_map>
 
 #include "hydra/common/hydra_config.h"
 #include "hydra/rooms/graph_filtration.h"
@@ -80,81 +81,26 @@ void fillIndexQueue(const SceneGraphLayer& places,
   }
 }
 
-void logFiltration(std::ostream& fout,
-                   const Filtration& filtration,
-                   const std::pair<size_t, size_t>& window,
-                   double distance) {
-  fout << "{";
-  fout << "\"start\":" << window.first << ",\"end\":" << window.second
-       << ",\"threshold\":" << distance << ",\"filtration\":[";
-  auto iter = filtration.begin();
-  while (iter != filtration.end()) {
-    fout << "{\"c\":" << iter->num_components << ",\"d\":" << iter->distance << "}";
-    ++iter;
-    if (iter != filtration.end()) {
-      fout << ",";
-    }
+RoomFinder::RoomFinder(const RoomFinderConfig& config) : config_(config) {
+  if (config_.partition_by_floor) {
+    floor_workers_.reset(new WorkerPool(config_.num_partition_threads));
   }
-  fout << "]},";
 }
 
-RoomFinder::RoomFinder(const RoomFinderConfig& config) : config_(config) {}
-
-RoomFinder::~RoomFinder() {
-  if (log_file_) {
-    if (logged_once_) {
-      const size_t curr_pos = log_file_->tellp();
-      log_file_->seekp(curr_pos - 1);
-    }
-
-    (*log_file_) << "]";
-    if (graph_log_file_) {
-      graph_log_file_->flush();
-      graph_log_file_->close();
-      graph_log_file_.reset();
-
-      auto& fout = *log_file_;
-      fout << ",\"offsets\":[";
-      for (size_t i = 0; i < graph_entries_.size(); ++i) {
-        const auto& entry = graph_entries_[i];
-        fout << "{\"index\":" << i;
-        fout << ",\"offset\":" << entry.offset;
-        fout << ",\"size\":" << entry.size;
-        fout << ",\"num_nodes\":" << entry.num_nodes;
-        fout << ",\"num_edges\":" << entry.num_edges;
-        fout << "}";
-        if (i + 1 < graph_entries_.size()) {
-          fout << ",";
-        }
-      }
-      fout << "]";
-    }
-
-    (*log_file_) << "}" << std::endl;
-    log_file_->flush();
-    log_file_->close();
-    log_file_.reset();
-  }
-}
+RoomFinder::~RoomFinder() = default;
 
 void RoomFinder::enableLogging(const std::string& log_path) {
   if (!config_.log_filtrations) {
     return;
   }
 
-  log_file_.reset(new std::ofstream(log_path + ".json"));
-  (*log_file_) << "{\"contents\":[";
-
-  if (!config_.log_place_graphs) {
-    return;
-  }
-
-  const std::string gname = log_path + ".graphs";
-  graph_log_file_.reset(new std::ofstream(gname, std::ios::binary));
+  logger_.reset(new RoomFinderLogger(log_path + ".bin", config_.graph_keyframe_period));
 }
 
-InitialClusters RoomFinder::getBestComponents(const SceneGraphLayer& places) const {
+InitialClusters RoomFinder::getBestComponents(const SceneGraphLayer& places,
+                                              const NodeFilter& filter) const {
   BarcodeTracker tracker(config_.min_component_size);
+  RollbackDisjointSet components;
   const auto filtration = getGraphFiltration(
       places,
       tracker,
@@ -168,7 +114,9 @@ InitialClusters RoomFinder::getBestComponents(const SceneGraphLayer& places) con
         }
         return num_components;
       },
-      false);
+      false,
+      &components,
+      filter);
 
   VLOG(10) << "[RoomFinder] Filtration: " << filtration;
 
@@ -232,55 +180,60 @@ InitialClusters RoomFinder::getBestComponents(const SceneGraphLayer& places) con
   VLOG(3) << "[RoomFinder] Best threshold: " << info.distance << " ("
           << info.num_components << " components)";
 
-  if (log_file_) {
-    if (graph_log_file_) {
-      const auto bson_str = places.toBson();
-      graph_entries_.push_back(
-          {graph_offset_, bson_str.size(), places.numNodes(), places.numEdges()});
-      graph_log_file_->write(bson_str.data(), bson_str.size());
-      graph_offset_ += bson_str.size();
-    }
-
-    logFiltration(*log_file_, filtration, window, info.distance);
-    logged_once_ = true;
-  }
-
-  const auto components = graph_utilities::getConnectedComponents(
-      places,
-      [&](const SceneGraphNode& node) {
-        return node.attributes<PlaceNodeAttributes>().distance > info.distance;
-      },
-      [&](const SceneGraphEdge& edge) { return edge.info->weight > info.distance; });
-
-  InitialClusters filtered;
-  for (const auto& component : components) {
-    if (component.size() < config_.min_component_size) {
-      continue;
-    }
-
-    filtered.push_back(component);
+  if (logger_) {
+    logger_->logFiltration(num_updates_, filtration, window, info.distance);
   }
 
-  return filtered;
+  // roll the filtration back to the partition induced by edges above the threshold.
+  // place edge weights never exceed the distance of either endpoint, so only isolated
+  // nodes below the threshold need to be filtered out
+  components.setThreshold(info.distance);
+  return components.getComponents(config_.min_component_size, [&](NodeId node) {
+    const auto& attrs = places.getNode(node)->get().attributes<PlaceNodeAttributes>();
+    return attrs.distance > info.distance;
+  });
 }
 
 SceneGraphLayer::Ptr RoomFinder::findRooms(const SceneGraphLayer& places) {
   VLOG(3) << "[Room Finder] Detecting rooms for " << places.numNodes() << " nodes";
 
-  const auto components = getBestComponents(places);
-  if (components.empty()) {
+  ++num_updates_;
+  const size_t log_period = std::max<size_t>(config_.place_graph_log_period, 1);
+  if (logger_ && config_.log_place_graphs && num_updates_ % log_period == 0) {
+    // copying the layer runs on the calling thread, so large graphs are rate-limited
+    logger_->logPlaces(num_updates_, places);
+  }
+
+  auto results =
+      config_.partition_by_floor ? findClustersByFloor(places) : findClusters(places);
+  if (!results.valid) {
     VLOG(1) << "[Room Finder] No rooms found";
     return nullptr;
   }
 
-  last_results_.clear();
+  last_results_ = std::move(results);
+  cluster_room_map_.clear();
+  return makeRoomLayer(places);
+}
+
+ClusterResults RoomFinder::findClusters(const SceneGraphLayer& places,
+                                        const NodeFilter& filter) const {
+  const auto components = getBestComponents(places, filter);
+  if (components.empty()) {
+    return {};
+  }
+
+  ClusterResults results;
   switch (config_.clustering_mode) {
     case RoomClusterMode::MODULARITY:
-      last_results_ = clusterGraphByModularity(
-          places, components, config_.max_modularity_iters, config_.modularity_gamma);
+      results = clusterGraphByModularity(places,
+                                         components,
+                                         config_.max_modularity_iters,
+                                         config_.modularity_gamma,
+                                         filter);
       break;
     case RoomClusterMode::MODULARITY_DISTANCE:
-      last_results_ = clusterGraphByModularity(
+      results = clusterGraphByModularity(
           places,
           components,
           [](const SceneGraphLayer& G, NodeId n1, NodeId n2) {
@@ -288,24 +241,73 @@ SceneGraphLayer::Ptr RoomFinder::findRooms(const SceneGraphLayer& places) {
             return 1.0 / (G.getPosition(n1) - G.getPosition(n2)).norm();
           },
           config_.max_modularity_iters,
-          config_.modularity_gamma);
+          config_.modularity_gamma,
+          filter);
       break;
     case RoomClusterMode::NEIGHBORS:
-      last_results_ = clusterGraphByNeighbors(places, components);
+      results = clusterGraphByNeighbors(places, components, filter);
       break;
     case RoomClusterMode::NONE:
     default:
-      last_results_.fillFromInitialClusters(components);
+      results.fillFromInitialClusters(components);
       break;
   }
 
-  if (!last_results_.valid) {
+  if (!results.valid) {
     LOG(WARNING) << "[Room Finder] clustering failed: using components";
-    last_results_.fillFromInitialClusters(components);
+    results.clear();
+    results.fillFromInitialClusters(components);
   }
 
-  cluster_room_map_.clear();
-  return makeRoomLayer(places);
+  return results;
+}
+
+ClusterResults RoomFinder::findClustersByFloor(const SceneGraphLayer& places) const {
+  // floors smaller than a single component can't contain a room
+  const auto partitions = partitionPlacesByFloor(places,
+                                                 config_.floor_bin_size_m,
+                                                 config_.min_floor_separation_m,
+                                                 config_.max_floor_valley_ratio,
+                                                 config_.min_component_size);
+  VLOG(3) << "[Room Finder] Detecting rooms for " << partitions.size() << " floors";
+
+  // each floor is a filtered view of the places instead of a copy
+  std::unordered_map<NodeId, size_t> node_floors;
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    for (const auto node : partitions[i]) {
+      node_floors.emplace(node, i);
+    }
+  }
+
+  std::vector<ClusterResults> floor_results(partitions.size());
+  floor_workers_->run(partitions.size(), [&](size_t index) {
+    floor_results[index] = findClusters(places, [&](NodeId node) {
+      const auto iter = node_floors.find(node);
+      return iter != node_floors.end() && iter->second == index;
+    });
+  });
+
+  // merge results in partition order, keeping cluster indices unique
+  ClusterResults merged;
+  merged.total_iters = 0;
+  size_t offset = 0;
+  for (const auto& results : floor_results) {
+    size_t num_indices = 0;
+    for (const auto& id_cluster_pair : results.clusters) {
+      merged.clusters.emplace(offset + id_cluster_pair.first, id_cluster_pair.second);
+      num_indices = std::max(num_indices, id_cluster_pair.first + 1);
+    }
+
+    for (const auto& node_label_pair : results.labels) {
+      merged.labels.emplace(node_label_pair.first, offset + node_label_pair.second);
+    }
+
+    merged.valid |= results.valid;
+    merged.total_iters = std::max(merged.total_iters, results.total_iters);
+    offset += num_indices;
+  }
+
+  return merged;
 }
 
 SceneGraphLayer::Ptr RoomFinder::makeRoomLayer(const SceneGraphLayer& places) {
@@ -0,0 +1,344 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/rooms/room_finder_logger.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <map>
+
+namespace hydra {
+
+namespace {
+
+// write records once this much data has been buffered
+constexpr size_t kBatchSizeBytes = 1 << 16;
+
+template <typename T>
+inline void append(std::string& buffer, const T& value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void appendNodes(std::string& buffer,
+                        const std::vector<PlacesSnapshot::Node>& nodes) {
+  append(buffer, static_cast<uint32_t>(nodes.size()));
+  for (const auto& node : nodes) {
+    append(buffer, static_cast<uint64_t>(node.id));
+    append(buffer, node.x);
+    append(buffer, node.y);
+    append(buffer, node.z);
+    append(buffer, node.distance);
+  }
+}
+
+inline void appendEdges(std::string& buffer,
+                        const std::vector<PlacesSnapshot::Edge>& edges) {
+  append(buffer, static_cast<uint32_t>(edges.size()));
+  for (const auto& edge : edges) {
+    append(buffer, static_cast<uint64_t>(edge.source));
+    append(buffer, static_cast<uint64_t>(edge.target));
+    append(buffer, edge.weight);
+  }
+}
+
+inline bool edgeLess(const PlacesSnapshot::Edge& lhs, const PlacesSnapshot::Edge& rhs) {
+  return lhs.source < rhs.source ||
+         (lhs.source == rhs.source && lhs.target < rhs.target);
+}
+
+// merges two sorted sequences, calling the handlers for removed, added or shared
+// elements
+template <typename T, typename Less, typename Removed, typename Added, typename Shared>
+void mergeSorted(const std::vector<T>& prev,
+                 const std::vector<T>& curr,
+                 const Less& less,
+                 const Removed& removed,
+                 const Added& added,
+                 const Shared& shared) {
+  size_t i = 0;
+  size_t j = 0;
+  while (i < prev.size() || j < curr.size()) {
+    if (j == curr.size() || (i < prev.size() && less(prev[i], curr[j]))) {
+      removed(prev[i++]);
+    } else if (i == prev.size() || less(curr[j], prev[i])) {
+      added(curr[j++]);
+    } else {
+      shared(prev[i++], curr[j++]);
+    }
+  }
+}
+
+}  // namespace
+
+bool PlacesSnapshot::Node::operator==(const Node& other) const {
+  return id == other.id && x == other.x && y == other.y && z == other.z &&
+         distance == other.distance;
+}
+
+bool PlacesSnapshot::Edge::operator==(const Edge& other) const {
+  return source == other.source && target == other.target && weight == other.weight;
+}
+
+PlacesSnapshot PlacesSnapshot::fromLayer(const SceneGraphLayer& places) {
+  auto snapshot = copyLayer(places);
+  snapshot.sort();
+  return snapshot;
+}
+
+PlacesSnapshot PlacesSnapshot::copyLayer(const SceneGraphLayer& places) {
+  PlacesSnapshot snapshot;
+  snapshot.nodes.reserve(places.numNodes());
+  for (const auto& id_node_pair : places.nodes()) {
+    const auto& attrs = id_node_pair.second->attributes<PlaceNodeAttributes>();
+    snapshot.nodes.push_back({id_node_pair.first,
+                              static_cast<float>(attrs.position.x()),
+                              static_cast<float>(attrs.position.y()),
+                              static_cast<float>(attrs.position.z()),
+                              static_cast<float>(attrs.distance)});
+  }
+
+  snapshot.edges.reserve(places.numEdges());
+  for (const auto& id_edge_pair : places.edges()) {
+    const auto& edge = id_edge_pair.second;
+    snapshot.edges.push_back({std::min(edge.source, edge.target),
+                              std::max(edge.source, edge.target),
+                              static_cast<float>(edge.info->weight)});
+  }
+
+  return snapshot;
+}
+
+void PlacesSnapshot::sort() {
+  // node containers are ordered, but edge containers aren't guaranteed to be
+  std::sort(nodes.begin(), nodes.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.id < rhs.id;
+  });
+  std::sort(edges.begin(), edges.end(), edgeLess);
+}
+
+PlacesDelta PlacesDelta::between(const PlacesSnapshot& prev,
+                                 const PlacesSnapshot& curr) {
+  using Node = PlacesSnapshot::Node;
+  using Edge = PlacesSnapshot::Edge;
+
+  PlacesDelta delta;
+  mergeSorted(
+      prev.nodes,
+      curr.nodes,
+      [](const Node& lhs, const Node& rhs) { return lhs.id < rhs.id; },
+      [&](const Node& node) { delta.removed_nodes.push_back(node.id); },
+      [&](const Node& node) { delta.nodes.push_back(node); },
+      [&](const Node& prev_node, const Node& curr_node) {
+        if (!(prev_node == curr_node)) {
+          delta.nodes.push_back(curr_node);
+        }
+      });
+
+  mergeSorted(
+      prev.edges,
+      curr.edges,
+      edgeLess,
+      [&](const Edge& edge) {
+        delta.removed_edges.push_back({edge.source, edge.target});
+      },
+      [&](const Edge& edge) { delta.edges.push_back(edge); },
+      [&](const Edge& prev_edge, const Edge& curr_edge) {
+        if (!(prev_edge == curr_edge)) {
+          delta.edges.push_back(curr_edge);
+        }
+      });
+
+  return delta;
+}
+
+void PlacesDelta::apply(PlacesSnapshot& snapshot) const {
+  std::map<NodeId, PlacesSnapshot::Node> nodes;
+  for (const auto& node : snapshot.nodes) {
+    nodes.emplace(node.id, node);
+  }
+
+  for (const auto node : removed_nodes) {
+    nodes.erase(node);
+  }
+
+  for (const auto& node : this->nodes) {
+    nodes[node.id] = node;
+  }
+
+  std::map<std::pair<NodeId, NodeId>, PlacesSnapshot::Edge> edges;
+  for (const auto& edge : snapshot.edges) {
+    edges.emplace(std::make_pair(edge.source, edge.target), edge);
+  }
+
+  for (const auto& edge : removed_edges) {
+    edges.erase(edge);
+  }
+
+  for (const auto& edge : this->edges) {
+    edges[{edge.source, edge.target}] = edge;
+  }
+
+  snapshot.nodes.clear();
+  for (const auto& id_node_pair : nodes) {
+    snapshot.nodes.push_back(id_node_pair.second);
+  }
+
+  snapshot.edges.clear();
+  for (const auto& key_edge_pair : edges) {
+    snapshot.edges.push_back(key_edge_pair.second);
+  }
+}
+
+RoomFinderLogger::RoomFinderLogger(const std::string& log_path, size_t keyframe_period)
+    : keyframe_period_(std::max<size_t>(keyframe_period, 1)),
+      fout_(log_path, std::ios::binary),
+      num_since_keyframe_(0) {
+  if (!fout_.good()) {
+    LOG(ERROR) << "[Room Finder] Unable to open log: " << log_path;
+  }
+
+  buffer_.append("HRFL", 4);
+  append(buffer_, VERSION);
+  thread_.reset(new std::thread(&RoomFinderLogger::spin, this));
+}
+
+RoomFinderLogger::~RoomFinderLogger() {
+  should_shutdown_ = true;
+  if (thread_) {
+    thread_->join();
+    thread_.reset();
+  }
+
+  flush();
+  fout_.close();
+}
+
+void RoomFinderLogger::logPlaces(size_t update, const SceneGraphLayer& places) {
+  auto record = std::make_shared<Record>();
+  record->type = RecordType::KEYFRAME;  // writer decides whether to send a delta
+  record->update = update;
+  // sorting is left to the writer thread
+  record->places = std::make_unique<PlacesSnapshot>(PlacesSnapshot::copyLayer(places));
+  queue_.push(record);
+}
+
+void RoomFinderLogger::logFiltration(size_t update,
+                                     const Filtration& filtration,
+                                     const std::pair<size_t, size_t>& window,
+                                     double threshold) {
+  auto record = std::make_shared<Record>();
+  record->type = RecordType::FILTRATION;
+  record->update = update;
+  record->filtration = filtration;
+  record->window = window;
+  record->threshold = threshold;
+  queue_.push(record);
+}
+
+void RoomFinderLogger::spin() {
+  while (!should_shutdown_) {
+    if (!queue_.poll()) {
+      continue;
+    }
+
+    writeRecord(*queue_.pop());
+  }
+
+  while (!queue_.empty()) {
+    writeRecord(*queue_.pop());
+  }
+}
+
+void RoomFinderLogger::writeRecord(Record& record) {
+  std::string payload;
+  RecordType type = record.type;
+  if (record.places) {
+    record.places->sort();
+  }
+
+  if (type == RecordType::FILTRATION) {
+    append(payload, static_cast<uint32_t>(record.window.first));
+    append(payload, static_cast<uint32_t>(record.window.second));
+    append(payload, record.threshold);
+    append(payload, static_cast<uint32_t>(record.filtration.size()));
+    for (const auto& info : record.filtration) {
+      append(payload, info.distance);
+      append(payload, static_cast<uint32_t>(info.num_components));
+    }
+  } else if (!prev_places_ || num_since_keyframe_ + 1 >= keyframe_period_) {
+    type = RecordType::KEYFRAME;
+    appendNodes(payload, record.places->nodes);
+    appendEdges(payload, record.places->edges);
+    num_since_keyframe_ = 0;
+  } else {
+    type = RecordType::DELTA;
+    const auto delta = PlacesDelta::between(*prev_places_, *record.places);
+    append(payload, static_cast<uint32_t>(delta.removed_nodes.size()));
+    for (const auto node : delta.removed_nodes) {
+      append(payload, static_cast<uint64_t>(node));
+    }
+
+    appendNodes(payload, delta.nodes);
+    append(payload, static_cast<uint32_t>(delta.removed_edges.size()));
+    for (const auto& edge : delta.removed_edges) {
+      append(payload, static_cast<uint64_t>(edge.first));
+      append(payload, static_cast<uint64_t>(edge.second));
+    }
+
+    appendEdges(payload, delta.edges);
+    ++num_since_keyframe_;
+  }
+
+  if (record.places) {
+    // records are only read by this thread, so the snapshot can be reused
+    prev_places_ = std::move(record.places);
+  }
+
+  append(buffer_, static_cast<uint8_t>(type));
+  append(buffer_, static_cast<uint32_t>(record.update));
+  append(buffer_, static_cast<uint32_t>(payload.size()));
+  buffer_.append(payload);
+  if (buffer_.size() >= kBatchSizeBytes) {
+    flush();
+  }
+}
+
+void RoomFinderLogger::flush() {
+  fout_.write(buffer_.data(), buffer_.size());
+  fout_.flush();
+  buffer_.clear();
+}
+
+}  // namespace hydra
@@ -34,6 +34,9 @@
  * -------------------------------------------------------------------------- */
 #include "hydra/rooms/room_utilities.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace hydra {
 
 Eigen::Vector3d getRoomPosition(const SceneGraphLayer& places,
@@ -115,4 +118,111 @@ void addEdgesToRoomLayer(const SceneGraphLayer& places,
   }
 }
 
+std::vector<double> findFloorBoundaries(const std::vector<double>& heights,
+                                        double bin_size_m,
+                                        double min_separation_m,
+                                        double max_valley_ratio) {
+  if (heights.empty()) {
+    return {};
+  }
+
+  const auto bounds = std::minmax_element(heights.begin(), heights.end());
+  const double min_height = *bounds.first;
+  const auto num_bins =
+      static_cast<size_t>((*bounds.second - min_height) / bin_size_m) + 1;
+  std::vector<size_t> counts(num_bins, 0);
+  for (const auto height : heights) {
+    const auto bin = static_cast<size_t>((height - min_height) / bin_size_m);
+    ++counts[std::min(bin, num_bins - 1)];
+  }
+
+  // peaks are the first largest bin within the separation radius
+  const auto radius =
+      std::max<int64_t>(1, std::lround(min_separation_m / bin_size_m));
+  std::vector<size_t> peaks;
+  for (size_t i = 0; i < num_bins; ++i) {
+    if (!counts[i]) {
+      continue;
+    }
+
+    bool is_peak = true;
+    const auto center = static_cast<int64_t>(i);
+    const int64_t lower = std::max<int64_t>(0, center - radius);
+    const int64_t upper = std::min<int64_t>(num_bins - 1, center + radius);
+    for (int64_t j = lower; j <= upper && is_peak; ++j) {
+      const auto idx = static_cast<size_t>(j);
+      is_peak = idx < i ? counts[idx] < counts[i] : counts[idx] <= counts[i];
+    }
+
+    if (is_peak) {
+      peaks.push_back(i);
+    }
+  }
+
+  std::vector<double> boundaries;
+  if (peaks.empty()) {
+    return boundaries;
+  }
+
+  size_t prev_peak = peaks.front();
+  for (size_t p = 1; p < peaks.size(); ++p) {
+    const size_t peak = peaks[p];
+    const auto min_count =
+        *std::min_element(counts.begin() + prev_peak, counts.begin() + peak);
+
+    // split in the middle of the emptiest bins
+    std::vector<size_t> valley_bins;
+    for (size_t i = prev_peak; i < peak; ++i) {
+      if (counts[i] == min_count) {
+        valley_bins.push_back(i);
+      }
+    }
+
+    const size_t valley = valley_bins[valley_bins.size() / 2];
+
+    const double smaller_peak = std::min(counts[prev_peak], counts[peak]);
+    if (min_count <= max_valley_ratio * smaller_peak) {
+      boundaries.push_back(min_height + (valley + 0.5) * bin_size_m);
+      prev_peak = peak;
+    } else if (counts[peak] > counts[prev_peak]) {
+      prev_peak = peak;  // merged floors are represented by their largest peak
+    }
+  }
+
+  return boundaries;
+}
+
+std::vector<std::vector<NodeId>> partitionPlacesByFloor(const SceneGraphLayer& places,
+                                                        double bin_size_m,
+                                                        double min_separation_m,
+                                                        double max_valley_ratio,
+                                                        size_t min_partition_size) {
+  std::vector<double> heights;
+  heights.reserve(places.numNodes());
+  for (const auto& id_node_pair : places.nodes()) {
+    heights.push_back(id_node_pair.second->attributes().position.z());
+  }
+
+  const auto boundaries =
+      findFloorBoundaries(heights, bin_size_m, min_separation_m, max_valley_ratio);
+
+  std::vector<std::vector<NodeId>> partitions(boundaries.size() + 1);
+  size_t i = 0;
+  for (const auto& id_node_pair : places.nodes()) {
+    const auto floor =
+        std::upper_bound(boundaries.begin(), boundaries.end(), heights[i]);
+    partitions[floor - boundaries.begin()].push_back(id_node_pair.first);
+    ++i;
+  }
+
+  std::vector<std::vector<NodeId>> filtered;
+  for (auto& partition : partitions) {
+    if (!partition.empty() && partition.size() >= min_partition_size) {
+      filtered.push_back(std::move(partition));
+    }
+  }
+
+  return filtered;
+}
+
 }  // namespace hydra
@@ -0,0 +1,171 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include "hydra/utils/compact_graph.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "hydra/utils/disjoint_set.h"
+
+namespace hydra {
+
+void fillNodes(const SceneGraphLayer& layer, CompactGraph& graph) {
+  std::sort(graph.node_ids.begin(), graph.node_ids.end());
+
+  const size_t num_nodes = graph.node_ids.size();
+  graph.indices.reserve(num_nodes);
+  graph.positions.resize(3, num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    graph.indices.emplace(graph.node_ids[i], i);
+    graph.positions.col(i) = layer.getPosition(graph.node_ids[i]);
+  }
+}
+
+void fillAdjacency(CompactGraph& graph) {
+  const size_t num_nodes = graph.node_ids.size();
+  std::vector<size_t> degrees(num_nodes, 0);
+  for (const auto& edge : graph.edges) {
+    ++degrees[edge.source];
+    ++degrees[edge.target];
+  }
+
+  graph.offsets.resize(num_nodes + 1);
+  graph.offsets[0] = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    graph.offsets[i + 1] = graph.offsets[i] + degrees[i];
+  }
+
+  graph.neighbors.resize(graph.offsets.back());
+  graph.neighbor_weights.resize(graph.offsets.back());
+  std::vector<size_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+  for (const auto& edge : graph.edges) {
+    graph.neighbors[next[edge.source]] = edge.target;
+    graph.neighbor_weights[next[edge.source]++] = edge.weight;
+    graph.neighbors[next[edge.target]] = edge.source;
+    graph.neighbor_weights[next[edge.target]++] = edge.weight;
+  }
+}
+
+CompactGraph::CompactGraph(const SceneGraphLayer& layer) {
+  node_ids.reserve(layer.nodes().size());
+  for (const auto& id_node_pair : layer.nodes()) {
+    node_ids.push_back(id_node_pair.first);
+  }
+
+  fillNodes(layer, *this);
+
+  edges.reserve(layer.edges().size());
+  for (const auto& id_edge_pair : layer.edges()) {
+    const auto& edge = id_edge_pair.second;
+    const double weight = edge.info ? edge.info->weight : 1.0;
+    edges.push_back({indices.at(edge.source), indices.at(edge.target), weight});
+  }
+
+  fillAdjacency(*this);
+}
+
+CompactGraph::CompactGraph(const SceneGraphLayer& layer,
+                           const std::unordered_set<NodeId>& nodes) {
+  node_ids.reserve(nodes.size());
+  for (const auto node : nodes) {
+    if (layer.hasNode(node)) {
+      node_ids.push_back(node);
+    }
+  }
+
+  fillNodes(layer, *this);
+
+  // only the edges of the subset are visited, so the cost doesn't grow with the layer
+  for (size_t i = 0; i < node_ids.size(); ++i) {
+    const auto& node = layer.getNode(node_ids[i])->get();
+    for (const auto sibling : node.siblings()) {
+      auto iter = indices.find(sibling);
+      if (iter == indices.end() || iter->second <= i) {
+        continue;  // outside the subset or already added from the other end
+      }
+
+      const auto& edge = layer.getEdge(node_ids[i], sibling)->get();
+      const double weight = edge.info ? edge.info->weight : 1.0;
+      edges.push_back({i, iter->second, weight});
+    }
+  }
+
+  fillAdjacency(*this);
+}
+
+std::optional<size_t> CompactGraph::getIndex(NodeId node) const {
+  auto iter = indices.find(node);
+  if (iter == indices.end()) {
+    return std::nullopt;
+  }
+
+  return iter->second;
+}
+
+std::vector<NodeId> CompactGraph::getNodeIds(const std::vector<size_t>& indices) const {
+  std::vector<NodeId> ids;
+  ids.reserve(indices.size());
+  for (const auto index : indices) {
+    ids.push_back(node_ids.at(index));
+  }
+  return ids;
+}
+
+std::vector<std::vector<size_t>> getConnectedComponents(const CompactGraph& graph) {
+  DenseDisjointSet components(graph.numNodes());
+  for (const auto& edge : graph.edges) {
+    components.doUnion(edge.source, edge.target);
+  }
+
+  // number components by their smallest member to keep the output stable
+  std::vector<std::vector<size_t>> result;
+  result.reserve(components.numSets());
+  std::vector<size_t> root_to_component(graph.numNodes(), graph.numNodes());
+  for (size_t i = 0; i < graph.numNodes(); ++i) {
+    const auto root = components.findSet(i);
+    if (root_to_component[root] == graph.numNodes()) {
+      root_to_component[root] = result.size();
+      result.emplace_back();
+      result.back().reserve(components.sizes[root]);
+    }
+
+    result[root_to_component[root]].push_back(i);
+  }
+
+  return result;
+}
+
+}  // namespace hydra
@@ -36,6 +36,8 @@
 
 #include <glog/logging.h>
 
+#include <numeric>
+
 namespace hydra {
 
 DisjointSet::DisjointSet() {}
@@ -96,4 +98,40 @@ std::optional<NodeId> DisjointSet::doUnion(NodeId lhs, NodeId rhs, bool rhs_bett
   return rhs_set;
 }
 
+DenseDisjointSet::DenseDisjointSet(size_t num_elements)
+    : parents(num_elements), sizes(num_elements, 1), num_sets(num_elements) {
+  std::iota(parents.begin(), parents.end(), 0);
+}
+
+size_t DenseDisjointSet::findSet(size_t index) {
+  // path halving: point every other node on the path at its grandparent
+  while (parents[index] != index) {
+    parents[index] = parents[parents[index]];
+    index = parents[index];
+  }
+
+  return index;
+}
+
+std::optional<size_t> DenseDisjointSet::doUnion(size_t lhs, size_t rhs) {
+  size_t lhs_set = findSet(lhs);
+  size_t rhs_set = findSet(rhs);
+  if (lhs_set == rhs_set) {
+    return std::nullopt;
+  }
+
+  if (sizes[lhs_set] < sizes[rhs_set]) {
+    std::swap(lhs_set, rhs_set);
+  }
+
+  parents[rhs_set] = lhs_set;
+  sizes[lhs_set] += sizes[rhs_set];
+  --num_sets;
+  return rhs_set;
+}
+
+size_t DenseDisjointSet::setSize(size_t index) { return sizes[findSet(index)]; }
+
+size_t DenseDisjointSet::numSets() const { return num_sets; }
+
 }  // namespace hydra
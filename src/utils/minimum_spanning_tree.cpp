@@ -36,48 +36,56 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
+#include "hydra/utils/compact_graph.h"
 #include "hydra/utils/disjoint_set.h"
 
 namespace hydra {
 
 // implementation mainly from: https://en.wikipedia.org/wiki/Kruskal%27s_algorithm
 MinimumSpanningTreeInfo getMinimumSpanningEdges(const SceneGraphLayer& layer) {
+  const CompactGraph graph(layer);
+
+  // edges refer to node indices until they are added to the tree
   std::vector<MinimalEdge> sorted_edges;
-  sorted_edges.reserve(layer.edges().size());
-  for (const auto& id_edge_pair : layer.edges()) {
-    const auto& edge = id_edge_pair.second;
-    sorted_edges.emplace_back(
-        edge.source,
-        edge.target,
-        (layer.getPosition(edge.source) - layer.getPosition(edge.target)).norm());
+  sorted_edges.reserve(graph.numEdges());
+  for (const auto& edge : graph.edges) {
+    const double distance =
+        (graph.positions.col(edge.source) - graph.positions.col(edge.target)).norm();
+    sorted_edges.emplace_back(edge.source, edge.target, distance);
   }
-  std::make_heap(sorted_edges.begin(), sorted_edges.end(), std::greater<>{});
 
-  MinimumSpanningTreeInfo info;
-  info.edges.reserve(sorted_edges.size());
-  for (const auto& id_node_pair : layer.nodes()) {
-    info.counts[id_node_pair.first] = 0;
-  }
+  // equal-length edges are taken in layer edge order (the previous heap-based
+  // implementation broke ties arbitrarily)
+  std::stable_sort(sorted_edges.begin(),
+                   sorted_edges.end(),
+                   [](const MinimalEdge& lhs, const MinimalEdge& rhs) {
+                     return lhs.distance < rhs.distance;
+                   });
 
-  DisjointSet subtrees(layer);
-  while (!sorted_edges.empty()) {
-    std::pop_heap(sorted_edges.begin(), sorted_edges.end(), std::greater<>{});
-    auto min_edge = sorted_edges.back();
-    sorted_edges.pop_back();
+  MinimumSpanningTreeInfo info;
+  info.edges.reserve(graph.numNodes());
+  std::vector<size_t> counts(graph.numNodes(), 0);
 
-    NodeId lhs_set = subtrees.findSet(min_edge.source);
-    NodeId rhs_set = subtrees.findSet(min_edge.target);
-    if (lhs_set != rhs_set) {
-      subtrees.doUnion(lhs_set, rhs_set);
-      info.edges.push_back(min_edge);
-      info.counts[min_edge.source]++;
-      info.counts[min_edge.target]++;
+  DenseDisjointSet subtrees(graph.numNodes());
+  for (const auto& edge : sorted_edges) {
+    if (!subtrees.doUnion(edge.source, edge.target)) {
+      continue;
     }
+
+    info.edges.emplace_back(graph.node_ids[edge.source],
+                            graph.node_ids[edge.target],
+                            edge.distance);
+    counts[edge.source]++;
+    counts[edge.target]++;
   }
 
-  for (const auto& id_count_pair : info.counts) {
-    if (id_count_pair.second == 1) {
-      info.leaves.insert(id_count_pair.first);
+  info.counts.reserve(graph.numNodes());
+  for (size_t i = 0; i < graph.numNodes(); ++i) {
+    info.counts.emplace(graph.node_ids[i], counts[i]);
+    if (counts[i] == 1) {
+      info.leaves.insert(graph.node_ids[i]);
     }
   }
 
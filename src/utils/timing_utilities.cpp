@@ -91,15 +91,8 @@ void ElapsedTimeRecorder::stop(const std::string& timer_name) {
     if (!starts_.count(timer_name)) {
       no_start_present = true;
     } else {
-      if (!elapsed_.count(timer_name)) {
-        elapsed_[timer_name] = TimeList();
-        stamps_[timer_name] = TimeStamps();
-      }
-
       elapsed = stop_point - starts_.at(timer_name);
-      elapsed_[timer_name].push_back(elapsed);
       stamp = start_stamps_.at(timer_name);
-      stamps_[timer_name].push_back(stamp);
       starts_.erase(timer_name);
     }
   }  // end critical section
@@ -110,6 +103,17 @@ void ElapsedTimeRecorder::stop(const std::string& timer_name) {
     return;
   }
 
+  add(timer_name, stamp, elapsed);
+}
+
+void ElapsedTimeRecorder::add(const std::string& timer_name,
+                              const uint64_t& stamp,
+                              const std::chrono::nanoseconds& elapsed) {
+  // also guards the incremental log files, as several threads may share a name
+  std::unique_lock<std::mutex> lock(*mutex_);
+  elapsed_[timer_name].push_back(elapsed);
+  stamps_[timer_name].push_back(stamp);
+
   if (!log_incrementally_) {
     return;
   }
@@ -309,5 +313,36 @@ ScopedTimer::~ScopedTimer() {
   }
 }
 
+TimedLock::TimedLock(std::mutex& mutex, const std::string& name, uint64_t timestamp)
+    : lock_(mutex, std::defer_lock),
+      name_(name),
+      timestamp_(timestamp),
+      enabled_(!ElapsedTimeRecorder::instance().timing_disabled) {
+  if (!enabled_) {
+    lock_.lock();
+    return;
+  }
+
+  const auto wait_start = Clock::now();
+  lock_.lock();
+  acquired_ = Clock::now();
+  const auto waited = acquired_ - wait_start;
+  ElapsedTimeRecorder::instance().add(name_ + "_wait", timestamp_, waited);
+}
+
+TimedLock::~TimedLock() { unlock(); }
+
+void TimedLock::unlock() {
+  if (!lock_.owns_lock()) {
+    return;
+  }
+
+  lock_.unlock();
+  if (enabled_) {
+    const auto held = Clock::now() - acquired_;
+    ElapsedTimeRecorder::instance().add(name_ + "_hold", timestamp_, held);
+  }
+}
+
 }  // namespace timing
 }  // namespace hydra
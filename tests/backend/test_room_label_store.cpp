@@ -0,0 +1,207 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/backend/room_label_store.h>
+
+#include <thread>
+
+namespace hydra {
+
+namespace {
+
+inline void addPlaces(DynamicSceneGraph& graph, size_t num_places) {
+  for (size_t i = 0; i < num_places; ++i) {
+    auto attrs = std::make_unique<PlaceNodeAttributes>();
+    attrs->position << static_cast<double>(i), 0.0, 0.0;
+    graph.emplaceNode(DsgLayers::PLACES, NodeSymbol('p', i), std::move(attrs));
+  }
+}
+
+inline void addRoom(DynamicSceneGraph& graph,
+                    NodeId room,
+                    const std::set<size_t>& places,
+                    const std::string& name = "") {
+  auto attrs = std::make_unique<RoomNodeAttributes>();
+  attrs->name = name;
+  graph.emplaceNode(DsgLayers::ROOMS, room, std::move(attrs));
+  for (const auto place : places) {
+    graph.insertEdge(room, NodeSymbol('p', place));
+  }
+}
+
+inline void clearRooms(DynamicSceneGraph& graph) {
+  std::vector<NodeId> to_remove;
+  for (const auto& id_node_pair : graph.getLayer(DsgLayers::ROOMS).nodes()) {
+    to_remove.push_back(id_node_pair.first);
+  }
+
+  for (const auto node_id : to_remove) {
+    graph.removeNode(node_id);
+  }
+}
+
+inline std::string getName(const DynamicSceneGraph& graph, NodeId room) {
+  return graph.getNode(room)->get().attributes<SemanticNodeAttributes>().name;
+}
+
+}  // namespace
+
+TEST(RoomLabelStoreTests, LabelsSurviveRoomRewrite) {
+  DynamicSceneGraph graph;
+  addPlaces(graph, 8);
+  addRoom(graph, NodeSymbol('R', 0), {0, 1, 2});
+  addRoom(graph, NodeSymbol('R', 1), {3, 4, 5});
+
+  RoomLabelStore store(0.5);
+  // empty footprints are resolved from the current graph
+  store.submit(NodeSymbol('R', 0), "kitchen", {});
+  EXPECT_TRUE(store.hasPending());
+  EXPECT_EQ(store.apply(graph), 1u);
+  EXPECT_FALSE(store.hasPending());
+  EXPECT_EQ(store.numLabels(), 1u);
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 0)), "kitchen");
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 1)), "");
+
+  // re-detected rooms have new ids, but the label follows the places
+  clearRooms(graph);
+  addRoom(graph, NodeSymbol('R', 5), {3, 4, 5});
+  addRoom(graph, NodeSymbol('R', 6), {0, 1, 2, 6, 7});
+  EXPECT_EQ(store.apply(graph), 1u);
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 5)), "");
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 6)), "kitchen");
+
+  // the stored footprint tracks the room as it changes
+  const auto labels = store.labels();
+  ASSERT_EQ(labels.size(), 1u);
+  EXPECT_EQ(labels[0].footprint.size(), 5u);
+
+  // rooms without enough overlap are not labeled
+  clearRooms(graph);
+  addRoom(graph, NodeSymbol('R', 7), {0, 3, 4, 5});
+  addRoom(graph, NodeSymbol('R', 8), {1, 2});
+  EXPECT_EQ(store.apply(graph), 0u);
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 7)), "");
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 8)), "");
+}
+
+TEST(RoomLabelStoreTests, NewLabelsReplaceOverlapping) {
+  DynamicSceneGraph graph;
+  addPlaces(graph, 6);
+  addRoom(graph, NodeSymbol('R', 0), {0, 1, 2});
+  addRoom(graph, NodeSymbol('R', 1), {3, 4, 5});
+
+  RoomLabelStore store(0.5);
+  store.submit(NodeSymbol('R', 0), "kitchen", {NodeSymbol('p', 0), NodeSymbol('p', 1)});
+  store.submit(NodeSymbol('R', 1), "office", {NodeSymbol('p', 4), NodeSymbol('p', 5)});
+  EXPECT_EQ(store.apply(graph), 2u);
+  EXPECT_EQ(store.numLabels(), 2u);
+
+  store.submit(NodeSymbol('R', 0), "dining room", {});
+  // unknown rooms without a footprint are dropped
+  store.submit(NodeSymbol('R', 9), "closet", {});
+  EXPECT_EQ(store.apply(graph), 2u);
+  EXPECT_EQ(store.numLabels(), 2u);
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 0)), "dining room");
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 1)), "office");
+}
+
+TEST(RoomLabelStoreTests, TiesAssignedDeterministically) {
+  DynamicSceneGraph graph;
+  addPlaces(graph, 4);
+  addRoom(graph, NodeSymbol('R', 1), {0, 1});
+  addRoom(graph, NodeSymbol('R', 0), {2, 3});
+
+  // equal overlap with both rooms: the lowest room id gets the label
+  RoomLabelStore store(0.5);
+  store.submit(NodeSymbol('R', 0),
+               "kitchen",
+               {NodeSymbol('p', 0), NodeSymbol('p', 1), NodeSymbol('p', 2),
+                NodeSymbol('p', 3)});
+  EXPECT_EQ(store.apply(graph), 1u);
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 0)), "kitchen");
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 1)), "");
+
+  // equal overlap with one room: the oldest label wins
+  DynamicSceneGraph other;
+  addPlaces(other, 4);
+  addRoom(other, NodeSymbol('R', 0), {0, 1, 2, 3});
+  RoomLabelStore other_store(0.5);
+  other_store.submit(
+      NodeSymbol('R', 0), "office", {NodeSymbol('p', 2), NodeSymbol('p', 3)});
+  other_store.submit(
+      NodeSymbol('R', 0), "hallway", {NodeSymbol('p', 0), NodeSymbol('p', 1)});
+  EXPECT_EQ(other_store.apply(other), 1u);
+  EXPECT_EQ(getName(other, NodeSymbol('R', 0)), "office");
+}
+
+TEST(RoomLabelStoreTests, AsyncReceiverUpdates) {
+  DynamicSceneGraph graph;
+  addPlaces(graph, 6);
+  addRoom(graph, NodeSymbol('R', 0), {0, 1, 2});
+  addRoom(graph, NodeSymbol('R', 1), {3, 4, 5});
+
+  RoomLabelStore store(0.5);
+  // stand-in for the zmq receiver: labeled copies of the graph arriving in the
+  // background while the backend keeps re-detecting rooms
+  const size_t num_messages = 50;
+  std::thread receiver([&store, num_messages]() {
+    for (size_t i = 0; i < num_messages; ++i) {
+      DynamicSceneGraph received;
+      addPlaces(received, 6);
+      addRoom(received, NodeSymbol('R', 0), {0, 1, 2}, "kitchen");
+      addRoom(received, NodeSymbol('R', 1), {3, 4, 5}, i % 2 ? "office" : "study");
+      addRoom(received, NodeSymbol('R', 2), {}, "");
+      EXPECT_EQ(store.submit(received), 2u);
+    }
+  });
+
+  for (size_t i = 0; i < num_messages; ++i) {
+    clearRooms(graph);
+    addRoom(graph, NodeSymbol('R', 10 + 2 * i), {0, 1, 2});
+    addRoom(graph, NodeSymbol('R', 11 + 2 * i), {3, 4, 5});
+    store.apply(graph);
+  }
+
+  receiver.join();
+  clearRooms(graph);
+  addRoom(graph, NodeSymbol('R', 200), {0, 1, 2});
+  addRoom(graph, NodeSymbol('R', 201), {3, 4, 5});
+  EXPECT_EQ(store.apply(graph), 2u);
+  EXPECT_EQ(store.numLabels(), 2u);
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 200)), "kitchen");
+  EXPECT_EQ(getName(graph, NodeSymbol('R', 201)), "office");
+}
+
+}  // namespace hydra
@@ -0,0 +1,108 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/common/dsg_change_set.h>
+
+namespace hydra {
+
+namespace {
+
+inline NodeAttributes::Ptr makePlace(double x) {
+  auto attrs = std::make_unique<PlaceNodeAttributes>();
+  attrs->position << x, 0.0, 0.0;
+  return attrs;
+}
+
+}  // namespace
+
+TEST(DsgChangeSetTests, EmptyChangeSet) {
+  DynamicSceneGraph graph;
+  graph.emplaceNode(DsgLayers::PLACES, NodeSymbol('p', 0), makePlace(0.0));
+
+  DsgChangeSet changes;
+  EXPECT_TRUE(changes.empty());
+  EXPECT_EQ(changes.apply(graph), 0u);
+  EXPECT_EQ(graph.numNodes(), 1u);
+}
+
+TEST(DsgChangeSetTests, ApplyInOrder) {
+  DynamicSceneGraph graph;
+  graph.emplaceNode(DsgLayers::PLACES, NodeSymbol('p', 0), makePlace(0.0));
+  graph.emplaceNode(DsgLayers::PLACES, NodeSymbol('p', 1), makePlace(1.0));
+  graph.emplaceNode(DsgLayers::PLACES, NodeSymbol('p', 2), makePlace(2.0));
+  graph.emplaceNode(
+      DsgLayers::OBJECTS, NodeSymbol('O', 0), std::make_unique<ObjectNodeAttributes>());
+  graph.insertEdge(NodeSymbol('p', 0), NodeSymbol('p', 1));
+  graph.insertEdge(NodeSymbol('p', 1), NodeSymbol('p', 2));
+  graph.insertEdge(NodeSymbol('p', 2), NodeSymbol('O', 0));
+
+  DsgChangeSet changes;
+  changes.node_removals.push_back(NodeSymbol('p', 2));
+  changes.node_removals.push_back(NodeSymbol('p', 5));
+  changes.edge_removals.emplace_back(NodeSymbol('p', 0), NodeSymbol('p', 1));
+  changes.node_upserts.push_back({DsgLayers::PLACES, NodeSymbol('p', 3), makePlace(3)});
+  changes.node_upserts.push_back({DsgLayers::PLACES, NodeSymbol('p', 0), makePlace(5)});
+  changes.edge_upserts.push_back(
+      {NodeSymbol('p', 1), NodeSymbol('p', 3), std::make_unique<EdgeAttributes>(2.0)});
+  changes.edge_inserts.emplace_back(NodeSymbol('p', 3), NodeSymbol('O', 0));
+  changes.patches.emplace_back(NodeSymbol('p', 1),
+                               [](NodeAttributes& attrs) { attrs.is_active = true; });
+  // patches are skipped for removed nodes
+  changes.patches.emplace_back(NodeSymbol('p', 2),
+                               [](NodeAttributes& attrs) { attrs.is_active = true; });
+  EXPECT_EQ(changes.size(), 9u);
+
+  std::set<NodeId> removed_children;
+  const auto num_applied = changes.apply(graph, [&](const SceneGraphNode& node) {
+    removed_children.insert(node.children().begin(), node.children().end());
+  });
+  EXPECT_EQ(num_applied, 7u);
+
+  const std::set<NodeId> expected_children{NodeSymbol('O', 0)};
+  EXPECT_EQ(removed_children, expected_children);
+
+  EXPECT_FALSE(graph.hasNode(NodeSymbol('p', 2)));
+  EXPECT_TRUE(graph.hasNode(NodeSymbol('p', 3)));
+  EXPECT_FALSE(graph.hasEdge(NodeSymbol('p', 0), NodeSymbol('p', 1)));
+  EXPECT_TRUE(graph.hasEdge(NodeSymbol('p', 1), NodeSymbol('p', 3)));
+  EXPECT_TRUE(graph.hasEdge(NodeSymbol('p', 3), NodeSymbol('O', 0)));
+  const auto edge = graph.getEdge(NodeSymbol('p', 1), NodeSymbol('p', 3));
+  ASSERT_TRUE(edge);
+  EXPECT_NEAR(edge->get().info->weight, 2.0, 1.0e-9);
+  EXPECT_NEAR(graph.getPosition(NodeSymbol('p', 0)).x(), 5.0, 1.0e-9);
+  EXPECT_TRUE(graph.getNode(NodeSymbol('p', 1))->get().attributes().is_active);
+}
+
+}  // namespace hydra
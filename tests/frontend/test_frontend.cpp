@@ -120,6 +120,16 @@ void addPlaceNode(IsolatedSceneGraphLayer& graph,
   graph.emplaceNode(NodeSymbol('p', index), std::move(attrs));
 }
 
+pose_graph_tools::BowQuery::ConstPtr makeBowQuery(size_t pose_id,
+                                                 const std::vector<uint32_t>& ids) {
+  pose_graph_tools::BowQuery::Ptr msg(new pose_graph_tools::BowQuery());
+  msg->robot_id = 0;
+  msg->pose_id = pose_id;
+  msg->bow_vector.word_ids = ids;
+  msg->bow_vector.word_values.resize(ids.size(), 0.5f);
+  return msg;
+}
+
 }  // namespace
 
 TEST(FrontendModuleTests, TestAgentEdges) {
@@ -165,4 +175,103 @@ TEST(FrontendModuleTests, TestAgentEdges) {
   }
 }
 
+TEST(FrontendModuleTests, TestBowAssignment) {
+  auto prefix = RobotPrefixConfig(0);
+  auto config = getDefaultConfig();
+  config.lcd_use_bow_vectors = true;
+  config.bow_expiry_s = 1.0;
+  auto dsg = makeSharedDsg();
+  auto state = std::make_shared<SharedModuleState>();
+  auto frontend = std::make_shared<FrontendModule>(prefix, config, dsg, state);
+  auto queue = frontend->getQueue();
+
+  IsolatedSceneGraphLayer places(2);
+
+  // bow vectors can arrive before their poses
+  state->visual_lcd_queue.push(makeBowQuery(0, {1, 2, 3}));
+  state->visual_lcd_queue.push(makeBowQuery(1, {4, 5}));
+
+  auto msg = getMsg();
+  addPlaces(*msg, places);
+  addPoseGraph(*msg, 10, 0, Eigen::Vector3d(1.0, 2.0, 3.0));
+  queue->push(msg);
+  ASSERT_TRUE(frontend->spinOnce());
+
+  {
+    const auto& agents = dsg->graph->getLayer(DsgLayers::AGENTS, prefix.key);
+    ASSERT_EQ(agents.numNodes(), 1u);
+    const DynamicSceneGraphNode& agent = agents.getNodeByIndex(0).value();
+    const auto& attrs = agent.attributes<AgentNodeAttributes>();
+    EXPECT_EQ(attrs.dbow_ids.size(), 3);
+    EXPECT_EQ(attrs.dbow_values.size(), 3);
+  }
+
+  // the bow vector for pose 1 expires before the pose arrives
+  msg = getMsg();
+  msg->timestamp_ns = 2000000000;
+  addPlaces(*msg, places);
+  queue->push(msg);
+  ASSERT_TRUE(frontend->spinOnce());
+
+  msg = getMsg();
+  msg->timestamp_ns = 2000000010;
+  addPlaces(*msg, places);
+  addPoseGraph(*msg, 2000000010, 1, Eigen::Vector3d(1.0, 2.0, 3.0));
+  queue->push(msg);
+  ASSERT_TRUE(frontend->spinOnce());
+
+  {
+    const auto& agents = dsg->graph->getLayer(DsgLayers::AGENTS, prefix.key);
+    ASSERT_EQ(agents.numNodes(), 2u);
+    const DynamicSceneGraphNode& agent = agents.getNodeByIndex(1).value();
+    EXPECT_EQ(agent.attributes<AgentNodeAttributes>().dbow_ids.size(), 0);
+  }
+
+  // bow vectors arriving after their pose are assigned immediately
+  state->visual_lcd_queue.push(makeBowQuery(1, {6, 7}));
+  msg = getMsg();
+  msg->timestamp_ns = 2000000020;
+  addPlaces(*msg, places);
+  queue->push(msg);
+  ASSERT_TRUE(frontend->spinOnce());
+
+  {
+    const auto& agents = dsg->graph->getLayer(DsgLayers::AGENTS, prefix.key);
+    const DynamicSceneGraphNode& agent = agents.getNodeByIndex(1).value();
+    EXPECT_EQ(agent.attributes<AgentNodeAttributes>().dbow_ids.size(), 2);
+  }
+}
+
+TEST(FrontendModuleTests, TestRepeatedTimestampKeepsKeys) {
+  auto prefix = RobotPrefixConfig(0);
+  auto config = getDefaultConfig();
+  auto dsg = makeSharedDsg();
+  auto state = std::make_shared<SharedModuleState>();
+  auto frontend = std::make_shared<FrontendModule>(prefix, config, dsg, state);
+  auto queue = frontend->getQueue();
+
+  IsolatedSceneGraphLayer places(2);
+
+  // key 1 is first sent with the timestamp of key 0 (and rejected) before being
+  // resent with a valid timestamp in the same update
+  auto msg = getMsg();
+  addPlaces(*msg, places);
+  addPoseGraph(*msg, 10, 0, Eigen::Vector3d(1.0, 2.0, 3.0));
+  addPoseGraph(*msg, 10, 1, Eigen::Vector3d(2.0, 2.0, 3.0));
+  addPoseGraph(*msg, 20, 1, Eigen::Vector3d(2.0, 2.0, 3.0));
+  addPoseGraph(*msg, 30, 2, Eigen::Vector3d(3.0, 2.0, 3.0));
+  queue->push(msg);
+  ASSERT_TRUE(frontend->spinOnce());
+
+  const auto& agents = dsg->graph->getLayer(DsgLayers::AGENTS, prefix.key);
+  ASSERT_EQ(agents.numNodes(), 3u);
+  for (size_t i = 0; i < agents.numNodes(); ++i) {
+    const DynamicSceneGraphNode& agent = agents.getNodeByIndex(i).value();
+    const auto& attrs = agent.attributes<AgentNodeAttributes>();
+    const NodeId expected_key = NodeSymbol(prefix.key, i);
+    EXPECT_EQ(attrs.external_key, expected_key) << "index " << i;
+    EXPECT_EQ(attrs.position.x(), static_cast<double>(i + 1)) << "index " << i;
+  }
+}
+
 }  // namespace hydra
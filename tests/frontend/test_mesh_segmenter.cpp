@@ -0,0 +1,163 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/frontend/mesh_segmenter.h>
+
+namespace hydra {
+
+namespace {
+
+inline MeshSegmenter::MeshVertexCloud::Ptr makeCubeVertices() {
+  MeshSegmenter::MeshVertexCloud::Ptr cloud(new MeshSegmenter::MeshVertexCloud());
+  for (const float x : {-0.5f, 0.5f}) {
+    for (const float y : {-0.5f, 0.5f}) {
+      for (const float z : {-0.5f, 0.5f}) {
+        pcl::PointXYZRGBA point;
+        point.x = x;
+        point.y = y;
+        point.z = z;
+        cloud->push_back(point);
+      }
+    }
+  }
+
+  return cloud;
+}
+
+inline MeshSegmenter::LabelClusters makeClusters(
+    const MeshSegmenter::MeshVertexCloud::Ptr& vertices, uint8_t label) {
+  Cluster cluster;
+  cluster.cloud.reset(new MeshSegmenter::MeshVertexCloud(*vertices));
+  for (size_t i = 0; i < vertices->size(); ++i) {
+    const auto& point = vertices->at(i);
+    cluster.indices.indices.push_back(i);
+    cluster.centroid.add(pcl::PointXYZ(point.x, point.y, point.z));
+  }
+
+  return {{label, {cluster}}};
+}
+
+inline uint64_t toNs(double time_s) { return static_cast<uint64_t>(time_s * 1e9); }
+
+inline bool isActive(const DynamicSceneGraph& graph, NodeId node) {
+  return graph.getNode(node)->get().attributes().is_active;
+}
+
+}  // namespace
+
+struct MeshSegmenterExpiryFixture : public ::testing::Test {
+  MeshSegmenterExpiryFixture() : vertices(makeCubeVertices()) {
+    config.active_horizon_s = 1.0;
+    config.labels = {label};
+    clusters = makeClusters(vertices, label);
+  }
+
+  const uint8_t label = 1;
+  MeshSegmenterConfig config;
+  MeshSegmenter::MeshVertexCloud::Ptr vertices;
+  MeshSegmenter::LabelClusters clusters;
+  DynamicSceneGraph graph;
+};
+
+TEST_F(MeshSegmenterExpiryFixture, ArchivedAfterHorizon) {
+  MeshSegmenter segmenter(config, vertices);
+  const NodeId object = NodeSymbol('O', 0);
+
+  auto archived = segmenter.updateGraph(graph, clusters, toNs(0.0));
+  EXPECT_TRUE(archived.empty());
+  ASSERT_TRUE(graph.hasNode(object));
+  EXPECT_TRUE(isActive(graph, object));
+
+  // exactly at the horizon the object is still active
+  archived = segmenter.updateGraph(graph, {}, toNs(1.0));
+  EXPECT_TRUE(archived.empty());
+  EXPECT_TRUE(isActive(graph, object));
+
+  archived = segmenter.updateGraph(graph, {}, toNs(1.5));
+  EXPECT_EQ(archived, std::set<NodeId>({object}));
+  EXPECT_FALSE(isActive(graph, object));
+
+  // archived objects are not reported again
+  archived = segmenter.updateGraph(graph, {}, toNs(5.0));
+  EXPECT_TRUE(archived.empty());
+}
+
+TEST_F(MeshSegmenterExpiryFixture, SeenAgainNotArchivedAtOldDeadline) {
+  MeshSegmenter segmenter(config, vertices);
+  const NodeId object = NodeSymbol('O', 0);
+
+  auto archived = segmenter.updateGraph(graph, clusters, toNs(0.0));
+  EXPECT_TRUE(archived.empty());
+
+  // re-detecting the object updates the existing node instead of adding one
+  archived = segmenter.updateGraph(graph, clusters, toNs(0.9));
+  EXPECT_TRUE(archived.empty());
+  EXPECT_EQ(graph.getLayer(DsgLayers::OBJECTS).numNodes(), 1u);
+
+  // past the deadline of the first sighting, but not of the latest
+  archived = segmenter.updateGraph(graph, {}, toNs(1.5));
+  EXPECT_TRUE(archived.empty());
+  EXPECT_TRUE(isActive(graph, object));
+
+  archived = segmenter.updateGraph(graph, {}, toNs(2.0));
+  EXPECT_EQ(archived, std::set<NodeId>({object}));
+  EXPECT_FALSE(isActive(graph, object));
+}
+
+TEST_F(MeshSegmenterExpiryFixture, RemovedObjectDroppedWithoutArchiving) {
+  MeshSegmenter segmenter(config, vertices);
+  const NodeId removed = NodeSymbol('O', 0);
+  const NodeId replacement = NodeSymbol('O', 1);
+
+  auto archived = segmenter.updateGraph(graph, clusters, toNs(0.0));
+  EXPECT_TRUE(archived.empty());
+  ASSERT_TRUE(graph.removeNode(removed));
+
+  archived = segmenter.updateGraph(graph, {}, toNs(2.0));
+  EXPECT_TRUE(archived.empty());
+
+  // the removed object is no longer active, so the same cluster is a new object
+  archived = segmenter.updateGraph(graph, clusters, toNs(2.0));
+  EXPECT_TRUE(archived.empty());
+  ASSERT_TRUE(graph.hasNode(replacement));
+
+  // only the new object remains queued for expiry
+  archived = segmenter.updateGraph(graph, {}, toNs(3.5));
+  EXPECT_EQ(archived, std::set<NodeId>({replacement}));
+  EXPECT_FALSE(graph.hasNode(removed));
+  EXPECT_FALSE(isActive(graph, replacement));
+}
+
+}  // namespace hydra
@@ -0,0 +1,110 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/frontend/place_connectivity.h>
+
+namespace hydra {
+
+using Components = std::vector<std::vector<NodeId>>;
+
+TEST(PlaceConnectivityTests, TestNewNodes) {
+  PlaceConnectivity graph;
+  for (NodeId i = 0; i < 5; ++i) {
+    EXPECT_TRUE(graph.addNode(i));
+  }
+  EXPECT_FALSE(graph.addNode(0));
+
+  EXPECT_TRUE(graph.addEdge(0, 1));
+  EXPECT_TRUE(graph.addEdge(1, 2));
+  EXPECT_TRUE(graph.addEdge(3, 4));
+  EXPECT_FALSE(graph.addEdge(1, 0));
+  EXPECT_FALSE(graph.addEdge(1, 7));
+  EXPECT_EQ(3u, graph.numEdges());
+
+  const Components expected{{3, 4}};
+  EXPECT_EQ(expected, graph.popSmallComponents(3));
+  EXPECT_EQ(0u, graph.numChanged());
+
+  // nothing changed since the last check
+  EXPECT_TRUE(graph.popSmallComponents(3).empty());
+}
+
+TEST(PlaceConnectivityTests, TestEdgeRemoval) {
+  PlaceConnectivity graph;
+  for (NodeId i = 0; i < 6; ++i) {
+    graph.addNode(i);
+    if (i > 0) {
+      graph.addEdge(i - 1, i);
+    }
+  }
+
+  EXPECT_TRUE(graph.popSmallComponents(3).empty());
+
+  // splitting the chain leaves one side too small
+  EXPECT_TRUE(graph.removeEdge(2, 1));
+  EXPECT_FALSE(graph.removeEdge(1, 2));
+  EXPECT_EQ(4u, graph.numEdges());
+  Components expected{{0, 1}};
+  EXPECT_EQ(expected, graph.popSmallComponents(3));
+
+  // checks only touch components around the change
+  EXPECT_TRUE(graph.removeEdge(4, 5));
+  expected = {{5}};
+  EXPECT_EQ(expected, graph.popSmallComponents(2));
+}
+
+TEST(PlaceConnectivityTests, TestNodeRemoval) {
+  PlaceConnectivity graph;
+  for (NodeId i = 0; i < 5; ++i) {
+    graph.addNode(i);
+  }
+
+  graph.addEdge(0, 1);
+  graph.addEdge(1, 2);
+  graph.addEdge(2, 3);
+  graph.addEdge(3, 4);
+  graph.addEdge(1, 3);
+  EXPECT_TRUE(graph.popSmallComponents(2).empty());
+
+  EXPECT_TRUE(graph.removeNode(1));
+  EXPECT_FALSE(graph.hasNode(1));
+  EXPECT_FALSE(graph.hasEdge(0, 1));
+  EXPECT_EQ(2u, graph.numEdges());
+
+  const Components expected{{0}};
+  EXPECT_EQ(expected, graph.popSmallComponents(2));
+}
+
+}  // namespace hydra
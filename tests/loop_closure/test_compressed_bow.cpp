@@ -0,0 +1,135 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/loop_closure/compressed_bow.h>
+#include <hydra/loop_closure/descriptor_matching.h>
+
+namespace hydra {
+namespace lcd {
+
+namespace {
+
+inline Descriptor makeBowDescriptor(const std::vector<uint32_t>& words,
+                                    const std::vector<float>& values) {
+  Descriptor descriptor;
+  descriptor.normalized = true;
+  descriptor.words.resize(words.size());
+  descriptor.values.resize(values.size());
+  for (size_t i = 0; i < words.size(); ++i) {
+    descriptor.words(i) = words[i];
+    descriptor.values(i) = values[i];
+  }
+
+  // bow vectors are l1-normalized
+  descriptor.values /= descriptor.values.lpNorm<1>();
+  return descriptor;
+}
+
+}  // namespace
+
+TEST(CompressedBowTests, TestRoundTrip) {
+  CompressedBow::WordVector words(5);
+  words << 3, 1, 200, 70000, 4000000000u;
+  Eigen::VectorXf values(5);
+  values << 0.2f, 0.1f, 0.4f, 0.25f, 0.05f;
+
+  CompressedBow bow(words, values);
+  EXPECT_EQ(bow.size(), 5u);
+  // large word ids take more bytes, but small gaps only take one
+  EXPECT_LT(bow.memoryUsage(), 5 * (sizeof(uint32_t) + sizeof(float)));
+
+  CompressedBow::WordVector decoded_words;
+  Eigen::VectorXf decoded_values;
+  bow.decode(decoded_words, decoded_values);
+
+  // entries are sorted by word id
+  CompressedBow::WordVector expected_words(5);
+  expected_words << 1, 3, 200, 70000, 4000000000u;
+  Eigen::VectorXf expected_values(5);
+  expected_values << 0.1f, 0.2f, 0.4f, 0.25f, 0.05f;
+  EXPECT_EQ(decoded_words, expected_words);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NEAR(decoded_values(i), expected_values(i), 0.4f / 255.0f);
+  }
+}
+
+TEST(CompressedBowTests, TestZeroWeightsDropped) {
+  CompressedBow::WordVector words(3);
+  words << 1, 2, 3;
+  Eigen::VectorXf values(3);
+  values << 1.0f, 0.0f, -1.0f;
+
+  CompressedBow bow(words, values);
+  EXPECT_EQ(bow.size(), 1u);
+
+  CompressedBow empty(words, Eigen::VectorXf::Zero(3));
+  EXPECT_TRUE(empty.empty());
+}
+
+TEST(CompressedBowTests, TestScoresMatchUncompressed) {
+  const auto d1 = makeBowDescriptor({1, 2, 5, 9, 40, 1000, 1002},
+                                    {0.3f, 0.1f, 0.2f, 0.5f, 0.05f, 0.7f, 0.15f});
+  const auto d2 = makeBowDescriptor({2, 3, 5, 9, 41, 1000, 5000},
+                                    {0.2f, 0.4f, 0.2f, 0.3f, 0.1f, 0.6f, 0.25f});
+
+  const CompressedBow b1(d1.words, d1.values);
+  const CompressedBow b2(d2.words, d2.values);
+
+  const float l1_expected = computeDescriptorScore(d1, d2, DescriptorScoreType::L1);
+  EXPECT_NEAR(computeCompressedBowL1Score(b1, b2), l1_expected, 1.0e-2f);
+  EXPECT_NEAR(computeCompressedBowL1Score(b1, b1), 1.0f, 1.0e-6f);
+  EXPECT_NEAR(computeCompressedBowL1Score(b1, CompressedBow()), 0.0f, 1.0e-6f);
+
+  const float cos_expected =
+      computeDescriptorScore(d1, d2, DescriptorScoreType::COSINE);
+  Descriptor c1;
+  c1.bow = b1;
+  Descriptor c2;
+  c2.bow = b2;
+  EXPECT_NEAR(computeDescriptorScore(c1, c2, DescriptorScoreType::COSINE),
+              cos_expected,
+              1.0e-2f);
+  EXPECT_NEAR(
+      computeDescriptorScore(c1, c2, DescriptorScoreType::L1), l1_expected, 1.0e-2f);
+
+  // mixing compressed and uncompressed descriptors compresses on the fly
+  EXPECT_NEAR(
+      computeDescriptorScore(c1, d2, DescriptorScoreType::L1), l1_expected, 1.0e-2f);
+  EXPECT_NEAR(
+      computeDescriptorScore(d1, c2, DescriptorScoreType::L1), l1_expected, 1.0e-2f);
+}
+
+}  // namespace lcd
+}  // namespace hydra
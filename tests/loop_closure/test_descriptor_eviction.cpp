@@ -0,0 +1,127 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/loop_closure/descriptor_eviction.h>
+
+namespace hydra {
+namespace lcd {
+
+using namespace std::chrono_literals;
+
+Descriptor::Ptr makeEvictionDescriptor(const Eigen::Vector3d& pos,
+                                       const Eigen::Vector2f& values,
+                                       std::chrono::nanoseconds stamp) {
+  auto descriptor = std::make_unique<Descriptor>();
+  descriptor->values = values;
+  descriptor->normalized = false;
+  descriptor->root_position = pos;
+  descriptor->timestamp = stamp;
+  return descriptor;
+}
+
+TEST(DescriptorEvictionTests, TestUnderCapacity) {
+  DescriptorCache cache;
+  cache[1] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 1ns);
+  cache[2] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 2ns);
+
+  DescriptorEvictionConfig config;
+  EXPECT_TRUE(
+      selectDescriptorsToEvict(cache, 2, config, DescriptorScoreType::COSINE).empty());
+}
+
+TEST(DescriptorEvictionTests, TestAgePolicy) {
+  DescriptorCache cache;
+  cache[1] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 3ns);
+  cache[2] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 1ns);
+  cache[3] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 2ns);
+  cache[4] = nullptr;
+
+  DescriptorEvictionConfig config;
+  config.prune_redundant = false;
+  config.policy = DescriptorEvictionPolicy::AGE;
+  const auto result =
+      selectDescriptorsToEvict(cache, 2, config, DescriptorScoreType::COSINE);
+  // missing descriptors are always evicted first
+  std::vector<NodeId> expected{4, 2};
+  EXPECT_EQ(result, expected);
+}
+
+TEST(DescriptorEvictionTests, TestLeastMatchedPolicy) {
+  DescriptorCache cache;
+  cache[1] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 1ns);
+  cache[2] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 2ns);
+  cache[3] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 3ns);
+
+  DescriptorEvictionConfig config;
+  config.prune_redundant = false;
+  config.policy = DescriptorEvictionPolicy::LEAST_MATCHED;
+  std::map<NodeId, size_t> match_counts{{1, 5}, {3, 1}};
+  const auto result = selectDescriptorsToEvict(
+      cache, 1, config, DescriptorScoreType::COSINE, match_counts);
+  std::vector<NodeId> expected{2, 3};
+  EXPECT_EQ(result, expected);
+}
+
+TEST(DescriptorEvictionTests, TestRedundancyPruning) {
+  DescriptorCache cache;
+  // 1 and 2 are close and similar, 3 is close but different, 4 is similar but far
+  cache[1] = makeEvictionDescriptor(Eigen::Vector3d::Zero(), {1.0f, 0.0f}, 4ns);
+  cache[2] = makeEvictionDescriptor(Eigen::Vector3d(0.5, 0.0, 0.0), {1.0f, 0.0f}, 3ns);
+  cache[3] = makeEvictionDescriptor(Eigen::Vector3d(0.0, 0.5, 0.0), {0.0f, 1.0f}, 1ns);
+  cache[4] = makeEvictionDescriptor(Eigen::Vector3d(10.0, 0.0, 0.0), {1.0f, 0.0f}, 2ns);
+
+  DescriptorEvictionConfig config;
+  config.prune_redundant = true;
+  config.redundancy_radius_m = 1.0;
+  config.redundancy_min_score = 0.9f;
+  config.policy = DescriptorEvictionPolicy::AGE;
+
+  {  // test case 1: only the redundant descriptor gets evicted
+    const auto result =
+        selectDescriptorsToEvict(cache, 3, config, DescriptorScoreType::COSINE);
+    std::vector<NodeId> expected{2};
+    EXPECT_EQ(result, expected);
+  }
+
+  {  // test case 2: remaining evictions are by age
+    const auto result =
+        selectDescriptorsToEvict(cache, 2, config, DescriptorScoreType::COSINE);
+    std::vector<NodeId> expected{2, 3};
+    EXPECT_EQ(result, expected);
+  }
+}
+
+}  // namespace lcd
+}  // namespace hydra
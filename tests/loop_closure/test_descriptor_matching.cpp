@@ -342,6 +342,183 @@ TEST(LoopClosureModuleMatchingTests, SearchDescriptorsValidSomeMatches) {
   EXPECT_EQ(0u, results.query_root);
 }
 
+TEST(LoopClosureModuleMatchingTests, TestDescriptorSketch) {
+  Descriptor::Ptr d1 = makeDescriptor(1.0f, 0.0f, 2.0f, 0.5f, 0.0f, 3.0f);
+  Descriptor::Ptr d2 = makeDescriptor(1.0f, 0.0f, 2.0f, 0.5f, 0.0f, 3.0f);
+  Descriptor::Ptr d3 = makeDescriptor(-1.0f, 0.0f, -2.0f, -0.5f, 0.0f, -3.0f);
+
+  computeDescriptorSketch(*d1, 100);
+  computeDescriptorSketch(*d2, 100);
+  computeDescriptorSketch(*d3, 100);
+  ASSERT_EQ(d1->sketch.size(), 2u);
+
+  // identical descriptors share a sketch, opposite descriptors differ everywhere
+  EXPECT_EQ(computeSketchDistance(*d1, *d2), 0u);
+  EXPECT_EQ(computeSketchDistance(*d1, *d3), 100u);
+
+  // no sketches for bag-of-words or disabled sketches
+  d1->words.resize(6, 1);
+  computeDescriptorSketch(*d1, 100);
+  EXPECT_TRUE(d1->sketch.empty());
+  computeDescriptorSketch(*d2, 0);
+  EXPECT_TRUE(d2->sketch.empty());
+}
+
+TEST(LoopClosureModuleMatchingTests, SearchDescriptorsSketchPruning) {
+  Descriptor::Ptr query = makeDescriptor(1.0f, 0.0f, 2.0f, 0.5f);
+  fillDescriptor(*query, 0, {13});
+
+  DescriptorMatchConfig config;
+  config.min_score = 0.7f;
+  config.min_registration_score = 0.7f;
+  config.max_registration_matches = 5;
+  config.min_match_separation_m = 0.0;
+  config.type = DescriptorScoreType::COSINE;
+  config.sketch_bits = 64;
+  config.max_sketch_distance = 0.25;
+  computeDescriptorSketch(*query, config.sketch_bits);
+
+  std::set<NodeId> valid_matches{1, 2, 3};
+  DescriptorCache descriptors;
+  descriptors[1] = makeDescriptor(1.0f, 0.0f, 2.0f, 0.5f);
+  fillDescriptor(*descriptors[1], 1, {4});
+  descriptors[2] = makeDescriptor(-1.0f, 0.0f, -2.0f, -0.5f);
+  fillDescriptor(*descriptors[2], 2, {5});
+  descriptors[3] = makeDescriptor(1.1f, 0.0f, 2.0f, 0.5f);
+  fillDescriptor(*descriptors[3], 3, {6});
+
+  std::map<NodeId, std::set<NodeId>> root_leaf_map;
+  for (const auto& root_descriptor_pair : descriptors) {
+    root_descriptor_pair.second->timestamp = std::chrono::nanoseconds(0);
+    root_descriptor_pair.second->root_position = Eigen::Vector3d::Zero();
+    computeDescriptorSketch(*root_descriptor_pair.second, config.sketch_bits);
+    root_leaf_map[root_descriptor_pair.first] = {100 + root_descriptor_pair.first};
+  }
+  query->timestamp = std::chrono::nanoseconds(0);
+
+  {  // test case 1: opposite descriptor is rejected before scoring
+    const auto results =
+        searchDescriptors(*query, config, valid_matches, descriptors, root_leaf_map, 5);
+    std::set<NodeId> expected_matches{1, 3};
+    EXPECT_EQ(expected_matches, results.valid_matches);
+    EXPECT_EQ(results.stats.num_candidates, 3u);
+    EXPECT_EQ(results.stats.num_sketch_rejected, 1u);
+    EXPECT_EQ(results.stats.num_scored, 2u);
+    EXPECT_EQ(results.stats.num_valid, 2u);
+  }
+
+  {  // test case 2: only one candidate is scored
+    config.max_sketch_candidates = 1;
+    const auto results =
+        searchDescriptors(*query, config, valid_matches, descriptors, root_leaf_map, 5);
+    EXPECT_EQ(results.valid_matches.size(), 1u);
+    EXPECT_EQ(results.stats.num_sketch_rejected, 1u);
+    EXPECT_EQ(results.stats.num_sketch_capped, 1u);
+    EXPECT_EQ(results.stats.num_scored, 1u);
+  }
+}
+
+TEST(LoopClosureModuleMatchingTests, SearchDescriptorsUnsketchedOutsideCap) {
+  Descriptor::Ptr query = makeDescriptor(1.0f, 0.0f, 2.0f, 0.5f);
+  fillDescriptor(*query, 0, {13});
+
+  DescriptorMatchConfig config;
+  config.min_score = 0.7f;
+  config.min_registration_score = 0.7f;
+  config.max_registration_matches = 10;
+  config.min_match_separation_m = 0.0;
+  config.type = DescriptorScoreType::COSINE;
+  config.sketch_bits = 64;
+  config.max_sketch_distance = 0.25;
+  config.max_sketch_candidates = 2;
+  computeDescriptorSketch(*query, config.sketch_bits);
+
+  // the closest match has a sketch, but more candidates than the cap don't
+  DescriptorCache descriptors;
+  descriptors[1] = makeDescriptor(1.0f, 0.0f, 2.0f, 0.5f);
+  fillDescriptor(*descriptors[1], 1, {20});
+  computeDescriptorSketch(*descriptors[1], config.sketch_bits);
+  for (NodeId id = 2; id < 6; ++id) {
+    descriptors[id] = makeDescriptor(1.0f, 0.1f * id, 2.0f, 0.5f);
+    fillDescriptor(*descriptors[id], id, {20 + id});
+  }
+
+  std::set<NodeId> valid_matches;
+  std::map<NodeId, std::set<NodeId>> root_leaf_map;
+  for (const auto& root_descriptor_pair : descriptors) {
+    root_descriptor_pair.second->timestamp = std::chrono::nanoseconds(0);
+    root_descriptor_pair.second->root_position = Eigen::Vector3d::Zero();
+    root_leaf_map[root_descriptor_pair.first] = {100 + root_descriptor_pair.first};
+    valid_matches.insert(root_descriptor_pair.first);
+  }
+  query->timestamp = std::chrono::nanoseconds(0);
+
+  const auto results =
+      searchDescriptors(*query, config, valid_matches, descriptors, root_leaf_map, 5);
+  EXPECT_TRUE(results.valid_matches.count(1));
+  EXPECT_EQ(0u, results.stats.num_sketch_rejected);
+  EXPECT_EQ(0u, results.stats.num_sketch_capped);
+  EXPECT_EQ(5u, results.stats.num_scored);
+}
+
+TEST(LoopClosureModuleMatchingTests, TestMultiScaleScore) {
+  Descriptor::Ptr d1 = makeDescriptor(1.0f, 0.0f, 1.0f, 1.0f);
+  Descriptor::Ptr d2 = makeDescriptor(0.0f, 1.0f, 1.0f, 1.0f);
+  d1->num_scales = 2;
+  d2->num_scales = 2;
+
+  // fine scales are disjoint, coarse scales are identical
+  EXPECT_NEAR(
+      computeCoarseDescriptorScore(*d1, *d2, DescriptorScoreType::L1), 1.0f, 1.0e-6f);
+  EXPECT_NEAR(
+      computeDescriptorScore(*d1, *d2, DescriptorScoreType::L1), 0.5f, 1.0e-6f);
+  EXPECT_NEAR(computeDescriptorScore(*d1, *d2, DescriptorScoreType::COSINE),
+              0.75f,
+              1.0e-6f);
+
+  // single-scale descriptors are scored as a whole
+  d1->num_scales = 1;
+  d2->num_scales = 1;
+  EXPECT_NEAR(computeCoarseDescriptorScore(*d1, *d2, DescriptorScoreType::L1),
+              computeDescriptorScore(*d1, *d2, DescriptorScoreType::L1),
+              1.0e-6f);
+}
+
+TEST(LoopClosureModuleMatchingTests, SearchDescriptorsCoarseRejection) {
+  Descriptor::Ptr query = makeDescriptor(1.0f, 0.0f, 1.0f, 1.0f);
+  query->num_scales = 2;
+  fillDescriptor(*query, 0, {13});
+
+  DescriptorMatchConfig config;
+  config.min_score = 0.4f;
+  config.min_registration_score = 0.4f;
+  config.min_match_separation_m = 0.0;
+  config.min_coarse_score = 0.9f;
+
+  std::set<NodeId> valid_matches{1, 2};
+  DescriptorCache descriptors;
+  descriptors[1] = makeDescriptor(0.0f, 1.0f, 1.0f, 1.0f);
+  fillDescriptor(*descriptors[1], 1, {4});
+  descriptors[2] = makeDescriptor(1.0f, 0.0f, 1.0f, 0.0f);
+  fillDescriptor(*descriptors[2], 2, {5});
+
+  std::map<NodeId, std::set<NodeId>> root_leaf_map;
+  for (const auto& root_descriptor_pair : descriptors) {
+    root_descriptor_pair.second->num_scales = 2;
+    root_descriptor_pair.second->timestamp = std::chrono::nanoseconds(0);
+    root_descriptor_pair.second->root_position = Eigen::Vector3d::Zero();
+    root_leaf_map[root_descriptor_pair.first] = {100 + root_descriptor_pair.first};
+  }
+  query->timestamp = std::chrono::nanoseconds(0);
+
+  const auto results =
+      searchDescriptors(*query, config, valid_matches, descriptors, root_leaf_map, 5);
+  std::set<NodeId> expected_matches{1};
+  EXPECT_EQ(expected_matches, results.valid_matches);
+  EXPECT_EQ(results.stats.num_coarse_rejected, 1u);
+  EXPECT_EQ(results.stats.num_scored, 1u);
+}
+
 TEST(LoopClosureModuleMatchingTests, searchLeafDescriptorsNoValid) {
   Descriptor::Ptr query = makeDescriptor(1.0f);
 
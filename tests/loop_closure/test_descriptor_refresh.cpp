@@ -0,0 +1,136 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/loop_closure/descriptor_refresh.h>
+
+namespace hydra {
+namespace lcd {
+
+DescriptorRefreshConfig makeRefreshConfig(size_t budget, double period_s = 0.0) {
+  DescriptorRefreshConfig config;
+  config.max_refreshes_per_update = budget;
+  config.radius_m = 2.0;
+  config.min_refresh_period_s = period_s;
+  return config;
+}
+
+TEST(DescriptorRefreshTests, TestDisabled) {
+  DescriptorRefreshTracker tracker(makeRefreshConfig(0));
+  EXPECT_FALSE(tracker.enabled());
+
+  tracker.addRoot(1, Eigen::Vector3d::Zero());
+  EXPECT_EQ(0u, tracker.numRoots());
+  EXPECT_EQ(0u, tracker.markChanged(Eigen::Vector3d::Zero()));
+  EXPECT_TRUE(tracker.popStaleRoots(0).empty());
+}
+
+TEST(DescriptorRefreshTests, TestMarkChanged) {
+  DescriptorRefreshTracker tracker(makeRefreshConfig(10));
+  tracker.addRoot(1, Eigen::Vector3d(0.0, 0.0, 0.0));
+  tracker.addRoot(2, Eigen::Vector3d(1.5, 0.0, 0.0));
+  tracker.addRoot(3, Eigen::Vector3d(-3.9, 0.0, 0.0));
+  tracker.addRoot(4, Eigen::Vector3d(10.0, 0.0, 0.0));
+  EXPECT_EQ(4u, tracker.numRoots());
+
+  // only roots within the radius are marked, even when in a neighboring cell
+  EXPECT_EQ(2u, tracker.markChanged(Eigen::Vector3d(0.5, 0.0, 0.0)));
+  EXPECT_TRUE(tracker.isStale(1));
+  EXPECT_TRUE(tracker.isStale(2));
+  EXPECT_FALSE(tracker.isStale(3));
+  EXPECT_FALSE(tracker.isStale(4));
+
+  // already stale roots are not counted twice
+  EXPECT_EQ(1u, tracker.markChanged(Eigen::Vector3d(-2.0, 0.0, 0.0)));
+  EXPECT_EQ(3u, tracker.numStale());
+
+  std::vector<NodeId> expected{1, 2, 3};
+  EXPECT_EQ(expected, tracker.popStaleRoots(0));
+  EXPECT_EQ(0u, tracker.numStale());
+}
+
+TEST(DescriptorRefreshTests, TestBudget) {
+  DescriptorRefreshTracker tracker(makeRefreshConfig(2));
+  for (size_t i = 0; i < 5; ++i) {
+    tracker.addRoot(i, Eigen::Vector3d(0.1 * i, 0.0, 0.0));
+  }
+
+  EXPECT_EQ(5u, tracker.markChanged(Eigen::Vector3d::Zero()));
+
+  std::vector<NodeId> expected{0, 1};
+  EXPECT_EQ(expected, tracker.popStaleRoots(0));
+  expected = {2, 3};
+  EXPECT_EQ(expected, tracker.popStaleRoots(0));
+  expected = {4};
+  EXPECT_EQ(expected, tracker.popStaleRoots(0));
+  EXPECT_TRUE(tracker.popStaleRoots(0).empty());
+}
+
+TEST(DescriptorRefreshTests, TestRefreshPeriod) {
+  DescriptorRefreshTracker tracker(makeRefreshConfig(10, 1.0));
+  tracker.addRoot(1, Eigen::Vector3d::Zero());
+  tracker.addRoot(2, Eigen::Vector3d(0.5, 0.0, 0.0));
+
+  tracker.markChanged(Eigen::Vector3d::Zero());
+  std::vector<NodeId> expected{1, 2};
+  EXPECT_EQ(expected, tracker.popStaleRoots(0));
+
+  // roots stay stale (and in order) until the period has passed
+  tracker.markChanged(Eigen::Vector3d::Zero());
+  EXPECT_TRUE(tracker.popStaleRoots(500000000).empty());
+  EXPECT_EQ(2u, tracker.numStale());
+  EXPECT_EQ(expected, tracker.popStaleRoots(1000000000));
+}
+
+TEST(DescriptorRefreshTests, TestRemoveAndMove) {
+  DescriptorRefreshTracker tracker(makeRefreshConfig(10));
+  tracker.addRoot(1, Eigen::Vector3d::Zero());
+  tracker.addRoot(2, Eigen::Vector3d::Zero());
+
+  EXPECT_EQ(2u, tracker.markChanged(Eigen::Vector3d::Zero()));
+  tracker.removeRoot(1);
+  EXPECT_EQ(1u, tracker.numRoots());
+  EXPECT_EQ(1u, tracker.numStale());
+
+  std::vector<NodeId> expected{2};
+  EXPECT_EQ(expected, tracker.popStaleRoots(0));
+
+  // moving a root updates which changes it responds to
+  tracker.addRoot(2, Eigen::Vector3d(10.0, 0.0, 0.0));
+  EXPECT_EQ(0u, tracker.markChanged(Eigen::Vector3d::Zero()));
+  EXPECT_EQ(1u, tracker.markChanged(Eigen::Vector3d(10.0, 1.0, 0.0)));
+}
+
+}  // namespace lcd
+}  // namespace hydra
@@ -133,6 +133,106 @@ TEST_F(LcdDetectorTests, TestActualChildren) {
   EXPECT_EQ(2u, module.numAgentDescriptors());
 }
 
+TEST_F(LcdDetectorTests, TestParallelUpdate) {
+  std::unordered_set<NodeId> active_places;
+  for (size_t i = 0; i < 4; ++i) {
+    const NodeId place = 10 + i;
+    const NodeId object = 20 + i;
+    auto place_attrs = std::make_unique<PlaceNodeAttributes>();
+    place_attrs->position = Eigen::Vector3d(i, 0.0, 0.0);
+    dsg->emplaceNode(DsgLayers::PLACES, place, std::move(place_attrs));
+    auto object_attrs = std::make_unique<ObjectNodeAttributes>();
+    object_attrs->position = Eigen::Vector3d(i, 0.5, 0.0);
+    object_attrs->semantic_label = i % 2;
+    dsg->emplaceNode(DsgLayers::OBJECTS, object, std::move(object_attrs));
+    dsg->emplaceNode(DsgLayers::AGENTS,
+                     'a',
+                     std::chrono::nanoseconds(10 * (i + 1)),
+                     std::make_unique<AgentNodeAttributes>(
+                         Eigen::Quaterniond::Identity(), Eigen::Vector3d::Zero(), 0));
+    dsg->insertEdge(place, object);
+    dsg->insertEdge(place, NodeSymbol('a', i));
+    if (i > 0) {
+      dsg->insertEdge(place - 1, place);
+    }
+
+    active_places.insert(place);
+  }
+
+  config.num_descriptor_threads = 1;
+  LcdDetector serial(config);
+  serial.updateDescriptorCache(*dsg, active_places);
+
+  config.num_descriptor_threads = 4;
+  LcdDetector module(config);
+  module.updateDescriptorCache(*dsg, active_places);
+  EXPECT_EQ(4u, module.numGraphDescriptors(DsgLayers::PLACES));
+  EXPECT_EQ(4u, module.numGraphDescriptors(DsgLayers::OBJECTS));
+  EXPECT_EQ(4u, module.numAgentDescriptors());
+
+  // each root gets the same descriptor no matter which thread computed it
+  for (const auto layer : {DsgLayers::PLACES, DsgLayers::OBJECTS}) {
+    const auto& expected = serial.getDescriptorCache(layer);
+    const auto& result = module.getDescriptorCache(layer);
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t i = 0; i < 4; ++i) {
+      const NodeId root = 10 + i;
+      ASSERT_TRUE(expected.count(root));
+      ASSERT_TRUE(result.count(root));
+      ASSERT_TRUE(result.at(root) != nullptr);
+      EXPECT_EQ(result.at(root)->root_node, root);
+      EXPECT_EQ(expected.at(root)->nodes, result.at(root)->nodes);
+      ASSERT_EQ(expected.at(root)->values.rows(), result.at(root)->values.rows());
+      EXPECT_EQ(expected.at(root)->values, result.at(root)->values)
+          << "layer " << layer << ", root " << root;
+    }
+  }
+}
+
+TEST_F(LcdDetectorTests, TestRefreshDescriptors) {
+  using namespace std::chrono_literals;
+  dsg->emplaceNode(DsgLayers::PLACES, 1, std::make_unique<PlaceNodeAttributes>());
+  dsg->emplaceNode(DsgLayers::OBJECTS, 2, std::make_unique<ObjectNodeAttributes>());
+  dsg->emplaceNode(DsgLayers::AGENTS,
+                   'a',
+                   10ns,
+                   std::make_unique<AgentNodeAttributes>(
+                       Eigen::Quaterniond::Identity(), Eigen::Vector3d::Zero(), 0));
+  dsg->insertEdge(1, 2);
+  dsg->insertEdge(1, NodeSymbol('a', 0));
+
+  config.descriptor_refresh.max_refreshes_per_update = 1;
+  config.descriptor_refresh.min_refresh_period_s = 1.0;
+  LcdDetector module(config);
+  module.updateDescriptorCache(*dsg, {1});
+  ASSERT_EQ(1u, module.numGraphDescriptors(DsgLayers::OBJECTS));
+  EXPECT_EQ(1u, module.getRefreshTracker().numRoots());
+
+  const auto& objects = module.getDescriptorCache(DsgLayers::OBJECTS);
+  const Eigen::VectorXf prev_values = objects.at(1)->values;
+
+  // a new object with a different label shows up next to the root
+  auto attrs = std::make_unique<ObjectNodeAttributes>();
+  attrs->semantic_label = 5;
+  dsg->emplaceNode(DsgLayers::OBJECTS, 3, std::move(attrs));
+  dsg->insertEdge(1, 3);
+  module.resetSubgraphCache();
+
+  EXPECT_EQ(0u, module.refreshDescriptors(*dsg, 0));
+  EXPECT_EQ(1u, module.markChangedNodes(*dsg, {3}));
+  EXPECT_EQ(1u, module.refreshDescriptors(*dsg, 0));
+  EXPECT_EQ(0u, module.getRefreshTracker().numStale());
+
+  ASSERT_EQ(1u, module.numGraphDescriptors(DsgLayers::OBJECTS));
+  EXPECT_FALSE(prev_values.isApprox(objects.at(1)->values));
+  EXPECT_EQ(1u, module.numAgentDescriptors());
+
+  // refreshing again is rate limited
+  EXPECT_EQ(1u, module.markChangedNodes(*dsg, {3}));
+  EXPECT_EQ(0u, module.refreshDescriptors(*dsg, 500000000));
+  EXPECT_EQ(1u, module.refreshDescriptors(*dsg, 1000000000));
+}
+
 TEST_F(LcdDetectorTests, TestEmptySearch) {
   using namespace std::chrono_literals;
   dsg->emplaceNode(DsgLayers::AGENTS,
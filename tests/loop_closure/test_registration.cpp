@@ -389,5 +389,75 @@ TEST_F(LayerRegistrationTests, TestRepeatedRegistration) {
   ASSERT_TRUE(solution.valid);
 }
 
+namespace {
+
+inline SubgraphGeometry makeGeometry(const Eigen::MatrixXd& points, uint8_t label) {
+  SubgraphGeometry geometry;
+  for (int i = 0; i < points.cols(); ++i) {
+    geometry.nodes.push_back(i);
+  }
+  geometry.positions = points;
+  geometry.labels.resize(points.cols(), label);
+  return geometry;
+}
+
+}  // namespace
+
+TEST_F(LayerRegistrationTests, TestPreVerification) {
+  PreVerificationConfig config;
+  config.max_distance_m = 20.0;
+
+  const auto src = makeGeometry(src_points, 0);
+  const auto dest = makeGeometry(dest_points, 0);
+  EXPECT_GT(pairwiseDistanceSimilarity(config, src, dest), 0.99);
+  EXPECT_NEAR(triangleCongruenceRatio(config, src, dest), 1.0, 1.0e-9);
+  EXPECT_EQ(preVerifyRegistration(config, src, dest, true),
+            PreVerificationResult::ACCEPTED);
+
+  // scaling changes the pairwise distances
+  const auto scaled = makeGeometry(3.0 * dest_points, 0);
+  EXPECT_LT(pairwiseDistanceSimilarity(config, src, scaled), 0.5);
+  EXPECT_EQ(preVerifyRegistration(config, src, scaled, true),
+            PreVerificationResult::HISTOGRAM_REJECTED);
+
+  // geometry is consistent, but no destination nodes share labels with the source
+  const auto relabeled = makeGeometry(dest_points, 1);
+  EXPECT_EQ(triangleCongruenceRatio(config, src, relabeled), 0.0);
+  EXPECT_EQ(preVerifyRegistration(config, src, relabeled, true),
+            PreVerificationResult::TRIANGLE_REJECTED);
+  EXPECT_EQ(preVerifyRegistration(config, src, relabeled, false),
+            PreVerificationResult::ACCEPTED);
+}
+
+TEST_F(GraphRegistrationTests, TestFullObjectRegistrationWithPreVerification) {
+  DsgRegistrationInput match;
+  for (int i = 0; i < src_points.cols(); ++i) {
+    match.query_nodes.insert(NodeSymbol('O', i + src_points.cols()));
+    match.match_nodes.insert(NodeSymbol('O', i));
+  }
+
+  match.query_root = NodeSymbol('p', src_points.cols());
+  match.match_root = NodeSymbol('p', 0);
+
+  teaser::RobustRegistrationSolver::Params params;
+  reg_config.use_pairwise_registration = false;
+  reg_config.pre_verification.enable = true;
+  reg_config.pre_verification.max_distance_m = 20.0;
+  DsgTeaserSolver solver(DsgLayers::OBJECTS, reg_config, params);
+
+  auto result = solver.solve(*dsg, match, NodeSymbol('a', 1));
+  EXPECT_TRUE(result.valid);
+  EXPECT_EQ(solver.pre_verification_stats.num_checked, 1u);
+  EXPECT_EQ(solver.pre_verification_stats.num_accepted, 1u);
+
+  // rejected candidates never reach teaser
+  reg_config.pre_verification.min_histogram_similarity = 1.1;
+  DsgTeaserSolver strict_solver(DsgLayers::OBJECTS, reg_config, params);
+  result = strict_solver.solve(*dsg, match, NodeSymbol('a', 1));
+  EXPECT_FALSE(result.valid);
+  EXPECT_EQ(strict_solver.pre_verification_stats.num_histogram_rejected, 1u);
+  EXPECT_EQ(strict_solver.pre_verification_stats.num_accepted, 0u);
+}
+
 }  // namespace lcd
 }  // namespace hydra
@@ -281,5 +281,116 @@ TEST(LoopClosureModuleDescriptorTests, TestObjectDescriptor) {
   }
 }
 
+TEST(LoopClosureModuleDescriptorTests, TestMultiScaleObjectDescriptor) {
+  DynamicSceneGraph graph;
+  const DynamicSceneGraphNode& node = makeDefaultAgentNode(graph);
+
+  size_t next_place_index = 0;
+  emplacePlaceNode(graph, Eigen::Vector3d(0.0, 0.0, 0.0), 0.1, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(2.0, 0.0, 0.0), 0.2, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(4.0, 0.0, 0.0), 0.3, next_place_index);
+  graph.insertEdge(NodeSymbol('p', 0), NodeSymbol('p', 1));
+  graph.insertEdge(NodeSymbol('p', 1), NodeSymbol('p', 2));
+
+  size_t next_object_index = 0;
+  emplaceObjectNode(graph, Eigen::Vector3d(0.5, 0.0, 0.0), 0, next_object_index);
+  emplaceObjectNode(graph, Eigen::Vector3d(1.5, 0.0, 0.0), 1, next_object_index);
+  emplaceObjectNode(graph, Eigen::Vector3d(2.5, 0.0, 0.0), 1, next_object_index);
+  emplaceObjectNode(graph, Eigen::Vector3d(3.5, 0.0, 0.0), 2, next_object_index);
+  graph.insertEdge(NodeSymbol('p', 0), NodeSymbol('o', 0));
+  graph.insertEdge(NodeSymbol('p', 1), NodeSymbol('o', 1));
+  graph.insertEdge(NodeSymbol('p', 1), NodeSymbol('o', 2));
+  graph.insertEdge(NodeSymbol('p', 2), NodeSymbol('o', 3));
+
+  // radii are sorted by the factory and capped by the extraction radius
+  MultiScaleObjectDescriptorFactory factory(SubgraphConfig(3.0), {5.0, 3.0, 1.0}, 4);
+  EXPECT_TRUE(factory.construct(graph, node) == nullptr);
+
+  graph.insertEdge(node.id, NodeSymbol('p', 0));
+  auto descriptor = factory.construct(graph, node);
+  ASSERT_TRUE(descriptor != nullptr);
+  EXPECT_EQ(descriptor->num_scales, 2u);
+
+  Eigen::VectorXf expected(8);
+  expected << 1, 0, 0, 0, 1, 2, 0, 0;
+  EXPECT_EQ(expected, descriptor->values);
+  std::set<NodeId> expected_nodes{
+      NodeSymbol('o', 0), NodeSymbol('o', 1), NodeSymbol('o', 2)};
+  EXPECT_EQ(expected_nodes, descriptor->nodes);
+
+  // each scale matches the single-scale descriptor at the same radius
+  for (const auto radius : {1.0, 3.0}) {
+    ObjectDescriptorFactory single(radius, 4);
+    const size_t scale = radius == 1.0 ? 0 : 1;
+    const Eigen::VectorXf block = descriptor->values.segment(4 * scale, 4);
+    EXPECT_EQ(single.construct(graph, node)->values, block);
+  }
+}
+
+TEST(LoopClosureModuleDescriptorTests, TestMultiScalePlaceDescriptor) {
+  DynamicSceneGraph graph;
+  const DynamicSceneGraphNode& node = makeDefaultAgentNode(graph);
+
+  size_t next_place_index = 0;
+  emplacePlaceNode(graph, Eigen::Vector3d(0.0, 0.0, 0.0), 0.1, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(0.5, 0.0, 0.0), 0.3, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(1.5, 0.0, 0.0), 0.3, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(5.0, 0.0, 0.0), 0.1, next_place_index);
+  graph.insertEdge(NodeSymbol('p', 0), NodeSymbol('p', 1));
+  graph.insertEdge(NodeSymbol('p', 1), NodeSymbol('p', 2));
+  graph.insertEdge(NodeSymbol('p', 2), NodeSymbol('p', 3));
+  graph.insertEdge(node.id, NodeSymbol('p', 0));
+
+  MultiScalePlaceDescriptorFactory factory(
+      SubgraphConfig(10.0), {1.0, 2.0}, HistogramConfig<double>(0.0, 0.4, 2));
+  auto descriptor = factory.construct(graph, node);
+  ASSERT_TRUE(descriptor != nullptr);
+  EXPECT_EQ(descriptor->num_scales, 3u);
+
+  Eigen::VectorXf expected(6);
+  expected << 1, 1, 1, 2, 2, 2;
+  EXPECT_EQ(expected, descriptor->values);
+  EXPECT_EQ(descriptor->nodes.size(), 4u);
+}
+
+TEST(LoopClosureModuleDescriptorTests, TestMultiScaleUsesExtractionConfig) {
+  DynamicSceneGraph graph;
+  const DynamicSceneGraphNode& node = makeDefaultAgentNode(graph);
+
+  size_t next_place_index = 0;
+  emplacePlaceNode(graph, Eigen::Vector3d(0.0, 0.0, 0.0), 0.1, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(0.5, 0.0, 0.0), 0.3, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(1.5, 0.0, 0.0), 0.3, next_place_index);
+  emplacePlaceNode(graph, Eigen::Vector3d(5.0, 0.0, 0.0), 0.1, next_place_index);
+  graph.insertEdge(NodeSymbol('p', 0), NodeSymbol('p', 1));
+  graph.insertEdge(NodeSymbol('p', 1), NodeSymbol('p', 2));
+  graph.insertEdge(NodeSymbol('p', 2), NodeSymbol('p', 3));
+  graph.insertEdge(node.id, NodeSymbol('p', 0));
+
+  // stops adding nodes past the min radius once min_nodes is reached
+  SubgraphConfig config;
+  config.fixed_radius = false;
+  config.max_radius_m = 10.0;
+  config.min_radius_m = 1.0;
+  config.min_nodes = 2;
+
+  const HistogramConfig<double> histogram(0.0, 0.4, 2);
+  MultiScalePlaceDescriptorFactory factory(config, {0.25, 20.0}, histogram);
+  auto descriptor = factory.construct(graph, node);
+  ASSERT_TRUE(descriptor != nullptr);
+  EXPECT_EQ(descriptor->num_scales, 2u);
+
+  Eigen::VectorXf expected(4);
+  expected << 1, 0, 1, 1;
+  EXPECT_EQ(expected, descriptor->values);
+
+  // the coarsest scale matches the single-scale descriptor with the same config
+  PlaceDescriptorFactory single(config, histogram);
+  auto single_descriptor = single.construct(graph, node);
+  ASSERT_TRUE(single_descriptor != nullptr);
+  EXPECT_EQ(single_descriptor->values, descriptor->values.tail(2));
+  EXPECT_EQ(single_descriptor->nodes, descriptor->nodes);
+}
+
 }  // namespace lcd
 }  // namespace hydra
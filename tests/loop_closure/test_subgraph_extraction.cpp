@@ -208,4 +208,62 @@ TEST(GnnLcdTests, testGetSubgraphObjects) {
   }
 }
 
+TEST(GnnLcdTests, testSubgraphGeometry) {
+  DynamicSceneGraph graph;
+
+  size_t node_idx = 0;
+  emplacePlaceNode(graph, Eigen::Vector3d(0.1, 0.0, 0.0), 0.1, 1, node_idx);
+  emplacePlaceNode(graph, Eigen::Vector3d(0.2, 0.0, 0.0), 0.1, 2, node_idx);
+  emplacePlaceNode(graph, Eigen::Vector3d(0.3, 0.0, 0.0), 0.1, 3, node_idx);
+
+  // missing nodes are dropped and the remaining nodes stay sorted
+  const std::set<NodeId> to_add{"p2"_id, "p0"_id, "p5"_id};
+  SubgraphGeometry geometry(graph, DsgLayers::PLACES, "p0"_id, to_add);
+  const std::vector<NodeId> expected{"p0"_id, "p2"_id};
+  EXPECT_EQ(geometry.nodes, expected);
+  EXPECT_EQ(geometry.size(), 2u);
+  EXPECT_TRUE(geometry.contains("p2"_id));
+  EXPECT_FALSE(geometry.contains("p1"_id));
+  EXPECT_NEAR(geometry.positions(0, 0), 0.1, 1.0e-9);
+  EXPECT_NEAR(geometry.positions(0, 1), 0.3, 1.0e-9);
+
+  SubgraphGeometry other(graph, DsgLayers::PLACES, "p1"_id, {"p1"_id, "p2"_id});
+  EXPECT_EQ(countSharedNodes(geometry, other), 1u);
+  EXPECT_EQ(countSharedNodes(other, geometry), 1u);
+}
+
+TEST(GnnLcdTests, testSubgraphCache) {
+  DynamicSceneGraph graph;
+
+  size_t node_idx = 0;
+  emplacePlaceNode(graph, Eigen::Vector3d(0.1, 0.0, 0.0), 0.1, 1, node_idx);
+  emplacePlaceNode(graph, Eigen::Vector3d(0.2, 0.0, 0.0), 0.1, 2, node_idx);
+  emplacePlaceNode(graph, Eigen::Vector3d(0.3, 0.0, 0.0), 0.1, 3, node_idx);
+  graph.insertEdge("p0"_id, "p1"_id);
+  graph.insertEdge("p1"_id, "p2"_id);
+
+  SubgraphConfig config(0.15);
+  SubgraphCache cache;
+  auto first = getSubgraphGeometry(config, graph, "p0"_id, true, &cache);
+  auto second = getSubgraphGeometry(config, graph, "p0"_id, true, &cache);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(cache.numHits(), 1u);
+  EXPECT_EQ(cache.numMisses(), 1u);
+  EXPECT_EQ(first->nodeSet(), getSubgraphNodes(config, graph, "p0"_id, true));
+
+  // different radius or layer are different entries
+  SubgraphConfig larger(0.25);
+  auto third = getSubgraphGeometry(larger, graph, "p0"_id, true, &cache);
+  EXPECT_NE(first, third);
+  EXPECT_EQ(third->size(), 3u);
+  getSubgraphGeometry(config, graph, "p0"_id, false, &cache);
+  EXPECT_EQ(cache.size(), 3u);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+  auto fourth = getSubgraphGeometry(config, graph, "p0"_id, true, &cache);
+  EXPECT_NE(first, fourth);
+  EXPECT_EQ(first->nodes, fourth->nodes);
+}
+
 }  // namespace hydra
@@ -0,0 +1,74 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/places/gvd_dirty_tracker.h>
+
+namespace hydra {
+namespace places {
+
+TEST(GvdDirtyTracker, PushesEachVoxelOnce) {
+  GvdDirtyTracker tracker(4);
+  EXPECT_TRUE(tracker.empty());
+
+  tracker.markPushed(GlobalIndex(1, 2, 3));
+  tracker.markPushed(GlobalIndex(-1, 0, 0));
+  // repeated pushes in the same update are dropped
+  tracker.markPushed(GlobalIndex(1, 2, 3));
+  tracker.markPushed(GlobalIndex(5, 0, 0));
+
+  EXPECT_FALSE(tracker.empty());
+  EXPECT_EQ(3u, tracker.blocks.size());
+  const std::vector<GlobalIndex> expected{
+      GlobalIndex(1, 2, 3), GlobalIndex(-1, 0, 0), GlobalIndex(5, 0, 0)};
+  EXPECT_EQ(expected, tracker.pushed);
+
+  const auto& block = tracker.blocks.at(BlockIndex(0, 0, 0));
+  const size_t expected_index = 1 + 4 * (2 + 4 * 3);
+  std::vector<size_t> seen;
+  block.pushed.forEach([&](size_t idx) { seen.push_back(idx); });
+  EXPECT_EQ(std::vector<size_t>{expected_index}, seen);
+
+  const auto& neg_block = tracker.blocks.at(BlockIndex(-1, 0, 0));
+  EXPECT_TRUE(neg_block.pushed.test(3));
+
+  tracker.removeBlock(BlockIndex(0, 0, 0));
+  EXPECT_EQ(2u, tracker.blocks.size());
+  tracker.clear();
+  EXPECT_TRUE(tracker.empty());
+  EXPECT_TRUE(tracker.pushed.empty());
+}
+
+}  // namespace places
+}  // namespace hydra
@@ -38,6 +38,10 @@
 #include <voxblox/integrator/tsdf_integrator.h>
 #include <voxblox/utils/evaluation_utils.h>
 
+#include <algorithm>
+#include <array>
+#include <set>
+
 #include "hydra_test/gvd_layer_utils.h"
 #include "hydra_test/place_fixtures.h"
 #include "hydra_test/resources.h"
@@ -48,8 +52,35 @@ namespace places {
 using namespace voxblox;
 
 using test::compareLayers;
+using test::EsdfTestFixture;
 using test::LayerComparisonResult;
 
+struct GraphSummary {
+  using Key = std::array<int64_t, 3>;
+
+  explicit GraphSummary(const SceneGraphLayer& graph) {
+    // node ids depend on extraction order, so nodes are identified by position
+    const auto to_key = [&](NodeId node) -> Key {
+      const Eigen::Vector3d pos = 1.0e3 * graph.getPosition(node);
+      return {std::lround(pos.x()), std::lround(pos.y()), std::lround(pos.z())};
+    };
+
+    for (const auto& id_node_pair : graph.nodes()) {
+      nodes.insert(to_key(id_node_pair.first));
+    }
+
+    for (const auto& key_edge_pair : graph.edges()) {
+      const auto& edge = key_edge_pair.second;
+      const auto source = to_key(edge.source);
+      const auto target = to_key(edge.target);
+      edges.insert(std::minmax(source, target));
+    }
+  }
+
+  std::set<Key> nodes;
+  std::set<std::pair<Key, Key>> edges;
+};
+
 class IncrementalIntegrationTestFixture : public ::testing::Test {
  public:
   IncrementalIntegrationTestFixture() = default;
@@ -161,5 +192,47 @@ TEST_F(IncrementalIntegrationTestFixture, DISABLED_TestBatchSame) {
   }
 }
 
+TEST_F(EsdfTestFixture, DirtyMasksExtractSameGraph) {
+  const float voxel_size = 0.25f;
+  const int voxels_per_side = 16;
+  num_poses = 5;
+
+  TsdfIntegratorBase::Config tsdf_config;
+  Layer<TsdfVoxel>::Ptr tsdf_layer(new Layer<TsdfVoxel>(voxel_size, voxels_per_side));
+  FastTsdfIntegrator tsdf_integrator(tsdf_config, tsdf_layer.get());
+
+  MeshIntegratorConfig mesh_config;
+  mesh_config.integrator_threads = 1;
+  GvdIntegratorConfig gvd_config;
+  gvd_config.min_distance_m = tsdf_config.default_truncation_distance;
+  gvd_config.max_distance_m = 10.0;
+  gvd_config.extract_graph = true;
+
+  Layer<GvdVoxel>::Ptr gvd_layer(new Layer<GvdVoxel>(voxel_size, voxels_per_side));
+  MeshLayer::Ptr mesh_layer(new MeshLayer(voxel_size * voxels_per_side));
+  ComboIntegrator integrator(
+      gvd_config, tsdf_layer.get(), gvd_layer, mesh_layer, &mesh_config);
+
+  gvd_config.use_dirty_masks = true;
+  Layer<GvdVoxel>::Ptr dirty_layer(new Layer<GvdVoxel>(voxel_size, voxels_per_side));
+  MeshLayer::Ptr dirty_mesh(new MeshLayer(voxel_size * voxels_per_side));
+  ComboIntegrator dirty_integrator(
+      gvd_config, tsdf_layer.get(), dirty_layer, dirty_mesh, &mesh_config);
+
+  for (size_t i = 0; i < num_poses; ++i) {
+    updateTsdfIntegrator(tsdf_integrator, i);
+
+    // we need to keep the updated flags for the second integrator
+    integrator.update(0, false);
+    dirty_integrator.update(0, true);
+
+    const GraphSummary expected(integrator.getGraph());
+    const GraphSummary result(dirty_integrator.getGraph());
+    EXPECT_FALSE(expected.nodes.empty());
+    EXPECT_EQ(expected.nodes, result.nodes) << "pose " << i;
+    EXPECT_EQ(expected.edges, result.edges) << "pose " << i;
+  }
+}
+
 }  // namespace places
 }  // namespace hydra
@@ -0,0 +1,285 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/reconstruction/compact_semantic_integrator.h>
+#include <hydra/reconstruction/compact_semantic_voxel.h>
+
+#include <random>
+
+#include "hydra_test/resources.h"
+
+namespace hydra {
+
+// reference dense bayesian update over all labels
+struct DenseSemanticVoxel {
+  DenseSemanticVoxel(size_t num_labels, float p_match)
+      : log_probs(Eigen::VectorXf::Constant(num_labels, -std::log(num_labels))),
+        log_match(std::log(p_match)),
+        log_other(std::log((1.0f - p_match) / (num_labels - 1))) {}
+
+  void update(uint8_t label) {
+    log_probs.array() += log_other;
+    log_probs(label) += log_match - log_other;
+    const float max = log_probs.maxCoeff();
+    const float norm = max + std::log((log_probs.array() - max).exp().sum());
+    log_probs.array() -= norm;
+  }
+
+  Eigen::VectorXf probs() const { return log_probs.array().exp(); }
+
+  Eigen::VectorXf log_probs;
+  float log_match;
+  float log_other;
+};
+
+struct SemanticComparison {
+  SemanticComparison(size_t num_labels, float p_match)
+      : num_labels(num_labels),
+        dense(num_labels, p_match),
+        ratio(std::log(p_match) - std::log((1.0f - p_match) / (num_labels - 1))) {}
+
+  void update(uint8_t label) {
+    dense.update(label);
+    updateCompactSemanticVoxel(compact, label, ratio, num_labels);
+  }
+
+  size_t num_labels;
+  DenseSemanticVoxel dense;
+  CompactSemanticVoxel compact;
+  float ratio;
+};
+
+TEST(CompactSemantics, EmptyVoxelUniform) {
+  CompactSemanticVoxel voxel;
+  EXPECT_FALSE(getMostLikelyLabel(voxel));
+
+  const Eigen::VectorXf probs = getLabelDistribution(voxel, 10);
+  EXPECT_NEAR(1.0f, probs.sum(), 1.0e-6f);
+  EXPECT_NEAR(0.1f, probs.maxCoeff(), 1.0e-6f);
+  EXPECT_NEAR(0.1f, probs.minCoeff(), 1.0e-6f);
+}
+
+TEST(CompactSemantics, MatchesDenseWithFewLabels) {
+  // with no more than k observed labels, the compact voxel is exact up to
+  // quantization
+  SemanticComparison voxel(40, 0.6f);
+  const std::vector<uint8_t> labels{3, 3, 7, 1, 3, 7, 7, 7, 22, 3};
+  for (const auto label : labels) {
+    voxel.update(label);
+    const Eigen::VectorXf expected = voxel.dense.probs();
+    const Eigen::VectorXf result = getLabelDistribution(voxel.compact, 40);
+    EXPECT_NEAR(1.0f, result.sum(), 1.0e-4f);
+    for (size_t i = 0; i < 40; ++i) {
+      EXPECT_NEAR(expected(i), result(i), 1.0e-2f) << "label: " << i;
+    }
+  }
+
+  Eigen::Index expected_label;
+  voxel.dense.probs().maxCoeff(&expected_label);
+  ASSERT_TRUE(getMostLikelyLabel(voxel.compact));
+  EXPECT_EQ(expected_label, *getMostLikelyLabel(voxel.compact));
+}
+
+TEST(CompactSemantics, EvictionKeepsUntrackedMass) {
+  const size_t num_labels = 10;
+  const float ratio = 1.0f;
+  CompactSemanticVoxel voxel;
+  for (const uint8_t label : {0, 0, 0, 1, 1, 2, 2, 3}) {
+    updateCompactSemanticVoxel(voxel, label, ratio, num_labels);
+  }
+
+  ASSERT_EQ(CompactSemanticVoxel::kMaxLabels, voxel.num_labels);
+  const Eigen::VectorXf before = getLabelDistribution(voxel, num_labels);
+
+  // an uninformative observation of a new label evicts label 3 without changing the
+  // probability of any label that stays tracked or the mass of the untracked labels
+  updateCompactSemanticVoxel(voxel, 4, 0.0f, num_labels);
+  const Eigen::VectorXf after = getLabelDistribution(voxel, num_labels);
+  EXPECT_NEAR(1.0f, after.sum(), 1.0e-4f);
+
+  float untracked_before = 1.0f;
+  float untracked_after = 1.0f;
+  for (const uint8_t label : {0, 1, 2}) {
+    EXPECT_NEAR(before(label), after(label), 1.0e-3f) << "label: " << +label;
+    untracked_before -= before(label);
+    untracked_after -= after(label);
+  }
+
+  EXPECT_NEAR(untracked_before, untracked_after, 1.0e-3f);
+
+  // the new label keeps its share and the evicted label is spread over the rest
+  EXPECT_NEAR(before(4), after(4), 1.0e-3f);
+  const float expected_residual = (untracked_before - before(4)) / 6;
+  for (const uint8_t label : {3, 5, 6, 7, 8, 9}) {
+    EXPECT_NEAR(expected_residual, after(label), 1.0e-3f) << "label: " << +label;
+  }
+}
+
+TEST(CompactSemantics, MatchesDenseOnSyntheticScene) {
+  // voxels each have a true label that is observed with noise
+  const size_t num_labels = 40;
+  const size_t num_voxels = 500;
+  const size_t num_observations = 30;
+  const float p_correct = 0.7f;
+
+  std::mt19937 gen(12345);
+  std::uniform_int_distribution<int> label_dist(0, num_labels - 1);
+  std::uniform_real_distribution<float> noise_dist(0.0f, 1.0f);
+
+  size_t num_compared = 0;
+  size_t num_correct = 0;
+  double total_error = 0.0;
+  for (size_t v = 0; v < num_voxels; ++v) {
+    const uint8_t true_label = label_dist(gen);
+    SemanticComparison voxel(num_labels, 0.6f);
+    for (size_t i = 0; i < num_observations; ++i) {
+      const bool correct = noise_dist(gen) < p_correct;
+      voxel.update(correct ? true_label : label_dist(gen));
+    }
+
+    const Eigen::VectorXf expected = voxel.dense.probs();
+    Eigen::Index expected_label;
+    const float expected_prob = expected.maxCoeff(&expected_label);
+    if (expected_prob < 0.5f) {
+      continue;  // ambiguous voxel
+    }
+
+    ++num_compared;
+    const auto result = getMostLikelyLabel(voxel.compact);
+    if (result && *result == expected_label) {
+      ++num_correct;
+    }
+
+    const Eigen::VectorXf probs = getLabelDistribution(voxel.compact, num_labels);
+    total_error += std::abs(probs(expected_label) - expected_prob);
+  }
+
+  ASSERT_GT(num_compared, 0u);
+  EXPECT_EQ(num_compared, num_correct);
+  EXPECT_LT(total_error / num_compared, 1.0e-2);
+}
+
+TEST(CompactSemantics, CompactVoxelSize) {
+  // the point of the compact voxel is to be a fraction of a dense 40-class voxel
+  EXPECT_LE(sizeof(CompactSemanticVoxel), 16u);
+}
+
+struct CompactIntegratorFixture : public ::testing::Test {
+  CompactIntegratorFixture() : tsdf(0.1, 8), semantics(0.1, 8), changes(8) {
+    config.default_truncation_distance = 0.2;
+    config.integrator_threads = 4;
+    semantic_config.semantic_measurement_probability_ = 0.8;
+    semantic_config.semantic_label_to_color_.reset(
+        new kimera::SemanticLabel2Color(test::get_default_semantic_map()));
+  }
+
+  // wall at x = 1.05 (a row of voxel centers) with label 1 for y < 0 and 2 otherwise
+  void integrateWall(CompactSemanticTsdfIntegrator& integrator) const {
+    const auto& label_map = *semantic_config.semantic_label_to_color_;
+    voxblox::Pointcloud points;
+    voxblox::Colors colors;
+    for (float y = -0.5f; y <= 0.5f; y += 0.02f) {
+      for (float z = -0.5f; z <= 0.5f; z += 0.02f) {
+        points.emplace_back(1.05f, y, z);
+        colors.push_back(label_map.getColorFromSemanticLabel(y < 0.0f ? 1 : 2));
+      }
+    }
+
+    integrator.integratePointCloud(voxblox::Transformation(), points, colors);
+  }
+
+  const CompactSemanticVoxel& getSemanticVoxel(const voxblox::Point& point) const {
+    return semantics.getBlockPtrByCoordinates(point)->getVoxelByCoordinates(point);
+  }
+
+  voxblox::TsdfIntegratorBase::Config config;
+  kimera::SemanticIntegratorBase::SemanticConfig semantic_config;
+  voxblox::Layer<voxblox::TsdfVoxel> tsdf;
+  voxblox::Layer<CompactSemanticVoxel> semantics;
+  TsdfChangeTracker changes;
+};
+
+TEST_F(CompactIntegratorFixture, LabelsSurfaceFromPointColors) {
+  CompactSemanticTsdfIntegrator integrator(config, semantic_config, &tsdf, &semantics);
+  integrator.setChangeTracker(&changes);
+  integrateWall(integrator);
+
+  const voxblox::Point left(1.05f, -0.25f, 0.05f);
+  const voxblox::Point right(1.05f, 0.25f, 0.05f);
+  ASSERT_TRUE(semantics.getBlockPtrByCoordinates(left) != nullptr);
+  ASSERT_TRUE(semantics.getBlockPtrByCoordinates(right) != nullptr);
+  EXPECT_EQ(1u, getMostLikelyLabel(getSemanticVoxel(left)).value_or(0));
+  EXPECT_EQ(2u, getMostLikelyLabel(getSemanticVoxel(right)).value_or(0));
+  EXPECT_TRUE(semantics.getBlockPtrByCoordinates(left)->updated().any());
+
+  // only voxels near the surface observe labels
+  const voxblox::Point free_space(0.55f, -0.15f, 0.05f);
+  if (semantics.getBlockPtrByCoordinates(free_space)) {
+    EXPECT_EQ(0u, getSemanticVoxel(free_space).num_labels);
+  }
+
+  // every voxel touched by a ray is recorded in the change masks
+  const auto tsdf_block = tsdf.getBlockPtrByCoordinates(free_space);
+  ASSERT_TRUE(tsdf_block != nullptr);
+  const auto& voxel = tsdf_block->getVoxelByCoordinates(free_space);
+  EXPECT_GT(voxel.weight, 0.0f);
+  const auto block_index = tsdf.computeBlockIndexFromCoordinates(free_space);
+  ASSERT_TRUE(changes.getChanges(block_index) != nullptr);
+  EXPECT_GT(changes.getChanges(block_index)->count(), 0u);
+}
+
+TEST_F(CompactIntegratorFixture, DynamicLabelsSkipped) {
+  semantic_config.dynamic_labels_ = {1};
+  CompactSemanticTsdfIntegrator integrator(config, semantic_config, &tsdf, &semantics);
+  integrateWall(integrator);
+
+  // points with dynamic labels update neither the TSDF nor the semantics
+  const voxblox::Point left(1.05f, -0.25f, 0.05f);
+  const auto tsdf_block = tsdf.getBlockPtrByCoordinates(left);
+  if (tsdf_block) {
+    EXPECT_EQ(0.0f, tsdf_block->getVoxelByCoordinates(left).weight);
+  }
+
+  const auto semantic_block = semantics.getBlockPtrByCoordinates(left);
+  if (semantic_block) {
+    EXPECT_EQ(0u, semantic_block->getVoxelByCoordinates(left).num_labels);
+  }
+
+  const voxblox::Point right(1.05f, 0.25f, 0.05f);
+  ASSERT_TRUE(semantics.getBlockPtrByCoordinates(right) != nullptr);
+  EXPECT_EQ(2u, getMostLikelyLabel(getSemanticVoxel(right)).value_or(0));
+}
+
+}  // namespace hydra
@@ -0,0 +1,219 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/reconstruction/combo_integrator.h>
+#include <hydra/reconstruction/dynamic_voxel_detector.h>
+
+namespace hydra {
+
+using voxblox::BlockIndex;
+using voxblox::BlockIndexList;
+using voxblox::Layer;
+using voxblox::MeshLayer;
+using voxblox::TsdfVoxel;
+using voxblox::VoxelIndex;
+
+struct DynamicVoxelFixture : public ::testing::Test {
+  DynamicVoxelFixture() : tsdf(0.1, 4) {}
+
+  void setDistance(size_t index, float distance) {
+    auto block = tsdf.allocateBlockPtrByIndex(BlockIndex::Zero());
+    auto& voxel = block->getVoxelByLinearIndex(index);
+    voxel.distance = distance;
+    voxel.weight = 1.0f;
+    block->updated().set(voxblox::Update::kMesh);
+  }
+
+  void clearFlags() {
+    tsdf.getBlockPtrByIndex(BlockIndex::Zero())->updated().reset();
+  }
+
+  Layer<TsdfVoxel> tsdf;
+};
+
+TEST_F(DynamicVoxelFixture, RepeatedFlipsMarkedDynamic) {
+  DynamicVoxelConfig config;
+  config.min_flips = 3;
+  config.release_frames = 5;
+  DynamicVoxelDetector detector(config, 0.1, 4);
+
+  setDistance(0, 0.3);
+  detector.update(tsdf, 1.0e-6);
+  EXPECT_FALSE(detector.isDynamic(BlockIndex::Zero(), 0));
+
+  // free -> occupied -> free -> occupied
+  const std::vector<float> distances{-0.05, 0.3, 0.0};
+  for (const auto distance : distances) {
+    EXPECT_FALSE(detector.isDynamic(BlockIndex::Zero(), 0));
+    setDistance(0, distance);
+    detector.update(tsdf, 1.0e-6);
+  }
+
+  EXPECT_TRUE(detector.isDynamic(BlockIndex::Zero(), 0));
+  EXPECT_FALSE(detector.isDynamic(BlockIndex::Zero(), 1));
+  EXPECT_EQ(1u, detector.numDynamic());
+  ASSERT_TRUE(detector.getDynamicMask(BlockIndex::Zero()) != nullptr);
+  EXPECT_EQ(1u, detector.getDynamicMask(BlockIndex::Zero())->count());
+
+  // voxel stays dynamic until it doesn't flip for release_frames updates
+  clearFlags();
+  for (size_t i = 0; i < 4; ++i) {
+    detector.update(tsdf, 1.0e-6);
+    EXPECT_TRUE(detector.isDynamic(BlockIndex::Zero(), 0));
+  }
+
+  TsdfChangeTracker changes(4);
+  detector.update(tsdf, 1.0e-6, &changes);
+  EXPECT_FALSE(detector.isDynamic(BlockIndex::Zero(), 0));
+  EXPECT_EQ(0u, detector.numDynamic());
+  EXPECT_EQ(nullptr, detector.getDynamicMask(BlockIndex::Zero()));
+
+  // released voxels get flagged for re-meshing and the GVD
+  const auto& block = tsdf.getBlockByIndex(BlockIndex::Zero());
+  EXPECT_TRUE(block.updated().test(voxblox::Update::kMesh));
+  EXPECT_TRUE(block.updated().test(voxblox::Update::kEsdf));
+  ASSERT_TRUE(changes.getChanges(BlockIndex::Zero()) != nullptr);
+  EXPECT_TRUE(changes.getChanges(BlockIndex::Zero())->test(0));
+
+  // side layer is emptied once no voxels are flipping
+  EXPECT_EQ(0u, detector.getLayer().getNumberOfAllocatedBlocks());
+}
+
+TEST_F(DynamicVoxelFixture, NoiseInBandIgnored) {
+  DynamicVoxelConfig config;
+  config.min_flips = 2;
+  DynamicVoxelDetector detector(config, 0.1, 4);
+
+  // distances that wander within the hysteresis band never flip the voxel
+  const std::vector<float> distances{0.0, 0.06, 0.01, 0.14, 0.04, 0.12};
+  for (const auto distance : distances) {
+    setDistance(0, distance);
+    detector.update(tsdf, 1.0e-6);
+    EXPECT_FALSE(detector.isDynamic(BlockIndex::Zero(), 0));
+  }
+
+  EXPECT_EQ(0u, detector.getLayer().getNumberOfAllocatedBlocks());
+}
+
+TEST_F(DynamicVoxelFixture, OldFlipsForgotten) {
+  DynamicVoxelConfig config;
+  config.min_flips = 3;
+  config.flip_window = 2;
+  DynamicVoxelDetector detector(config, 0.1, 4);
+
+  setDistance(0, 0.3);
+  detector.update(tsdf, 1.0e-6);
+
+  // flip every third frame, which is slower than the flip window
+  for (size_t i = 0; i < 12; ++i) {
+    if (i % 3 == 0) {
+      setDistance(0, (i / 3) % 2 == 0 ? -0.05 : 0.3);
+    }
+
+    detector.update(tsdf, 1.0e-6);
+    EXPECT_FALSE(detector.isDynamic(BlockIndex::Zero(), 0));
+  }
+}
+
+struct WallFixture : public ::testing::Test {
+  WallFixture() : tsdf(voxel_size, voxels_per_side) {}
+
+  void SetUp() override {
+    // wall between x = 2 and x = 3 (free space for x >= 3)
+    block = tsdf.allocateBlockPtrByIndex(BlockIndex::Zero());
+    for (size_t i = 0; i < block->num_voxels(); ++i) {
+      const VoxelIndex index = block->computeVoxelIndexFromLinearIndex(i);
+      auto& voxel = block->getVoxelByLinearIndex(i);
+      voxel.distance = (index.x() - 2.5f) * voxel_size;
+      voxel.weight = 1.0f;
+    }
+    block->updated().set();
+  }
+
+  size_t meshWall(const DynamicVoxelDetector* detector) {
+    places::GvdIntegratorConfig gvd_config;
+    gvd_config.extract_graph = false;
+    places::Layer<places::GvdVoxel>::Ptr gvd(
+        new places::Layer<places::GvdVoxel>(voxel_size, voxels_per_side));
+    MeshLayer::Ptr mesh(new MeshLayer(voxel_size * voxels_per_side));
+    places::ComboIntegrator integrator(gvd_config, &tsdf, gvd, mesh);
+    integrator.mesh_integrator->setDynamicVoxels(detector);
+    integrator.gvd_integrator->setDynamicVoxels(detector);
+    integrator.update(0, false);
+
+    size_t num_vertices = 0;
+    BlockIndexList mesh_blocks;
+    mesh->getAllAllocatedMeshes(&mesh_blocks);
+    for (const auto& idx : mesh_blocks) {
+      num_vertices += mesh->getMeshByIndex(idx).vertices.size();
+    }
+    return num_vertices;
+  }
+
+  const float voxel_size = 0.1f;
+  const int voxels_per_side = 8;
+  Layer<TsdfVoxel> tsdf;
+  Layer<TsdfVoxel>::BlockType::Ptr block;
+};
+
+TEST_F(WallFixture, StaticWallMeshedNextToDynamicVoxel) {
+  const size_t expected_vertices = meshWall(nullptr);
+  EXPECT_GT(expected_vertices, 0u);
+
+  // first free voxel in front of the wall
+  const size_t dynamic_idx =
+      block->computeLinearIndexFromVoxelIndex(VoxelIndex(3, 4, 4));
+  auto& voxel = block->getVoxelByLinearIndex(dynamic_idx);
+  const float static_distance = voxel.distance;
+
+  DynamicVoxelConfig config;
+  config.min_flips = 3;
+  DynamicVoxelDetector detector(config, voxel_size, voxels_per_side);
+  const std::vector<float> distances{0.3, -0.05, 0.3, -0.05, static_distance};
+  for (const auto distance : distances) {
+    voxel.distance = distance;
+    block->updated().set();
+    detector.update(tsdf, 1.0e-6);
+  }
+
+  ASSERT_TRUE(detector.isDynamic(BlockIndex::Zero(), dynamic_idx));
+  ASSERT_EQ(1u, detector.numDynamic());
+
+  // cubes touching the dynamic voxel still mesh the static wall
+  block->updated().set();
+  EXPECT_EQ(expected_vertices, meshWall(&detector));
+}
+
+}  // namespace hydra
@@ -0,0 +1,191 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/reconstruction/quantized_voxels.h>
+#include <voxblox/integrator/tsdf_integrator.h>
+
+#include <random>
+#include <vector>
+
+namespace hydra {
+
+using voxblox::Block;
+using voxblox::Layer;
+using voxblox::TsdfVoxel;
+
+TEST(QuantizedVoxels, DistanceErrorBounded) {
+  const float truncation_distance = 0.2f;
+  TsdfQuantizer quantizer(truncation_distance);
+  EXPECT_NEAR(truncation_distance / 65534.0f, quantizer.distance_resolution, 1.0e-9f);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dist(-truncation_distance, truncation_distance);
+  for (size_t i = 0; i < 10000; ++i) {
+    const float distance = dist(gen);
+    const int16_t value = quantizer.quantizeDistance(distance);
+    const float result = quantizer.dequantizeDistance(value);
+    EXPECT_LE(std::abs(result - distance), quantizer.distance_resolution * 1.001f)
+        << "distance: " << distance;
+  }
+
+  // signs and the truncation bounds are preserved
+  const auto round_trip = [&](float d) {
+    return quantizer.dequantizeDistance(quantizer.quantizeDistance(d));
+  };
+  EXPECT_NEAR(truncation_distance, round_trip(truncation_distance), 1.0e-6f);
+  EXPECT_NEAR(-truncation_distance, round_trip(-truncation_distance), 1.0e-6f);
+  EXPECT_EQ(0.0f, round_trip(0.0f));
+
+  // distances past the truncation distance are clamped
+  EXPECT_NEAR(truncation_distance, round_trip(1.0f), 1.0e-6f);
+  EXPECT_NEAR(-truncation_distance, round_trip(-1.0f), 1.0e-6f);
+}
+
+TEST(QuantizedVoxels, WeightErrorBounded) {
+  EXPECT_EQ(0u, TsdfQuantizer::quantizeWeight(0.0f));
+  EXPECT_EQ(0u, TsdfQuantizer::quantizeWeight(-1.0f));
+  EXPECT_EQ(0.0f, TsdfQuantizer::dequantizeWeight(0u));
+
+  // bfloat16 keeps 8 bits of precision, so the relative error is at most 2^-8
+  const std::vector<float> weights{1.0e-6f, 1.0e-4f, 0.1f, 1.0f, 3.14159f, 1.0e4f};
+  for (const auto weight : weights) {
+    const float result =
+        TsdfQuantizer::dequantizeWeight(TsdfQuantizer::quantizeWeight(weight));
+    EXPECT_GT(result, 0.0f);
+    EXPECT_LE(std::abs(result - weight) / weight, 1.0f / 256.0f)
+        << "weight: " << weight;
+  }
+}
+
+TEST(QuantizedVoxels, BlockRoundTrip) {
+  const size_t num_voxels = 4 * 4 * 4;
+  Block<TsdfVoxel> block(4, 0.1, voxblox::Point::Zero());
+  block.has_data() = true;
+  for (size_t i = 0; i < num_voxels; ++i) {
+    auto& voxel = block.getVoxelByLinearIndex(i);
+    voxel.distance = 0.2f * (static_cast<float>(i) / num_voxels - 0.5f);
+    voxel.weight = 0.5f * i;
+    voxel.color = voxblox::Color(i, 2 * i, 3 * i);
+  }
+
+  TsdfQuantizer quantizer(0.2f);
+  Block<QuantizedTsdfVoxel> quantized(4, 0.1, voxblox::Point::Zero());
+  quantizer.quantizeBlock(block, quantized);
+  EXPECT_TRUE(quantized.has_data());
+
+  Block<TsdfVoxel> result(4, 0.1, voxblox::Point::Zero());
+  quantizer.dequantizeBlock(quantized, result);
+  EXPECT_TRUE(result.has_data());
+  for (size_t i = 0; i < num_voxels; ++i) {
+    const auto& expected = block.getVoxelByLinearIndex(i);
+    const auto& voxel = result.getVoxelByLinearIndex(i);
+    EXPECT_NEAR(
+        expected.distance, voxel.distance, quantizer.distance_resolution * 1.001f);
+    EXPECT_NEAR(expected.weight, voxel.weight, expected.weight / 256.0f);
+    EXPECT_EQ(expected.color.r, voxel.color.r);
+    EXPECT_EQ(expected.color.g, voxel.color.g);
+    EXPECT_EQ(expected.color.b, voxel.color.b);
+  }
+
+  EXPECT_LT(sizeof(QuantizedTsdfVoxel), sizeof(TsdfVoxel));
+}
+
+TEST(QuantizedVoxels, RayPastActiveRadiusMerges) {
+  voxblox::TsdfIntegratorBase::Config config;
+  config.default_truncation_distance = 0.2f;
+  config.max_weight = 1.0e4f;
+  Layer<TsdfVoxel> tsdf(0.1, 8);
+  Layer<QuantizedTsdfVoxel> quantized(0.1, 8);
+  voxblox::SimpleTsdfIntegrator integrator(config, &tsdf);
+
+  const voxblox::Transformation world_T_sensor;
+  const voxblox::Pointcloud cloud{voxblox::Point(3.05, 0.05, 0.05)};
+  const voxblox::Colors colors{voxblox::Color(255, 0, 0)};
+  integrator.integratePointCloud(world_T_sensor, cloud, colors);
+
+  // store every block outside of a 1 meter active radius
+  const float active_radius_m = 1.0f;
+  TsdfQuantizer quantizer(config.default_truncation_distance);
+  voxblox::BlockIndexList blocks;
+  tsdf.getAllAllocatedBlocks(&blocks);
+  std::vector<std::pair<voxblox::BlockIndex, std::vector<TsdfVoxel>>> expected;
+  for (const auto& idx : blocks) {
+    const auto block = tsdf.getBlockPtrByIndex(idx);
+    if (block->origin().norm() < active_radius_m) {
+      continue;
+    }
+
+    auto& voxels = expected.emplace_back(idx, std::vector<TsdfVoxel>()).second;
+    for (size_t i = 0; i < block->num_voxels(); ++i) {
+      voxels.push_back(block->getVoxelByLinearIndex(i));
+    }
+
+    quantizer.quantizeBlock(*block, *quantized.allocateBlockPtrByIndex(idx));
+    tsdf.removeBlock(idx);
+  }
+
+  ASSERT_FALSE(expected.empty());
+  const auto num_stored = quantized.getNumberOfAllocatedBlocks();
+
+  // the same ray reaches past the active radius and reallocates the stored blocks
+  integrator.integratePointCloud(world_T_sensor, cloud, colors);
+  voxblox::BlockIndexList integrated;
+  tsdf.getAllUpdatedBlocks(voxblox::Update::kMesh, &integrated);
+  const auto num_merged = mergeQuantizedBlocks(
+      quantizer, config.max_weight, integrated, quantized, tsdf);
+  EXPECT_EQ(num_stored, num_merged);
+  EXPECT_EQ(0u, quantized.getNumberOfAllocatedBlocks());
+
+  for (const auto& [idx, prev] : expected) {
+    const auto block = tsdf.getBlockPtrByIndex(idx);
+    ASSERT_TRUE(block != nullptr);
+    EXPECT_TRUE(block->has_data());
+    for (size_t i = 0; i < prev.size(); ++i) {
+      const auto& voxel_prev = prev[i];
+      const auto& voxel = block->getVoxelByLinearIndex(i);
+      if (voxel_prev.weight <= 0.0f) {
+        continue;
+      }
+
+      // identical observations average to the same distance with twice the weight
+      EXPECT_NEAR(voxel_prev.distance,
+                  voxel.distance,
+                  quantizer.distance_resolution * 1.001f);
+      EXPECT_NEAR(2.0f * voxel_prev.weight, voxel.weight, voxel_prev.weight / 128.0f);
+    }
+  }
+}
+
+}  // namespace hydra
@@ -0,0 +1,175 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/reconstruction/tsdf_change_tracker.h>
+
+#include <thread>
+
+namespace hydra {
+
+using voxblox::BlockIndex;
+using voxblox::GlobalIndex;
+using voxblox::Layer;
+using voxblox::TsdfVoxel;
+
+TEST(TsdfChangeTracker, MarkChangedCorrect) {
+  TsdfChangeTracker tracker(4);
+  EXPECT_EQ(nullptr, tracker.getChanges(BlockIndex(0, 0, 0)));
+
+  tracker.markChanged(GlobalIndex(1, 2, 3));
+  tracker.markChanged(GlobalIndex(-1, 0, 4));
+
+  const VoxelMask* changes = tracker.getChanges(BlockIndex(0, 0, 0));
+  ASSERT_TRUE(changes != nullptr);
+  EXPECT_EQ(1u, changes->count());
+  EXPECT_TRUE(changes->test(1 + 4 * (2 + 4 * 3)));
+
+  // negative indices map to the far side of the previous block
+  changes = tracker.getChanges(BlockIndex(-1, 0, 1));
+  ASSERT_TRUE(changes != nullptr);
+  EXPECT_EQ(1u, changes->count());
+  EXPECT_TRUE(changes->test(3));
+
+  tracker.clearBlock(BlockIndex(0, 0, 0));
+  EXPECT_EQ(nullptr, tracker.getChanges(BlockIndex(0, 0, 0)));
+  EXPECT_TRUE(tracker.getChanges(BlockIndex(-1, 0, 1)) != nullptr);
+
+  tracker.clear();
+  EXPECT_EQ(nullptr, tracker.getChanges(BlockIndex(-1, 0, 1)));
+}
+
+TEST(TsdfChangeTracker, ConcurrentMarksCorrect) {
+  TsdfChangeTracker tracker(8);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&tracker, t]() {
+      for (int i = t; i < 512; i += 4) {
+        tracker.markChanged(GlobalIndex(i % 8, (i / 8) % 8, i / 64));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const VoxelMask* changes = tracker.getChanges(BlockIndex(0, 0, 0));
+  ASSERT_TRUE(changes != nullptr);
+  EXPECT_EQ(512u, changes->count());
+
+  size_t num_visited = 0;
+  size_t expected = 0;
+  changes->forEach([&](size_t index) {
+    EXPECT_EQ(expected, index);
+    ++expected;
+    ++num_visited;
+  });
+  EXPECT_EQ(512u, num_visited);
+}
+
+TEST(TsdfChangeDetector, MarksChangedVoxels) {
+  Layer<TsdfVoxel> tsdf(0.1, 4);
+  TsdfChangeTracker tracker(4);
+  TsdfChangeDetector detector(0.3);
+
+  auto block = tsdf.allocateBlockPtrByIndex(BlockIndex(0, 0, 0));
+  block->getVoxelByLinearIndex(3).distance = 0.1;
+  block->getVoxelByLinearIndex(3).weight = 1.0;
+  block->getVoxelByLinearIndex(5).distance = -0.1;
+  block->getVoxelByLinearIndex(5).weight = 2.0;
+  block->updated().set();
+
+  // every observed voxel of a new block is a change
+  EXPECT_EQ(2u, detector.update(tsdf, tracker));
+  EXPECT_FALSE(block->updated().test(voxblox::Update::kMap));
+  EXPECT_TRUE(block->updated().test(voxblox::Update::kEsdf));
+  const VoxelMask* changes = tracker.getChanges(BlockIndex(0, 0, 0));
+  ASSERT_TRUE(changes != nullptr);
+  EXPECT_EQ(2u, changes->count());
+  EXPECT_TRUE(changes->test(3));
+  EXPECT_TRUE(changes->test(5));
+
+  // blocks without the update flag aren't compared
+  tracker.clear();
+  block->getVoxelByLinearIndex(3).distance = 0.2;
+  EXPECT_EQ(0u, detector.update(tsdf, tracker));
+  EXPECT_EQ(nullptr, tracker.getChanges(BlockIndex(0, 0, 0)));
+
+  block->getVoxelByLinearIndex(5).weight = 3.0;
+  block->updated().set();
+  EXPECT_EQ(2u, detector.update(tsdf, tracker));
+  changes = tracker.getChanges(BlockIndex(0, 0, 0));
+  ASSERT_TRUE(changes != nullptr);
+  EXPECT_EQ(2u, changes->count());
+
+  // updated blocks that didn't change don't get a mask
+  tracker.clear();
+  block->updated().set();
+  EXPECT_EQ(0u, detector.update(tsdf, tracker));
+  EXPECT_EQ(nullptr, tracker.getChanges(BlockIndex(0, 0, 0)));
+}
+
+TEST(TsdfChangeDetector, ResetBlockKeepsState) {
+  Layer<TsdfVoxel> tsdf(0.1, 4);
+  TsdfChangeTracker tracker(4);
+  TsdfChangeDetector detector(0.3);
+
+  auto block = tsdf.allocateBlockPtrByIndex(BlockIndex(1, 0, 0));
+  block->getVoxelByLinearIndex(0).distance = 0.1;
+  block->getVoxelByLinearIndex(0).weight = 1.0;
+  block->getVoxelByLinearIndex(1).distance = 0.2;
+  block->getVoxelByLinearIndex(1).weight = 1.0;
+
+  // e.g., a restored block: only voxels changed after the reset are marked
+  detector.resetBlock(BlockIndex(1, 0, 0), *block);
+  EXPECT_EQ(1u, detector.numBlocks());
+  block->getVoxelByLinearIndex(1).weight = 2.0;
+  block->updated().set();
+  EXPECT_EQ(1u, detector.update(tsdf, tracker));
+  const VoxelMask* changes = tracker.getChanges(BlockIndex(1, 0, 0));
+  ASSERT_TRUE(changes != nullptr);
+  EXPECT_EQ(1u, changes->count());
+  EXPECT_TRUE(changes->test(1));
+
+  // removed blocks are compared against unobserved voxels again
+  tracker.clear();
+  detector.removeBlock(BlockIndex(1, 0, 0));
+  EXPECT_EQ(0u, detector.numBlocks());
+  block->updated().set();
+  EXPECT_EQ(2u, detector.update(tsdf, tracker));
+}
+
+}  // namespace hydra
@@ -112,6 +112,35 @@ TEST(GraphFiltrationTests, TestSimpleSingleComponentMinSize) {
   EXPECT_EQ(expected, result);
 }
 
+TEST(GraphFiltrationTests, TestFilteredMatchesSubgraph) {
+  IsolatedSceneGraphLayer layer(1);
+  addNode(layer, 0, 1.0);
+  addNode(layer, 1, 2.0);
+  addNode(layer, 2, 3.0);
+  addNode(layer, 3, 4.0);
+  addNode(layer, 10, 5.0);
+  addNode(layer, 11, 6.0);
+  addEdge(layer, 0, 1, 0.2);
+  addEdge(layer, 1, 2, 0.3);
+  addEdge(layer, 2, 3, 0.4);
+  addEdge(layer, 3, 10, 0.5);
+  addEdge(layer, 10, 11, 0.6);
+
+  // filtering out nodes 10 and 11 is equivalent to the single component test
+  BarcodeTracker tracker;
+  const auto result = getGraphFiltration(
+      layer,
+      tracker,
+      1.0e-4,
+      [](const DisjointSet& components) -> size_t { return components.sizes.size(); },
+      true,
+      nullptr,
+      [](NodeId node) { return node < 10; });
+  Filtration expected{
+      {0.2, 1}, {0.3, 2}, {0.4, 3}, {1.0, 4}, {2.0, 3}, {3.0, 2}, {4.0, 1}};
+  EXPECT_EQ(expected, result);
+}
+
 TEST(GraphFiltrationTests, TestDelayedEdgesSingleComponent) {
   IsolatedSceneGraphLayer layer(1);
   addNode(layer, 0, 1.0);
@@ -205,6 +234,51 @@ TEST(GraphFiltrationTests, TestBarcodeFiltration) {
   EXPECT_EQ(expected_barcodes, tracker.barcodes);
 }
 
+TEST(GraphFiltrationTests, TestRollbackComponents) {
+  IsolatedSceneGraphLayer layer(1);
+  addNode(layer, 0, 1.0);
+  addNode(layer, 1, 2.0);
+  addNode(layer, 2, 3.0);
+  addNode(layer, 3, 4.0);
+  addNode(layer, 4, 0.3);
+  addEdge(layer, 0, 1, 0.4);
+  addEdge(layer, 1, 2, 0.5);
+  addEdge(layer, 2, 3, 0.6);
+
+  BarcodeTracker tracker;
+  RollbackDisjointSet components;
+  getGraphFiltration(
+      layer,
+      tracker,
+      1.0e-4,
+      [](const DisjointSet& sets) { return sets.sizes.size(); },
+      false,
+      &components);
+  EXPECT_EQ(3u, components.events.size());
+  EXPECT_EQ(2u, components.sizes.size());
+
+  using Components = std::vector<std::vector<NodeId>>;
+  components.setThreshold(0.45);
+  EXPECT_EQ(3u, components.sizes.size());
+  EXPECT_EQ(Components({{0}, {1, 2, 3}, {4}}), components.getComponents());
+  EXPECT_EQ(Components({{1, 2, 3}}), components.getComponents(2));
+
+  components.setThreshold(0.55);
+  EXPECT_EQ(Components({{0}, {1}, {2, 3}, {4}}), components.getComponents());
+
+  // redo unions after rolling back
+  components.setThreshold(0.35);
+  EXPECT_EQ(Components({{0, 1, 2, 3}, {4}}), components.getComponents());
+  EXPECT_EQ(3u, components.num_applied);
+
+  // node filters remove isolated nodes below the threshold
+  const auto filter = [&](NodeId node) {
+    return layer.getNode(node)->get().attributes<PlaceNodeAttributes>().distance >
+           0.35;
+  };
+  EXPECT_EQ(Components({{0, 1, 2, 3}}), components.getComponents(0, filter));
+}
+
 TEST(GraphFiltrationTests, TestLongestSequence) {
   {  // empty values -> no best index
     Filtration values;
@@ -0,0 +1,129 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/rooms/room_finder_logger.h>
+
+namespace hydra {
+
+namespace {
+
+void addNode(IsolatedSceneGraphLayer& layer, NodeId node_id, double distance) {
+  auto attrs = std::make_unique<PlaceNodeAttributes>();
+  attrs->position = Eigen::Vector3d(node_id, 0.0, 0.0);
+  attrs->distance = distance;
+  layer.emplaceNode(node_id, std::move(attrs));
+}
+
+void addEdge(IsolatedSceneGraphLayer& layer,
+             NodeId source,
+             NodeId target,
+             double weight) {
+  auto attrs = std::make_unique<EdgeAttributes>();
+  attrs->weight = weight;
+  layer.insertEdge(source, target, std::move(attrs));
+}
+
+}  // namespace
+
+TEST(RoomFinderLoggerTests, TestSnapshotFromLayer) {
+  IsolatedSceneGraphLayer places(DsgLayers::PLACES);
+  addNode(places, 2, 0.5);
+  addNode(places, 0, 1.0);
+  addNode(places, 1, 2.0);
+  addEdge(places, 2, 1, 0.25);
+  addEdge(places, 0, 1, 0.75);
+
+  const auto snapshot = PlacesSnapshot::fromLayer(places);
+  std::vector<PlacesSnapshot::Node> expected_nodes{{0, 0.0f, 0.0f, 0.0f, 1.0f},
+                                                   {1, 1.0f, 0.0f, 0.0f, 2.0f},
+                                                   {2, 2.0f, 0.0f, 0.0f, 0.5f}};
+  EXPECT_EQ(expected_nodes, snapshot.nodes);
+
+  std::vector<PlacesSnapshot::Edge> expected_edges{{0, 1, 0.75f}, {1, 2, 0.25f}};
+  EXPECT_EQ(expected_edges, snapshot.edges);
+
+  // copies made for the log are sorted later by the writer
+  auto copy = PlacesSnapshot::copyLayer(places);
+  EXPECT_EQ(3u, copy.nodes.size());
+  EXPECT_EQ(2u, copy.edges.size());
+  copy.sort();
+  EXPECT_EQ(expected_nodes, copy.nodes);
+  EXPECT_EQ(expected_edges, copy.edges);
+}
+
+TEST(RoomFinderLoggerTests, TestDeltaRoundTrip) {
+  IsolatedSceneGraphLayer places(DsgLayers::PLACES);
+  addNode(places, 0, 1.0);
+  addNode(places, 1, 2.0);
+  addNode(places, 2, 0.5);
+  addEdge(places, 0, 1, 0.75);
+  addEdge(places, 1, 2, 0.25);
+  const auto prev = PlacesSnapshot::fromLayer(places);
+
+  // drop node 0, change the distance of node 1 and add node 3
+  places.removeNode(0);
+  places.removeNode(1);
+  addNode(places, 1, 3.0);
+  addNode(places, 3, 1.5);
+  addEdge(places, 1, 2, 0.25);
+  addEdge(places, 2, 3, 0.5);
+  const auto curr = PlacesSnapshot::fromLayer(places);
+
+  const auto delta = PlacesDelta::between(prev, curr);
+  EXPECT_EQ(std::vector<NodeId>{0}, delta.removed_nodes);
+  ASSERT_EQ(2u, delta.nodes.size());
+  EXPECT_EQ(1u, delta.nodes[0].id);
+  EXPECT_EQ(3u, delta.nodes[1].id);
+  ASSERT_EQ(1u, delta.removed_edges.size());
+  EXPECT_EQ(0u, delta.removed_edges[0].first);
+  EXPECT_EQ(1u, delta.removed_edges[0].second);
+  ASSERT_EQ(1u, delta.edges.size());
+  EXPECT_EQ(2u, delta.edges[0].source);
+  EXPECT_EQ(3u, delta.edges[0].target);
+
+  auto result = prev;
+  delta.apply(result);
+  EXPECT_EQ(curr.nodes, result.nodes);
+  EXPECT_EQ(curr.edges, result.edges);
+
+  // identical snapshots produce empty deltas
+  const auto empty = PlacesDelta::between(curr, curr);
+  EXPECT_TRUE(empty.removed_nodes.empty());
+  EXPECT_TRUE(empty.nodes.empty());
+  EXPECT_TRUE(empty.removed_edges.empty());
+  EXPECT_TRUE(empty.edges.empty());
+}
+
+}  // namespace hydra
@@ -105,4 +105,70 @@ TEST(RoomHelpersTests, TestAddRoomEdges) {
   EXPECT_FALSE(rooms.hasEdge(1, 2));
 }
 
+TEST(RoomHelpersTests, TestFindFloorBoundaries) {
+  EXPECT_TRUE(findFloorBoundaries({}, 0.2, 2.0, 0.2).empty());
+
+  // three floors with a stairwell running through all of them
+  std::vector<double> heights;
+  for (size_t floor = 0; floor < 3; ++floor) {
+    for (size_t i = 0; i < 40; ++i) {
+      heights.push_back(3.0 * floor + 0.3 + 0.15 * (i % 13));
+    }
+  }
+
+  for (double z = 0.3; z < 6.5; z += 0.4) {
+    heights.push_back(z);
+  }
+
+  const auto boundaries = findFloorBoundaries(heights, 0.2, 2.0, 0.25);
+  ASSERT_EQ(2u, boundaries.size());
+  EXPECT_GT(boundaries[0], 2.1);
+  EXPECT_LT(boundaries[0], 3.3);
+  EXPECT_GT(boundaries[1], 5.1);
+  EXPECT_LT(boundaries[1], 6.3);
+
+  // tall rooms don't get split
+  std::vector<double> tall;
+  for (size_t i = 0; i < 100; ++i) {
+    tall.push_back(0.2 + 0.05 * i);
+  }
+
+  EXPECT_TRUE(findFloorBoundaries(tall, 0.2, 2.0, 0.25).empty());
+}
+
+TEST(RoomHelpersTests, TestPartitionPlacesByFloor) {
+  IsolatedSceneGraphLayer places(DsgLayers::PLACES);
+  // two floors connected by a staircase (nodes 6 and 7)
+  addNode(places, 0, Eigen::Vector3d(0.0, 0.0, 1.0), 1.0);
+  addNode(places, 1, Eigen::Vector3d(1.0, 0.0, 1.1), 1.0);
+  addNode(places, 2, Eigen::Vector3d(2.0, 0.0, 1.0), 1.0);
+  addNode(places, 3, Eigen::Vector3d(0.0, 0.0, 4.0), 1.0);
+  addNode(places, 4, Eigen::Vector3d(1.0, 0.0, 4.0), 1.0);
+  addNode(places, 5, Eigen::Vector3d(2.0, 0.0, 4.1), 1.0);
+  addNode(places, 6, Eigen::Vector3d(2.5, 0.0, 2.0), 0.5);
+  addNode(places, 7, Eigen::Vector3d(3.0, 0.0, 3.0), 0.5);
+  places.insertEdge(0, 1);
+  places.insertEdge(1, 2);
+  places.insertEdge(3, 4);
+  places.insertEdge(4, 5);
+  places.insertEdge(2, 6);
+  places.insertEdge(6, 7);
+  places.insertEdge(7, 5);
+
+  {  // stairs are assigned to the closest floor instead of being dropped
+    std::vector<std::vector<NodeId>> expected{{0, 1, 2, 6}, {3, 4, 5, 7}};
+    EXPECT_EQ(expected, partitionPlacesByFloor(places, 0.2, 2.0, 0.2));
+  }
+
+  {  // small partitions get dropped
+    std::vector<std::vector<NodeId>> expected;
+    EXPECT_EQ(expected, partitionPlacesByFloor(places, 0.2, 2.0, 0.2, 5));
+  }
+
+  {  // floors closer than the minimum separation are merged
+    std::vector<std::vector<NodeId>> expected{{0, 1, 2, 3, 4, 5, 6, 7}};
+    EXPECT_EQ(expected, partitionPlacesByFloor(places, 0.2, 5.0, 0.2));
+  }
+}
+
 }  // namespace hydra
@@ -0,0 +1,125 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/utils/compact_graph.h>
+#include <hydra/utils/disjoint_set.h>
+
+namespace hydra {
+
+void addCompactTestNode(IsolatedSceneGraphLayer& layer, NodeId node, double x) {
+  layer.emplaceNode(node, std::make_unique<NodeAttributes>(Eigen::Vector3d(x, 0, 0)));
+}
+
+TEST(CompactGraphTests, TestDenseDisjointSet) {
+  DenseDisjointSet set(5);
+  EXPECT_EQ(5u, set.numSets());
+
+  EXPECT_TRUE(set.doUnion(0, 1));
+  EXPECT_TRUE(set.doUnion(2, 3));
+  EXPECT_TRUE(set.doUnion(1, 3));
+  EXPECT_FALSE(set.doUnion(0, 2));
+  EXPECT_EQ(2u, set.numSets());
+
+  EXPECT_EQ(set.findSet(0), set.findSet(3));
+  EXPECT_NE(set.findSet(0), set.findSet(4));
+  EXPECT_EQ(4u, set.setSize(2));
+  EXPECT_EQ(1u, set.setSize(4));
+
+  // union by size keeps the larger set as the root
+  const auto root = set.findSet(0);
+  const auto erased = set.doUnion(4, 0);
+  ASSERT_TRUE(erased);
+  EXPECT_EQ(4u, *erased);
+  EXPECT_EQ(root, set.findSet(4));
+}
+
+TEST(CompactGraphTests, TestLayerConstruction) {
+  IsolatedSceneGraphLayer layer(1);
+  addCompactTestNode(layer, 7, 3.0);
+  addCompactTestNode(layer, 2, 1.0);
+  addCompactTestNode(layer, 5, 2.0);
+  layer.insertEdge(2, 5);
+  layer.insertEdge(5, 7);
+
+  const CompactGraph graph(layer);
+  ASSERT_EQ(3u, graph.numNodes());
+  EXPECT_EQ(2u, graph.numEdges());
+
+  const std::vector<NodeId> expected_ids{2, 5, 7};
+  EXPECT_EQ(expected_ids, graph.node_ids);
+  EXPECT_EQ(1u, graph.getIndex(5).value());
+  EXPECT_FALSE(graph.getIndex(3));
+  EXPECT_NEAR(3.0, graph.positions(0, 2), 1.0e-9);
+
+  const std::vector<size_t> expected_offsets{0, 1, 3, 4};
+  EXPECT_EQ(expected_offsets, graph.offsets);
+  EXPECT_EQ(1u, graph.neighbors[0]);
+  EXPECT_EQ(1u, graph.neighbors[3]);
+
+  const auto values = graph.getNodeValues(
+      layer, [](const SceneGraphNode& node) { return node.attributes().position.x(); });
+  const std::vector<double> expected_values{1.0, 2.0, 3.0};
+  EXPECT_EQ(expected_values, values);
+}
+
+TEST(CompactGraphTests, TestSubsetConnectedComponents) {
+  IsolatedSceneGraphLayer layer(1);
+  for (size_t i = 0; i < 6; ++i) {
+    addCompactTestNode(layer, i, static_cast<double>(i));
+  }
+
+  layer.insertEdge(0, 1);
+  layer.insertEdge(1, 2);
+  layer.insertEdge(2, 3);
+  layer.insertEdge(4, 5);
+
+  // dropping node 2 splits the chain
+  const CompactGraph graph(layer, {0, 1, 3, 4, 5, 10});
+  EXPECT_EQ(5u, graph.numNodes());
+  EXPECT_EQ(2u, graph.numEdges());
+  const std::vector<size_t> expected_offsets{0, 1, 2, 2, 3, 4};
+  EXPECT_EQ(expected_offsets, graph.offsets);
+
+  const auto components = getConnectedComponents(graph);
+  ASSERT_EQ(3u, components.size());
+  const std::vector<NodeId> first{0, 1};
+  const std::vector<NodeId> second{3};
+  const std::vector<NodeId> third{4, 5};
+  EXPECT_EQ(first, graph.getNodeIds(components[0]));
+  EXPECT_EQ(second, graph.getNodeIds(components[1]));
+  EXPECT_EQ(third, graph.getNodeIds(components[2]));
+}
+
+}  // namespace hydra
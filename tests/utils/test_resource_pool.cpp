@@ -0,0 +1,93 @@
+/* -----------------------------------------------------------------------------
+ * Copyright 2022 Massachusetts Institute of Technology.
+ * All Rights Reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Research was sponsored by the United States Air Force Research Laboratory and
+ * the United States Air Force Artificial Intelligence Accelerator and was
+ * accomplished under Cooperative Agreement Number FA8750-19-2-1000. The views
+ * and conclusions contained in this document are those of the authors and should
+ * not be interpreted as representing the official policies, either expressed or
+ * implied, of the United States Air Force or the U.S. Government. The U.S.
+ * Government is authorized to reproduce and distribute reprints for Government
+ * purposes notwithstanding any copyright notation herein.
+ * -------------------------------------------------------------------------- */
+#include <gtest/gtest.h>
+#include <hydra/utils/resource_pool.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace hydra {
+
+TEST(ResourcePool, ReusesReturnedResources) {
+  ResourcePool<std::vector<int>> pool;
+  int* data = nullptr;
+  {
+    auto buffer = pool.acquire();
+    buffer->resize(10);
+    data = buffer->data();
+  }
+
+  // the same (already grown) object comes back once it was returned
+  auto buffer = pool.acquire();
+  EXPECT_EQ(10u, buffer->size());
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_EQ(1u, pool.size());
+}
+
+TEST(ResourcePool, ConcurrentCallersGetDistinctResources) {
+  std::atomic<size_t> num_made(0);
+  ResourcePool<int> pool([&] { return std::make_unique<int>(num_made++); });
+
+  auto first = pool.acquire();
+  auto second = pool.acquire();
+  EXPECT_NE(&*first, &*second);
+  EXPECT_EQ(2u, pool.size());
+
+  std::vector<std::thread> threads;
+  std::atomic<size_t> num_shared(0);
+  for (size_t i = 0; i < 8; ++i) {
+    threads.emplace_back([&] {
+      for (size_t j = 0; j < 100; ++j) {
+        auto value = pool.acquire();
+        // nobody else should be writing to the same object
+        const int id = *value;
+        *value = -1;
+        std::this_thread::yield();
+        num_shared += *value != -1;
+        *value = id;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0u, num_shared.load());
+  EXPECT_LE(pool.size(), 10u);
+}
+
+}  // namespace hydra
@@ -138,5 +138,42 @@ TEST_F(TimingUtilityTests, TestScopedTimers) {
   EXPECT_GT(*elapsed_2, *elapsed_4);
 }
 
+TEST_F(TimingUtilityTests, TestTimedLock) {
+  using namespace std::chrono_literals;
+
+  std::mutex mutex;
+  std::thread holder;
+  {  // start holder critical section
+    TimedLock lock(mutex, "holder", 0);
+    holder = std::thread([&mutex]() { TimedLock lock(mutex, "waiter", 0); });
+    std::this_thread::sleep_for(20ms);
+  }  // end holder critical section
+  holder.join();
+
+  const auto holder_wait = ElapsedTimeRecorder::instance().getStats("holder_wait");
+  const auto holder_hold = ElapsedTimeRecorder::instance().getStats("holder_hold");
+  const auto waiter_wait = ElapsedTimeRecorder::instance().getStats("waiter_wait");
+  const auto waiter_hold = ElapsedTimeRecorder::instance().getStats("waiter_hold");
+  EXPECT_EQ(1u, holder_wait.num_measurements);
+  EXPECT_EQ(1u, holder_hold.num_measurements);
+  EXPECT_EQ(1u, waiter_wait.num_measurements);
+  EXPECT_EQ(1u, waiter_hold.num_measurements);
+  EXPECT_GE(holder_hold.last_s, 0.02);
+  EXPECT_GT(waiter_wait.last_s, holder_wait.last_s);
+  EXPECT_LT(waiter_hold.last_s, holder_hold.last_s);
+}
+
+TEST_F(TimingUtilityTests, TestTimedLockEarlyUnlock) {
+  std::mutex mutex;
+  TimedLock lock(mutex, "test", 0);
+  lock.unlock();
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+  lock.unlock();
+
+  const auto stats = ElapsedTimeRecorder::instance().getStats("test_hold");
+  EXPECT_EQ(1u, stats.num_measurements);
+}
+
 }  // namespace timing
 }  // namespace hydra